@@ -0,0 +1,225 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audio/decodedcache.h"
+#include "audio/audiostream.h"
+
+#include "common/array.h"
+
+namespace Common {
+DECLARE_SINGLETON(Audio::DecodedAudioCache);
+}
+
+namespace Audio {
+
+/**
+ * Plays the samples of a cache entry. Each stream holds a reference to its
+ * entry, which keeps the samples alive after the entry has been evicted.
+ */
+class DecodedAudioStream : public SeekableAudioStream {
+public:
+	DecodedAudioStream(DecodedAudioCache::Entry *entry) : _entry(entry), _pos(0) {}
+	~DecodedAudioStream() override { DecodedAudioCacheMan.release(_entry); }
+
+	int readBuffer(int16 *buffer, const int numSamples) override {
+		const int samples = MIN<uint32>(numSamples, _entry->numSamples - _pos);
+		memcpy(buffer, _entry->samples + _pos, samples * sizeof(int16));
+		_pos += samples;
+		return samples;
+	}
+
+	bool isStereo() const override { return _entry->stereo; }
+	int getRate() const override { return _entry->rate; }
+	bool endOfData() const override { return _pos >= _entry->numSamples; }
+
+	bool seek(const Timestamp &where) override {
+		const uint32 channels = _entry->stereo ? 2 : 1;
+		_pos = where.convertToFramerate(_entry->rate).totalNumberOfFrames() * channels;
+		if (_pos > _entry->numSamples) {
+			_pos = _entry->numSamples;
+			return false;
+		}
+		return true;
+	}
+
+	Timestamp getLength() const override {
+		return Timestamp(0, _entry->numSamples / (_entry->stereo ? 2 : 1), _entry->rate);
+	}
+
+private:
+	DecodedAudioCache::Entry *_entry;
+	uint32 _pos;
+};
+
+DecodedAudioCache::DecodedAudioCache() : _size(0), _maxSize(kDefaultMaxSize), _maxEntrySize(kDefaultMaxEntrySize) {
+}
+
+DecodedAudioCache::~DecodedAudioCache() {
+	purge(0);
+}
+
+SeekableAudioStream *DecodedAudioCache::find(const Key &key) {
+	Common::StackLock lock(_mutex);
+
+	EntryMap::iterator i = _map.find(key);
+	if (i == _map.end())
+		return nullptr;
+
+	// Move the entry to the front of the LRU list
+	Entry *entry = *i->_value;
+	_lru.erase(i->_value);
+	_lru.push_front(entry);
+	i->_value = _lru.begin();
+
+	return createStream(entry);
+}
+
+SeekableAudioStream *DecodedAudioCache::insert(const Key &key, SeekableAudioStream *stream) {
+	if (!stream)
+		return nullptr;
+
+	const uint32 maxSamples = MIN(_maxEntrySize, _maxSize) / sizeof(int16);
+
+	{
+		Common::StackLock lock(_mutex);
+		if (_oversized.contains(key))
+			return stream;
+	}
+
+	// Most decoders know the length of the clip up front, which spares
+	// decoding clips that are too large only to throw the result away
+	const uint32 channels = stream->isStereo() ? 2 : 1;
+	const uint64 length = (uint64)stream->getLength().totalNumberOfFrames() * channels;
+	if (length > maxSamples) {
+		Common::StackLock lock(_mutex);
+		_oversized[key] = true;
+		return stream;
+	}
+
+	// Decode the whole clip without holding the lock, so the mixer is not
+	// blocked by streams of other cached clips being deleted meanwhile
+	Common::Array<int16> samples;
+	if (length)
+		samples.resize(length);
+	uint32 numSamples = 0;
+	while (!stream->endOfData()) {
+		if (numSamples >= maxSamples) {
+			// The decoder did not know the length, remember it for next time
+			Common::StackLock lock(_mutex);
+			_oversized[key] = true;
+			stream->rewind();
+			return stream;
+		}
+
+		if (numSamples == samples.size())
+			samples.resize(MIN<uint32>(MAX<uint32>(numSamples * 2, 4096), maxSamples));
+		const int read = stream->readBuffer(&samples[numSamples], samples.size() - numSamples);
+		if (read <= 0) {
+			// The clip is damaged or could not be read completely. Play
+			// what there is, but do not keep the truncated result.
+			stream->rewind();
+			return stream;
+		}
+		numSamples += read;
+	}
+
+	Entry *entry = new Entry();
+	entry->key = key;
+	entry->samples = (int16 *)malloc(MAX<uint32>(numSamples, 1) * sizeof(int16));
+	entry->numSamples = numSamples;
+	entry->rate = stream->getRate();
+	entry->stereo = stream->isStereo();
+	entry->refCount = 0;
+	entry->cached = true;
+	if (numSamples)
+		memcpy(entry->samples, &samples[0], numSamples * sizeof(int16));
+	delete stream;
+
+	Common::StackLock lock(_mutex);
+
+	// Another caller may have added the same clip meanwhile
+	EntryMap::iterator i = _map.find(key);
+	if (i != _map.end())
+		evict(i->_value);
+
+	_lru.push_front(entry);
+	_map[key] = _lru.begin();
+	_size += numSamples * sizeof(int16);
+
+	SeekableAudioStream *result = createStream(entry);
+	while (_size > _maxSize && _lru.size() > 1)
+		evict(--_lru.end());
+	return result;
+}
+
+void DecodedAudioCache::setMaxSize(uint32 bytes) {
+	{
+		Common::StackLock lock(_mutex);
+		_maxSize = bytes;
+		_oversized.clear();
+	}
+	purge(bytes);
+}
+
+void DecodedAudioCache::setMaxEntrySize(uint32 bytes) {
+	Common::StackLock lock(_mutex);
+	_maxEntrySize = bytes;
+	_oversized.clear();
+}
+
+void DecodedAudioCache::purge(uint32 targetBytes) {
+	Common::StackLock lock(_mutex);
+
+	if (targetBytes == 0)
+		_oversized.clear();
+
+	while (_size > targetBytes && !_lru.empty())
+		evict(--_lru.end());
+}
+
+SeekableAudioStream *DecodedAudioCache::createStream(Entry *entry) {
+	++entry->refCount;
+	return new DecodedAudioStream(entry);
+}
+
+void DecodedAudioCache::release(Entry *entry) {
+	Common::StackLock lock(_mutex);
+
+	if (--entry->refCount == 0 && !entry->cached) {
+		free(entry->samples);
+		delete entry;
+	}
+}
+
+void DecodedAudioCache::evict(EntryList::iterator it) {
+	Entry *entry = *it;
+	_map.erase(entry->key);
+	_lru.erase(it);
+	_size -= entry->numSamples * sizeof(int16);
+	entry->cached = false;
+
+	if (entry->refCount == 0) {
+		free(entry->samples);
+		delete entry;
+	}
+}
+
+} // End of namespace Audio
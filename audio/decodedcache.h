@@ -0,0 +1,176 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_DECODEDCACHE_H
+#define AUDIO_DECODEDCACHE_H
+
+#include "common/hashmap.h"
+#include "common/list.h"
+#include "common/mutex.h"
+#include "common/path.h"
+#include "common/singleton.h"
+
+namespace Audio {
+
+/**
+ * @defgroup audio_decodedcache Decoded audio cache
+ * @ingroup audio
+ *
+ * @brief Cache of fully decoded compressed sound clips.
+ * @{
+ */
+
+class SeekableAudioStream;
+
+/**
+ * A size bounded cache of decoded PCM data for short compressed clips,
+ * like speech lines and sound effects which a game plays over and over.
+ *
+ * Clips are identified by the file they are stored in, their position
+ * within it and the codec used. Streams handed out by the cache share
+ * the decoded samples and stay valid even when their entry gets evicted,
+ * so they may be played by the mixer while the cache is being changed.
+ *
+ * The least recently used entries are dropped when the cache grows past
+ * its maximum size. Backends and engines running low on memory can call
+ * purge() to shrink it further.
+ */
+class DecodedAudioCache : public Common::Singleton<DecodedAudioCache> {
+public:
+	struct Key {
+		Common::Path archive; ///< File the clip is stored in
+		uint32 offset;        ///< Offset of the compressed clip in the file
+		uint32 size;          ///< Size of the compressed clip
+		uint32 codec;         ///< Tag of the codec used to decode the clip
+
+		Key() : offset(0), size(0), codec(0) {}
+		Key(const Common::Path &a, uint32 o, uint32 s, uint32 c) : archive(a), offset(o), size(s), codec(c) {}
+
+		bool operator==(const Key &x) const {
+			return offset == x.offset && size == x.size && codec == x.codec && archive == x.archive;
+		}
+	};
+
+	struct Key_Hash {
+		uint operator()(const Key &x) const {
+			return x.archive.hash() ^ (x.offset * 2654435761U) ^ (x.size << 7) ^ x.codec;
+		}
+	};
+
+	enum {
+		/** Default maximum size of all decoded clips, in bytes. */
+		kDefaultMaxSize = 4 * 1024 * 1024,
+		/** Default maximum size of a single decoded clip, in bytes. */
+		kDefaultMaxEntrySize = 1024 * 1024
+	};
+
+	/**
+	 * Look up a clip.
+	 *
+	 * @return A new stream playing the cached clip from its start, or
+	 *         nullptr if the clip is not cached.
+	 */
+	SeekableAudioStream *find(const Key &key);
+
+	/**
+	 * Decode a clip and add it to the cache.
+	 *
+	 * The stream is decoded completely. If the result fits into the cache,
+	 * the stream is deleted and a stream playing the cached samples is
+	 * returned. Otherwise the rewound stream itself is returned, so the
+	 * caller can always play the result.
+	 *
+	 * Clips whose length exceeds the maximum entry size are not decoded
+	 * at all, and are remembered so that they are passed through right away
+	 * the next time. Neither is a clip cached if the stream stopped
+	 * delivering samples before its end.
+	 *
+	 * @param key     Key of the clip.
+	 * @param stream  Stream decoding the clip. The cache takes ownership.
+	 *
+	 * @return Stream playing the clip, or nullptr if @p stream was nullptr.
+	 */
+	SeekableAudioStream *insert(const Key &key, SeekableAudioStream *stream);
+
+	/**
+	 * Set the maximum size of the decoded clips in the cache, in bytes.
+	 * Entries are evicted right away if the cache is larger than that.
+	 */
+	void setMaxSize(uint32 bytes);
+	uint32 getMaxSize() const { return _maxSize; }
+
+	/** Set the maximum size of a single decoded clip, in bytes. */
+	void setMaxEntrySize(uint32 bytes);
+
+	/** Return the size of all decoded clips in the cache, in bytes. */
+	uint32 getSize() const { return _size; }
+
+	/**
+	 * Evict least recently used entries until the cache is no larger than
+	 * @p targetBytes. Clips still being played are freed once their last
+	 * stream is deleted.
+	 */
+	void purge(uint32 targetBytes = 0);
+
+	/** Remove all entries from the cache. */
+	void clear() { purge(0); }
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+	friend class DecodedAudioStream;
+
+	DecodedAudioCache();
+	~DecodedAudioCache();
+
+	struct Entry {
+		Key key;
+		int16 *samples;
+		uint32 numSamples;
+		int rate;
+		bool stereo;
+		uint refCount;
+		bool cached;
+	};
+
+	typedef Common::List<Entry *> EntryList;
+	typedef Common::HashMap<Key, EntryList::iterator, Key_Hash> EntryMap;
+	typedef Common::HashMap<Key, bool, Key_Hash> KeySet;
+
+	SeekableAudioStream *createStream(Entry *entry);
+	void release(Entry *entry);
+	void evict(EntryList::iterator it);
+
+	Common::Mutex _mutex;
+	EntryList _lru;
+	EntryMap _map;
+	KeySet _oversized; ///< Clips which are too large to be cached
+	uint32 _size;
+	uint32 _maxSize;
+	uint32 _maxEntrySize;
+};
+
+/** Shortcut for accessing the decoded audio cache. */
+#define DecodedAudioCacheMan (::Audio::DecodedAudioCache::instance())
+
+/** @} */
+} // End of namespace Audio
+
+#endif
@@ -26,6 +26,7 @@
 
 #include "audio/mixer_intern.h"
 #include "audio/rate.h"
+#include "audio/rate_intern.h"
 #include "audio/audiostream.h"
 #include "audio/timestamp.h"
 
@@ -42,20 +43,22 @@ namespace Audio {
  */
 class Channel {
 public:
-	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
+	Channel(MixerImpl *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
 	~Channel();
 
 	/**
 	 * Mixes the channel's samples into the given buffer.
 	 *
-	 * @param data buffer where to mix the data
-	 * @param len  number of sample *pairs*. So a value of 10
-	 *             in stereo and 16-bit samples means that the
-	 *             buffer contains twice 10 sample, each 16 bits,
-	 *             for a total of 40 bytes.
+	 * @param data           buffer where to mix the data
+	 * @param len            number of sample *pairs*. So a value of 10
+	 *                       in stereo and 16-bit samples means that the
+	 *                       buffer contains twice 10 sample, each 16 bits,
+	 *                       for a total of 40 bytes.
+	 * @param bytesPerSample size of the samples in the buffer
+	 * @param clamp          whether to clamp the samples after mixing
 	 * @return number of sample pairs processed (which can still be silence!)
 	 */
-	int mix(byte *data, uint len);
+	int mix(byte *data, uint len, uint bytesPerSample, bool clamp);
 
 	/**
 	 * Queries whether the channel is still playing or not.
@@ -179,6 +182,21 @@ public:
 	 */
 	Timestamp getElapsedTime() const;
 
+	/**
+	 * Computes the playing time from a set of channel timing values.
+	 */
+	static Timestamp computeElapsedTime(uint32 rate, uint32 samplesConsumed, uint32 mixerTimeStamp,
+	                                    uint32 pauseStartTime, uint32 pauseTime, bool paused);
+
+	/**
+	 * Accessors for the raw timing values, used to publish them to other
+	 * threads in command queue mode.
+	 */
+	uint32 getSamplesConsumed() const { return _samplesConsumed; }
+	uint32 getMixerTimeStamp() const { return _mixerTimeStamp; }
+	uint32 getPauseStartTime() const { return _pauseStartTime; }
+	uint32 getPauseTime() const { return _pauseTime; }
+
 	/**
 	 * Replaces the channel's stream with a version that loops indefinitely.
 	 */
@@ -216,7 +234,7 @@ private:
 	void updateChannelVolumes();
 	st_volume_t _volL, _volR;
 
-	Mixer *_mixer;
+	MixerImpl *_mixer;
 
 	uint32 _samplesConsumed;
 	uint32 _samplesDecoded;
@@ -234,17 +252,144 @@ private:
 
 MixerImpl::MixerImpl(uint sampleRate, bool stereo, uint outBufSize, uint outBytesPerSample, bool clamp)
 	: _mutex(), _sampleRate(sampleRate), _stereo(stereo), _outBufSize(outBufSize), _outBytesPerSample(outBytesPerSample), _clamp(clamp)
-	, _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	, _mixerReady(false), _handleSeed(0), _soundTypeSettings()
+	, _mixBus(false), _busBuffer(nullptr), _busSize(0), _limiter(false)
+	, _limiterThreshold(kDefaultLimiterThreshold), _limiterRelease(kDefaultLimiterRelease), _limiterGain(LIMITER_UNITY)
+#ifndef NO_CXX11_ATOMIC
+	, _queued(false), _queueMutex(), _mixSoundTypeSettings(), _commandRead(0), _commandWrite(0)
+	, _commandsPosted(0), _commandsDone(0), _callbackActive(false), _mutexShared(false)
+#endif
+	{
 
 	assert(sampleRate > 0);
 
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		_channels[i] = nullptr;
+
+	// Pick the rate converter kernels now, before the backend starts the
+	// thread which creates the channels and their converters
+	RateConverterSIMD::init();
+
+#ifndef NO_CXX11_ATOMIC
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		_slotState[i].handle.store(FREE_SLOT, std::memory_order_relaxed);
+		_slotState[i].sequence.store(0, std::memory_order_relaxed);
+		_slotState[i].timingHandle.store(FREE_SLOT, std::memory_order_relaxed);
+		_slotState[i].samplesConsumed.store(0, std::memory_order_relaxed);
+		_slotState[i].mixerTimeStamp.store(0, std::memory_order_relaxed);
+		_slotState[i].pauseStartTime.store(0, std::memory_order_relaxed);
+		_slotState[i].pauseTime.store(0, std::memory_order_relaxed);
+		_slotState[i].paused.store(false, std::memory_order_relaxed);
+	}
+#endif
 }
 
 MixerImpl::~MixerImpl() {
+#ifndef NO_CXX11_ATOMIC
+	// Streams which were started but never reached the mixing thread
+	uint32 read = _commandRead.load(std::memory_order_acquire);
+	const uint32 write = _commandWrite.load(std::memory_order_acquire);
+	for (; read != write; read = (read + 1) % COMMAND_QUEUE_SIZE) {
+		if (_commands[read].type == kCmdPlay)
+			delete _commands[read].channel;
+	}
+#endif
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		delete _channels[i];
+
+	delete[] _busBuffer;
+}
+
+Common::Mutex &MixerImpl::mutex() {
+#ifndef NO_CXX11_ATOMIC
+	_mutexShared.store(true, std::memory_order_release);
+#endif
+	return _mutex;
+}
+
+void MixerImpl::enableMixBus(bool enable) {
+	Common::StackLock lock(_mutex);
+
+#ifndef NO_CXX11_ATOMIC
+	// The mixing thread reads the settings without locking
+	if (_queued && _mixerReady) {
+		warning("MixerImpl::enableMixBus: Cannot change the mix bus while the mixer is running");
+		return;
+	}
+#endif
+
+	_mixBus = enable;
+}
+
+bool MixerImpl::isMixBusEnabled() const {
+	Common::StackLock lock(_mutex);
+
+	return _mixBus;
+}
+
+bool MixerImpl::isLimiterEnabled() const {
+	Common::StackLock lock(_mutex);
+
+	return _limiter;
+}
+
+void MixerImpl::setLimiter(bool enable, int threshold, uint releaseMs) {
+	Common::StackLock lock(_mutex);
+
+#ifndef NO_CXX11_ATOMIC
+	if (_queued && _mixerReady) {
+		warning("MixerImpl::setLimiter: Cannot change the limiter while the mixer is running");
+		return;
+	}
+#endif
+
+	_limiter = enable;
+	_limiterThreshold = CLIP(threshold, 1, 32767);
+	_limiterRelease = releaseMs;
+	_limiterGain = LIMITER_UNITY;
+}
+
+bool MixerImpl::enableCommandQueue(bool enable) {
+#ifndef NO_CXX11_ATOMIC
+	Common::StackLock lock(_mutex);
+
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		if (_channels[i]) {
+			warning("MixerImpl::enableCommandQueue: Cannot switch modes while sounds are playing");
+			return _queued;
+		}
+	}
+
+	if (enable) {
+		for (int i = 0; i != ARRAYSIZE(_soundTypeSettings); i++)
+			_mixSoundTypeSettings[i] = _soundTypeSettings[i];
+	}
+
+	_queued = enable;
+	return _queued;
+#else
+	return false;
+#endif
+}
+
+bool MixerImpl::isCommandQueueEnabled() const {
+#ifndef NO_CXX11_ATOMIC
+	return _queued;
+#else
+	return false;
+#endif
+}
+
+const MixerImpl::SoundTypeSettings &MixerImpl::getChannelTypeSettings(SoundType type) const {
+	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
+
+#ifndef NO_CXX11_ATOMIC
+	if (_queued)
+		return _mixSoundTypeSettings[type];
+#endif
+
+	return _soundTypeSettings[type];
 }
 
 void MixerImpl::setReady(bool ready) {
@@ -306,6 +451,13 @@ void MixerImpl::playStream(
 			DisposeAfterUse::Flag autofreeStream,
 			bool permanent,
 			bool reverseStereo) {
+#ifndef NO_CXX11_ATOMIC
+	if (_queued) {
+		playQueuedStream(type, handle, stream, id, volume, balance, autofreeStream, permanent, reverseStereo);
+		return;
+	}
+#endif
+
 	Common::StackLock lock(_mutex);
 
 	if (stream == nullptr) {
@@ -346,33 +498,66 @@ void MixerImpl::playStream(
 int MixerImpl::mixCallback(byte *samples, uint len) {
 	assert(samples);
 
+#ifndef NO_CXX11_ATOMIC
+	if (_queued)
+		return mixQueued(samples, len);
+#endif
+
 	Common::StackLock lock(_mutex);
 
 	// Since the mixer callback has been called, the mixer must be ready...
 	_mixerReady = true;
 
+	return mixChannels(samples, len);
+}
+
+int MixerImpl::mixChannels(byte *samples, uint len) {
 	// we store samples of size defined by the backend
 	const uint bytesPerFrame = _outBytesPerSample * (_stereo ? 2 : 1);
 	assert(len % bytesPerFrame == 0);
 	const uint numFrames = len / bytesPerFrame;
 
+	// when mixing into the bus, the channels produce unclamped 32-bit samples
+	// which are only clamped once all of them have been added up
+	const bool useBus = _mixBus && _clamp && _outBytesPerSample == 2;
+	byte *mixBuffer = samples;
+	uint mixBytesPerSample = _outBytesPerSample;
+	if (useBus) {
+		const uint busSize = numFrames * (_stereo ? 2 : 1);
+		if (busSize > _busSize) {
+			delete[] _busBuffer;
+			_busBuffer = new int32[busSize];
+			_busSize = busSize;
+		}
+		mixBuffer = (byte *)_busBuffer;
+		mixBytesPerSample = sizeof(int32);
+	}
+
 	// mix all channels, zeroing the buffer lazily on first non-silent channel
 	bool zeroed = false;
 	int res = 0, tmp;
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i]) {
 			if (_channels[i]->isFinished()) {
+#ifndef NO_CXX11_ATOMIC
+				if (_queued)
+					releaseSlot(i, _channels[i]->getHandle()._val);
+#endif
 				delete _channels[i];
 				_channels[i] = nullptr;
 			} else if (!_channels[i]->isPaused()) {
 				if (!_channels[i]->isSilent() && !zeroed) {
-					memset(samples, 0, len);
+					memset(mixBuffer, 0, numFrames * (_stereo ? 2 : 1) * mixBytesPerSample);
 					zeroed = true;
 				}
-				tmp = _channels[i]->mix(samples, numFrames);
+				tmp = _channels[i]->mix(mixBuffer, numFrames, mixBytesPerSample, _clamp && !useBus);
 
 				if (tmp > res)
 					res = tmp;
+#ifndef NO_CXX11_ATOMIC
+				if (_queued)
+					publishSlotState(i);
+#endif
 			}
 		}
 
@@ -383,11 +568,71 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 			// optimization: let the caller know that there's nothing to clamp
 			res = 0;
 		}
+	} else if (useBus) {
+		resolveMixBus((int16 *)samples, numFrames);
 	}
 	return res;
 }
 
+void MixerImpl::resolveMixBus(int16 *out, uint numFrames) {
+	const uint channels = _stereo ? 2 : 1;
+	const int32 *in = _busBuffer;
+
+	if (!_limiter) {
+		// Kept trivial, so that the compiler can vectorize it
+		for (uint i = 0; i < numFrames * channels; ++i)
+			out[i] = CLIP<int32>(in[i], -32768, 32767);
+		return;
+	}
+
+	// The gain may rise by this much per block
+	const uint releaseFrames = MAX<uint>(_limiterRelease * _sampleRate / 1000, 1);
+	const int32 releaseStep = MAX<int32>((int32)((int64)LIMITER_UNITY * LIMITER_BLOCK / releaseFrames), 1);
+
+	for (uint pos = 0; pos < numFrames; pos += LIMITER_BLOCK) {
+		const uint count = MIN<uint>(LIMITER_BLOCK, numFrames - pos) * channels;
+
+		int32 peak = 0;
+		for (uint i = 0; i < count; ++i)
+			peak = MAX<int32>(peak, ABS(in[i]));
+
+		// Attack instantly, so that no block ever exceeds the threshold
+		int32 target = LIMITER_UNITY;
+		if (peak > _limiterThreshold)
+			target = (int32)((int64)_limiterThreshold * LIMITER_UNITY / peak);
+
+		if (target < _limiterGain)
+			_limiterGain = target;
+		else
+			_limiterGain = MIN<int32>(target, _limiterGain + releaseStep);
+
+		if (_limiterGain == LIMITER_UNITY) {
+			for (uint i = 0; i < count; ++i)
+				out[i] = CLIP<int32>(in[i], -32768, 32767);
+		} else {
+			for (uint i = 0; i < count; ++i)
+				out[i] = CLIP<int32>((int32)(((int64)in[i] * _limiterGain) >> 16), -32768, 32767);
+		}
+
+		in += count;
+		out += count;
+	}
+}
+
 void MixerImpl::stopAll() {
+#ifndef NO_CXX11_ATOMIC
+	if (_queued) {
+		Common::StackLock lock(_queueMutex);
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_slotState[i].handle.load(std::memory_order_acquire) != FREE_SLOT && !_slotInfo[i].permanent)
+				_slotState[i].handle.store(FREE_SLOT, std::memory_order_release);
+		}
+		postCommand(kCmdStopAll, FREE_SLOT);
+		waitForCommands();
+		return;
+	}
+#endif
+
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != nullptr && !_channels[i]->isPermanent()) {
@@ -398,6 +643,21 @@ void MixerImpl::stopAll() {
 }
 
 void MixerImpl::stopID(int id) {
+#ifndef NO_CXX11_ATOMIC
+	if (_queued) {
+		Common::StackLock lock(_queueMutex);
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			const uint32 handle = _slotState[i].handle.load(std::memory_order_acquire);
+			if (handle != FREE_SLOT && _slotInfo[i].id == id) {
+				_slotState[i].handle.store(FREE_SLOT, std::memory_order_release);
+				postCommand(kCmdStop, handle);
+			}
+		}
+		waitForCommands();
+		return;
+	}
+#endif
+
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
@@ -408,6 +668,19 @@ void MixerImpl::stopID(int id) {
 }
 
 void MixerImpl::stopHandle(SoundHandle handle) {
+#ifndef NO_CXX11_ATOMIC
+	if (_queued) {
+		Common::StackLock lock(_queueMutex);
+		const int index = findQueuedSlot(handle);
+		if (index == -1)
+			return;
+		_slotState[index].handle.store(FREE_SLOT, std::memory_order_release);
+		postCommand(kCmdStop, handle._val);
+		waitForCommands();
+		return;
+	}
+#endif
+
 	Common::StackLock lock(_mutex);
 
 	// Simply ignore stop requests for handles of sounds that already terminated
@@ -420,6 +693,16 @@ void MixerImpl::stopHandle(SoundHandle handle) {
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
+#ifndef NO_CXX11_ATOMIC
+	if (_queued) {
+		assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
+		Common::StackLock lock(_queueMutex);
+		_soundTypeSettings[type].mute = mute;
+		postCommand(kCmdSoundTypeSettings, type, _soundTypeSettings[type].volume, mute);
+		return;
+	}
+#endif
+
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
 	_soundTypeSettings[type].mute = mute;
 
@@ -435,6 +718,18 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 }
 
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
+#ifndef NO_CXX11_ATOMIC
+	if (_queued) {
+		Common::StackLock lock(_queueMutex);
+		const int index = findQueuedSlot(handle);
+		if (index == -1)
+			return;
+		_slotInfo[index].volume = volume;
+		postCommand(kCmdVolume, handle._val, volume);
+		return;
+	}
+#endif
+
 	Common::StackLock lock(_mutex);
 
 	const int index = handle._val % NUM_CHANNELS;
@@ -445,6 +740,14 @@ void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) const {
+#ifndef NO_CXX11_ATOMIC
+	if (_queued) {
+		Common::StackLock lock(_queueMutex);
+		const int index = findQueuedSlot(handle);
+		return index != -1 ? _slotInfo[index].volume : 0;
+	}
+#endif
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return 0;
@@ -453,6 +756,18 @@ byte MixerImpl::getChannelVolume(SoundHandle handle) const {
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
+#ifndef NO_CXX11_ATOMIC
+	if (_queued) {
+		Common::StackLock lock(_queueMutex);
+		const int index = findQueuedSlot(handle);
+		if (index == -1)
+			return;
+		_slotInfo[index].balance = balance;
+		postCommand(kCmdBalance, handle._val, balance);
+		return;
+	}
+#endif
+
 	Common::StackLock lock(_mutex);
 
 	const int index = handle._val % NUM_CHANNELS;
@@ -463,6 +778,14 @@ void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) const {
+#ifndef NO_CXX11_ATOMIC
+	if (_queued) {
+		Common::StackLock lock(_queueMutex);
+		const int index = findQueuedSlot(handle);
+		return index != -1 ? _slotInfo[index].balance : 0;
+	}
+#endif
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return 0;
@@ -471,6 +794,18 @@ int8 MixerImpl::getChannelBalance(SoundHandle handle) const {
 }
 
 void MixerImpl::setChannelFaderL(SoundHandle handle, uint8 faderL) {
+#ifndef NO_CXX11_ATOMIC
+	if (_queued) {
+		Common::StackLock lock(_queueMutex);
+		const int index = findQueuedSlot(handle);
+		if (index == -1)
+			return;
+		_slotInfo[index].faderL = faderL;
+		postCommand(kCmdFaderL, handle._val, faderL);
+		return;
+	}
+#endif
+
 	Common::StackLock lock(_mutex);
 
 	const int index = handle._val % NUM_CHANNELS;
@@ -481,6 +816,14 @@ void MixerImpl::setChannelFaderL(SoundHandle handle, uint8 faderL) {
 }
 
 uint8 MixerImpl::getChannelFaderL(SoundHandle handle) const {
+#ifndef NO_CXX11_ATOMIC
+	if (_queued) {
+		Common::StackLock lock(_queueMutex);
+		const int index = findQueuedSlot(handle);
+		return index != -1 ? _slotInfo[index].faderL : 0;
+	}
+#endif
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return 0;
@@ -489,6 +832,18 @@ uint8 MixerImpl::getChannelFaderL(SoundHandle handle) const {
 }
 
 void MixerImpl::setChannelFaderR(SoundHandle handle, uint8 faderR) {
+#ifndef NO_CXX11_ATOMIC
+	if (_queued) {
+		Common::StackLock lock(_queueMutex);
+		const int index = findQueuedSlot(handle);
+		if (index == -1)
+			return;
+		_slotInfo[index].faderR = faderR;
+		postCommand(kCmdFaderR, handle._val, faderR);
+		return;
+	}
+#endif
+
 	Common::StackLock lock(_mutex);
 
 	const int index = handle._val % NUM_CHANNELS;
@@ -499,6 +854,14 @@ void MixerImpl::setChannelFaderR(SoundHandle handle, uint8 faderR) {
 }
 
 uint8 MixerImpl::getChannelFaderR(SoundHandle handle) const {
+#ifndef NO_CXX11_ATOMIC
+	if (_queued) {
+		Common::StackLock lock(_queueMutex);
+		const int index = findQueuedSlot(handle);
+		return index != -1 ? _slotInfo[index].faderR : 0;
+	}
+#endif
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return 0;
@@ -507,6 +870,18 @@ uint8 MixerImpl::getChannelFaderR(SoundHandle handle) const {
 }
 
 void MixerImpl::setChannelRate(SoundHandle handle, uint32 rate) {
+#ifndef NO_CXX11_ATOMIC
+	if (_queued) {
+		Common::StackLock lock(_queueMutex);
+		const int index = findQueuedSlot(handle);
+		if (index == -1)
+			return;
+		_slotInfo[index].rate = rate;
+		postCommand(kCmdRate, handle._val, rate);
+		return;
+	}
+#endif
+
 	Common::StackLock lock(_mutex);
 
 	const int index = handle._val % NUM_CHANNELS;
@@ -517,6 +892,14 @@ void MixerImpl::setChannelRate(SoundHandle handle, uint32 rate) {
 }
 
 uint32 MixerImpl::getChannelRate(SoundHandle handle) const {
+#ifndef NO_CXX11_ATOMIC
+	if (_queued) {
+		Common::StackLock lock(_queueMutex);
+		const int index = findQueuedSlot(handle);
+		return index != -1 ? _slotInfo[index].rate : 0;
+	}
+#endif
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return 0;
@@ -525,6 +908,18 @@ uint32 MixerImpl::getChannelRate(SoundHandle handle) const {
 }
 
 void MixerImpl::resetChannelRate(SoundHandle handle) {
+#ifndef NO_CXX11_ATOMIC
+	if (_queued) {
+		Common::StackLock lock(_queueMutex);
+		const int index = findQueuedSlot(handle);
+		if (index == -1)
+			return;
+		_slotInfo[index].rate = _slotInfo[index].defaultRate;
+		postCommand(kCmdResetRate, handle._val);
+		return;
+	}
+#endif
+
 	Common::StackLock lock(_mutex);
 
 	const int index = handle._val % NUM_CHANNELS;
@@ -539,6 +934,15 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) const {
 }
 
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) const {
+#ifndef NO_CXX11_ATOMIC
+	if (_queued) {
+		const int index = findQueuedSlot(handle);
+		if (index == -1)
+			return Timestamp(0, _sampleRate);
+		return getQueuedElapsedTime(index);
+	}
+#endif
+
 	Common::StackLock lock(_mutex);
 
 	const int index = handle._val % NUM_CHANNELS;
@@ -549,6 +953,15 @@ Timestamp MixerImpl::getElapsedTime(SoundHandle handle) const {
 }
 
 void MixerImpl::loopChannel(SoundHandle handle) {
+#ifndef NO_CXX11_ATOMIC
+	if (_queued) {
+		Common::StackLock lock(_queueMutex);
+		if (findQueuedSlot(handle) != -1)
+			postCommand(kCmdLoop, handle._val);
+		return;
+	}
+#endif
+
 	Common::StackLock lock(_mutex);
 
 	const int index = handle._val % NUM_CHANNELS;
@@ -559,6 +972,14 @@ void MixerImpl::loopChannel(SoundHandle handle) {
 }
 
 void MixerImpl::pauseAll(bool paused) {
+#ifndef NO_CXX11_ATOMIC
+	if (_queued) {
+		Common::StackLock lock(_queueMutex);
+		postCommand(kCmdPauseAll, FREE_SLOT, paused);
+		return;
+	}
+#endif
+
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != nullptr) {
@@ -568,6 +989,20 @@ void MixerImpl::pauseAll(bool paused) {
 }
 
 void MixerImpl::pauseID(int id, bool paused) {
+#ifndef NO_CXX11_ATOMIC
+	if (_queued) {
+		Common::StackLock lock(_queueMutex);
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			const uint32 handle = _slotState[i].handle.load(std::memory_order_acquire);
+			if (handle != FREE_SLOT && _slotInfo[i].id == id) {
+				postCommand(kCmdPause, handle, paused);
+				return;
+			}
+		}
+		return;
+	}
+#endif
+
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != nullptr && _channels[i]->getId() == id) {
@@ -578,6 +1013,15 @@ void MixerImpl::pauseID(int id, bool paused) {
 }
 
 void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
+#ifndef NO_CXX11_ATOMIC
+	if (_queued) {
+		Common::StackLock lock(_queueMutex);
+		if (findQueuedSlot(handle) != -1)
+			postCommand(kCmdPause, handle._val, paused);
+		return;
+	}
+#endif
+
 	Common::StackLock lock(_mutex);
 
 	// Simply ignore (un)pause requests for sounds that already terminated
@@ -589,6 +1033,21 @@ void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
 }
 
 bool MixerImpl::isSoundIDActive(int id) const {
+#ifndef NO_CXX11_ATOMIC
+	if (_queued) {
+		Common::StackLock lock(_queueMutex);
+
+#ifdef ENABLE_EVENTRECORDER
+		g_eventRec.updateSubsystems();
+#endif
+
+		for (int i = 0; i != NUM_CHANNELS; i++)
+			if (_slotState[i].handle.load(std::memory_order_acquire) != FREE_SLOT && _slotInfo[i].id == id)
+				return true;
+		return false;
+	}
+#endif
+
 	Common::StackLock lock(_mutex);
 
 #ifdef ENABLE_EVENTRECORDER
@@ -602,6 +1061,14 @@ bool MixerImpl::isSoundIDActive(int id) const {
 }
 
 int MixerImpl::getSoundID(SoundHandle handle) const {
+#ifndef NO_CXX11_ATOMIC
+	if (_queued) {
+		Common::StackLock lock(_queueMutex);
+		const int index = findQueuedSlot(handle);
+		return index != -1 ? _slotInfo[index].id : 0;
+	}
+#endif
+
 	Common::StackLock lock(_mutex);
 	const int index = handle._val % NUM_CHANNELS;
 	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
@@ -610,6 +1077,16 @@ int MixerImpl::getSoundID(SoundHandle handle) const {
 }
 
 bool MixerImpl::isSoundHandleActive(SoundHandle handle) const {
+#ifndef NO_CXX11_ATOMIC
+	if (_queued) {
+#ifdef ENABLE_EVENTRECORDER
+		g_eventRec.updateSubsystems();
+#endif
+
+		return findQueuedSlot(handle) != -1;
+	}
+#endif
+
 	Common::StackLock lock(_mutex);
 
 #ifdef ENABLE_EVENTRECORDER
@@ -621,6 +1098,16 @@ bool MixerImpl::isSoundHandleActive(SoundHandle handle) const {
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) const {
+#ifndef NO_CXX11_ATOMIC
+	if (_queued) {
+		Common::StackLock lock(_queueMutex);
+		for (int i = 0; i != NUM_CHANNELS; i++)
+			if (_slotState[i].handle.load(std::memory_order_acquire) != FREE_SLOT && _slotInfo[i].type == type)
+				return true;
+		return false;
+	}
+#endif
+
 	Common::StackLock lock(_mutex);
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i] && _channels[i]->getType() == type)
@@ -637,6 +1124,15 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 	// TODO: Maybe we should do logarithmic (not linear) volume
 	// scaling? See also Player_V2::setMasterVolume
 
+#ifndef NO_CXX11_ATOMIC
+	if (_queued) {
+		Common::StackLock lock(_queueMutex);
+		_soundTypeSettings[type].volume = volume;
+		postCommand(kCmdSoundTypeSettings, type, volume, _soundTypeSettings[type].mute);
+		return;
+	}
+#endif
+
 	Common::StackLock lock(_mutex);
 	_soundTypeSettings[type].volume = volume;
 
@@ -652,12 +1148,335 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 	return _soundTypeSettings[type].volume;
 }
 
+#ifndef NO_CXX11_ATOMIC
+
+#pragma mark -
+#pragma mark --- Command queue ---
+#pragma mark -
+
+int MixerImpl::findQueuedSlot(SoundHandle handle) const {
+	if (handle._val == FREE_SLOT)
+		return -1;
+
+	const int index = handle._val % NUM_CHANNELS;
+	if (_slotState[index].handle.load(std::memory_order_acquire) != handle._val)
+		return -1;
+
+	return index;
+}
+
+void MixerImpl::playQueuedStream(SoundType type, SoundHandle *handle, AudioStream *stream, int id, byte volume, int8 balance,
+                                 DisposeAfterUse::Flag autofreeStream, bool permanent, bool reverseStereo) {
+	Common::StackLock lock(_queueMutex);
+
+	if (stream == nullptr) {
+		warning("stream is 0");
+		return;
+	}
+
+	// Prevent duplicate sounds, see playStream()
+	if (id != -1) {
+		for (int i = 0; i != NUM_CHANNELS; i++)
+			if (_slotState[i].handle.load(std::memory_order_acquire) != FREE_SLOT && _slotInfo[i].id == id) {
+				if (autofreeStream == DisposeAfterUse::YES)
+					delete stream;
+				return;
+			}
+	}
+
+#ifdef AUDIO_REVERSE_STEREO
+	reverseStereo = !reverseStereo;
+#endif
+
+	// The channel is set up here, but it is only handed over to the mixing
+	// thread through the queue. Its volumes are computed over there.
+	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
+
+	int index = -1;
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		if (_slotState[i].handle.load(std::memory_order_acquire) == FREE_SLOT) {
+			index = i;
+			break;
+		}
+	}
+	if (index == -1) {
+		warning("MixerImpl::out of mixer slots");
+		delete chan;
+		return;
+	}
+
+	SoundHandle chanHandle;
+	do {
+		chanHandle._val = index + (_handleSeed++ * NUM_CHANNELS);
+	} while (chanHandle._val == FREE_SLOT);
+	chan->setHandle(chanHandle);
+
+	SlotInfo &info = _slotInfo[index];
+	info.id = id;
+	info.type = type;
+	info.permanent = permanent;
+	info.volume = volume;
+	info.balance = balance;
+	info.faderL = 255;
+	info.faderR = 255;
+	info.rate = info.defaultRate = chan->getRate();
+
+	_slotState[index].handle.store(chanHandle._val, std::memory_order_release);
+	postCommand(kCmdPlay, chanHandle._val, volume, balance, chan);
+
+	if (handle)
+		*handle = chanHandle;
+}
+
+void MixerImpl::postCommand(CommandType type, uint32 handle, int32 param1, int32 param2, Channel *channel) {
+	const uint32 write = _commandWrite.load(std::memory_order_relaxed);
+	const uint32 next = (write + 1) % COMMAND_QUEUE_SIZE;
+
+	// The queue only runs full when the mixing thread is stalled. Give it
+	// some time to catch up, but do not hang if the audio was suspended.
+	for (int wait = 0; next == _commandRead.load(std::memory_order_acquire); wait++) {
+		if (wait == 100) {
+			warning("MixerImpl::postCommand: Command queue is full, dropping command %d", type);
+			if (type == kCmdPlay) {
+				_slotState[handle % NUM_CHANNELS].handle.store(FREE_SLOT, std::memory_order_release);
+				delete channel;
+			}
+			return;
+		}
+		g_system->delayMillis(1);
+	}
+
+	Command &cmd = _commands[write];
+	cmd.type = type;
+	cmd.handle = handle;
+	cmd.param1 = param1;
+	cmd.param2 = param2;
+	cmd.channel = channel;
+
+	_commandWrite.store(next, std::memory_order_release);
+	_commandsPosted++;
+}
+
+void MixerImpl::waitForCommands() {
+	// Either the mixing thread has not reached the point where it executes
+	// the commands yet (it may be waiting for the mutex held by the caller),
+	// and then it executes them before it mixes again, or it is past that
+	// point and has to get through them. This pairs with the fence in
+	// mixQueued().
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	const uint32 posted = _commandsPosted;
+	for (int wait = 0; _callbackActive.load(std::memory_order_seq_cst) &&
+	                   (int32)(_commandsDone.load(std::memory_order_acquire) - posted) < 0; wait++) {
+		// A mix pass never takes this long, unless the call comes from the
+		// mixing thread itself (e.g. from an audio stream)
+		if (wait == 1000) {
+			warning("MixerImpl::waitForCommands: Gave up waiting for the mixing thread");
+			return;
+		}
+		g_system->delayMillis(1);
+	}
+}
+
+int MixerImpl::mixQueued(byte *samples, uint len) {
+	// Audio players which share the mixer mutex protect the state of their
+	// streams with it, so it has to be held while they are being pulled from.
+	// The mixer state itself never needs it in this mode.
+	bool locked = false;
+	while (true) {
+		if (!locked && _mutexShared.load(std::memory_order_acquire)) {
+			_mutex.lock();
+			locked = true;
+		}
+
+		// Stopping callers only wait for the commands while this is set. It
+		// must not be set while waiting for the mutex, which they may hold,
+		// and every command posted before it was set is executed below.
+		_callbackActive.store(true, std::memory_order_seq_cst);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		processCommands();
+
+		// The player may have asked for the mutex right before starting the sound
+		if (locked || !_mutexShared.load(std::memory_order_acquire))
+			break;
+		_callbackActive.store(false, std::memory_order_seq_cst);
+	}
+
+	const int res = mixChannels(samples, len);
+
+	if (locked)
+		_mutex.unlock();
+
+	_callbackActive.store(false, std::memory_order_release);
+	return res;
+}
+
+void MixerImpl::processCommands() {
+	uint32 read = _commandRead.load(std::memory_order_relaxed);
+	const uint32 write = _commandWrite.load(std::memory_order_acquire);
+
+	uint32 count = 0;
+	while (read != write) {
+		executeCommand(_commands[read]);
+		read = (read + 1) % COMMAND_QUEUE_SIZE;
+		count++;
+	}
+
+	_commandRead.store(read, std::memory_order_release);
+	_commandsDone.fetch_add(count, std::memory_order_release);
+}
+
+void MixerImpl::executeCommand(const Command &cmd) {
+	switch (cmd.type) {
+	case kCmdPlay: {
+		const int index = cmd.handle % NUM_CHANNELS;
+		// A slot is only handed out again after its stop command was queued
+		assert(!_channels[index]);
+		_channels[index] = cmd.channel;
+		cmd.channel->setVolume(cmd.param1);
+		cmd.channel->setBalance(cmd.param2);
+		publishSlotState(index);
+		return;
+	}
+
+	case kCmdStopAll:
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_channels[i] != nullptr && !_channels[i]->isPermanent()) {
+				delete _channels[i];
+				_channels[i] = nullptr;
+			}
+		}
+		return;
+
+	case kCmdPauseAll:
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_channels[i] != nullptr) {
+				_channels[i]->pause(cmd.param1 != 0);
+				publishSlotState(i);
+			}
+		}
+		return;
+
+	case kCmdSoundTypeSettings:
+		_mixSoundTypeSettings[cmd.handle].volume = cmd.param1;
+		_mixSoundTypeSettings[cmd.handle].mute = (cmd.param2 != 0);
+		for (int i = 0; i != NUM_CHANNELS; ++i) {
+			if (_channels[i] && _channels[i]->getType() == (SoundType)cmd.handle)
+				_channels[i]->notifyGlobalVolChange();
+		}
+		return;
+
+	default:
+		break;
+	}
+
+	// Commands for a single channel; the sound may have ended in the meantime
+	const int index = cmd.handle % NUM_CHANNELS;
+	Channel *chan = _channels[index];
+	if (!chan || chan->getHandle()._val != cmd.handle)
+		return;
+
+	switch (cmd.type) {
+	case kCmdStop:
+		delete chan;
+		_channels[index] = nullptr;
+		break;
+
+	case kCmdPause:
+		chan->pause(cmd.param1 != 0);
+		publishSlotState(index);
+		break;
+
+	case kCmdVolume:
+		chan->setVolume(cmd.param1);
+		break;
+
+	case kCmdBalance:
+		chan->setBalance(cmd.param1);
+		break;
+
+	case kCmdFaderL:
+		chan->setFaderL(cmd.param1);
+		break;
+
+	case kCmdFaderR:
+		chan->setFaderR(cmd.param1);
+		break;
+
+	case kCmdRate:
+		chan->setRate(cmd.param1);
+		break;
+
+	case kCmdResetRate:
+		chan->resetRate();
+		break;
+
+	case kCmdLoop:
+		chan->loop();
+		break;
+
+	default:
+		break;
+	}
+}
+
+void MixerImpl::publishSlotState(int index) {
+	const Channel *chan = _channels[index];
+	SlotState &state = _slotState[index];
+
+	const uint32 sequence = state.sequence.load(std::memory_order_relaxed);
+	state.sequence.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	state.timingHandle.store(chan->getHandle()._val, std::memory_order_relaxed);
+	state.samplesConsumed.store(chan->getSamplesConsumed(), std::memory_order_relaxed);
+	state.mixerTimeStamp.store(chan->getMixerTimeStamp(), std::memory_order_relaxed);
+	state.pauseStartTime.store(chan->getPauseStartTime(), std::memory_order_relaxed);
+	state.pauseTime.store(chan->getPauseTime(), std::memory_order_relaxed);
+	state.paused.store(chan->isPaused(), std::memory_order_relaxed);
+
+	state.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+void MixerImpl::releaseSlot(int index, uint32 handle) {
+	// The slot may already have been stopped and handed out again by the
+	// game thread, in which case it must not be touched.
+	uint32 expected = handle;
+	_slotState[index].handle.compare_exchange_strong(expected, FREE_SLOT, std::memory_order_acq_rel);
+}
+
+Timestamp MixerImpl::getQueuedElapsedTime(int index) const {
+	const SlotState &state = _slotState[index];
+	const uint32 handle = state.handle.load(std::memory_order_acquire);
+
+	uint32 sequence, timingHandle, samplesConsumed, mixerTimeStamp, pauseStartTime, pauseTime;
+	bool paused;
+	do {
+		sequence = state.sequence.load(std::memory_order_acquire);
+		timingHandle = state.timingHandle.load(std::memory_order_relaxed);
+		samplesConsumed = state.samplesConsumed.load(std::memory_order_relaxed);
+		mixerTimeStamp = state.mixerTimeStamp.load(std::memory_order_relaxed);
+		pauseStartTime = state.pauseStartTime.load(std::memory_order_relaxed);
+		pauseTime = state.pauseTime.load(std::memory_order_relaxed);
+		paused = state.paused.load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_acquire);
+	} while ((sequence & 1) || sequence != state.sequence.load(std::memory_order_relaxed));
+
+	// The mixing thread has not picked up the sound yet
+	if (timingHandle != handle)
+		return Timestamp(0, _sampleRate);
+
+	return Channel::computeElapsedTime(_sampleRate, samplesConsumed, mixerTimeStamp, pauseStartTime, pauseTime, paused);
+}
+
+#endif // NO_CXX11_ATOMIC
 
 #pragma mark -
 #pragma mark --- Channel implementations ---
 #pragma mark -
 
-Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
+Channel::Channel(MixerImpl *mixer, Mixer::SoundType type, AudioStream *stream,
 				 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
 	: _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
 	  _balance(0), _faderL(255), _faderR(255), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
@@ -737,8 +1556,10 @@ void Channel::updateChannelVolumes() {
 	// volume is in the range 0 - kMaxMixerVolume.
 	// Hence, the vol_l/vol_r values will be in that range, too
 
-	if (!_mixer->isSoundTypeMuted(_type)) {
-		int vol = _mixer->getVolumeForSoundType(_type) * _volume;
+	const MixerImpl::SoundTypeSettings &settings = _mixer->getChannelTypeSettings(_type);
+
+	if (!settings.mute) {
+		int vol = settings.volume * _volume;
 
 		if (_balance == 0) {
 			_volL = vol / Mixer::kMaxChannelVolume;
@@ -776,22 +1597,26 @@ void Channel::pause(bool paused) {
 }
 
 Timestamp Channel::getElapsedTime() const {
-	const uint32 rate = _mixer->getOutputRate();
+	return computeElapsedTime(_mixer->getOutputRate(), _samplesConsumed, _mixerTimeStamp, _pauseStartTime, _pauseTime, isPaused());
+}
+
+Timestamp Channel::computeElapsedTime(uint32 rate, uint32 samplesConsumed, uint32 mixerTimeStamp,
+                                      uint32 pauseStartTime, uint32 pauseTime, bool paused) {
 	uint32 delta = 0;
 
 	Audio::Timestamp ts(0, rate);
 
-	if (_mixerTimeStamp == 0)
+	if (mixerTimeStamp == 0)
 		return ts;
 
-	if (isPaused())
-		delta = _pauseStartTime - _mixerTimeStamp;
+	if (paused)
+		delta = pauseStartTime - mixerTimeStamp;
 	else
-		delta = g_system->getMillis(true) - _mixerTimeStamp - _pauseTime;
+		delta = g_system->getMillis(true) - mixerTimeStamp - pauseTime;
 
 	// Convert the number of samples into a time duration.
 
-	ts = ts.addFrames(_samplesConsumed);
+	ts = ts.addFrames(samplesConsumed);
 	ts = ts.addMsecs(delta);
 
 	// In theory it would seem like a good idea to limit the approximation
@@ -812,7 +1637,7 @@ void Channel::loop() {
 	}
 }
 
-int Channel::mix(byte *data, uint len) {
+int Channel::mix(byte *data, uint len, uint bytesPerSample, bool clamp) {
 	assert(_stream);
 	assert(_converter);
 
@@ -824,11 +1649,11 @@ int Channel::mix(byte *data, uint len) {
 		res = _converter->convert(
 			*_stream,
 			data,
-			_mixer->getOutputBytesPerSample(),
+			bytesPerSample,
 			len,
 			_volL,
 			_volR,
-			_mixer->getClamping() ? MIX_CLAMPED_ADD : MIX_ADD);
+			clamp ? MIX_CLAMPED_ADD : MIX_ADD);
 		_samplesDecoded += res;
 	}
 
@@ -26,6 +26,10 @@
 #include "common/mutex.h"
 #include "audio/mixer.h"
 
+#ifndef NO_CXX11_ATOMIC
+#include <atomic>
+#endif
+
 namespace Audio {
 
 /**
@@ -49,6 +53,25 @@ namespace Audio {
  * 4) Change the mixer into ready mode via setReady(true).
  * 5) Start audio processing (e.g. by resuming the audio thread, if applicable).
  *
+ * Backends may additionally switch the mixer into command queue mode via
+ * enableCommandQueue() before step 4. In that mode, the control methods
+ * (playStream, stopHandle, setChannelVolume, ...) never wait for the mixing
+ * thread: they post commands into a single-consumer ring buffer which
+ * mixCallback() drains before mixing, and all handle queries are answered
+ * from state published by the mixing thread through atomics. The stop
+ * methods still return only once the mixing thread has let go of the
+ * stopped streams, so that their callers may delete them right away.
+ *
+ * The mixing thread then never takes the mixer mutex for itself. It only
+ * locks it while pulling samples from the audio streams once an audio player
+ * has asked for it via mutex(), because such players use it to protect the
+ * state their streams read.
+ *
+ * Independently of that, the channels can be mixed into an internal 32-bit
+ * bus (see enableMixBus()) instead of straight into the 16-bit output
+ * buffer. They are then summed without clamping after every channel, and
+ * the bus is clamped once per callback, optionally behind a master limiter.
+ *
  * In the future, we might make it possible for backends to provide
  * (partial) alternative implementations of the mixer, e.g. to make
  * better use of native sound mixing support on low-end devices.
@@ -56,6 +79,8 @@ namespace Audio {
  * @see OSystem::getMixer()
  */
 class MixerImpl : public Mixer {
+	friend class Channel;
+
 private:
 	enum {
 		NUM_CHANNELS = 32
@@ -81,6 +106,138 @@ private:
 	SoundTypeSettings _soundTypeSettings[4];
 	Channel *_channels[NUM_CHANNELS];
 
+	enum {
+		LIMITER_UNITY = 1 << 16,
+		LIMITER_BLOCK = 32
+	};
+
+	bool _mixBus;
+	int32 *_busBuffer;
+	uint _busSize;
+	bool _limiter;
+	int _limiterThreshold;
+	uint _limiterRelease;
+	int32 _limiterGain;
+
+	/**
+	 * Clamp the mix bus into the output buffer, applying the master limiter
+	 * if it is enabled.
+	 */
+	void resolveMixBus(int16 *out, uint numFrames);
+
+	/**
+	 * Mix all the channels into the output buffer, see mixCallback().
+	 */
+	int mixChannels(byte *samples, uint len);
+
+	/**
+	 * Return the sound type settings to be applied by the channels, which
+	 * in command queue mode are the copy owned by the mixing thread.
+	 */
+	const SoundTypeSettings &getChannelTypeSettings(SoundType type) const;
+
+#ifndef NO_CXX11_ATOMIC
+	enum {
+		COMMAND_QUEUE_SIZE = 256,
+		FREE_SLOT = 0xffffffff
+	};
+
+	enum CommandType {
+		kCmdPlay,
+		kCmdStop,
+		kCmdStopAll,
+		kCmdPause,
+		kCmdPauseAll,
+		kCmdVolume,
+		kCmdBalance,
+		kCmdFaderL,
+		kCmdFaderR,
+		kCmdRate,
+		kCmdResetRate,
+		kCmdLoop,
+		kCmdSoundTypeSettings
+	};
+
+	struct Command {
+		CommandType type;
+		uint32 handle;
+		int32 param1;
+		int32 param2;
+		Channel *channel;
+	};
+
+	/**
+	 * Properties of a channel as seen by the callers of the control methods.
+	 * Only accessed with _queueMutex held.
+	 */
+	struct SlotInfo {
+		int id;
+		SoundType type;
+		bool permanent;
+		byte volume;
+		int8 balance;
+		uint8 faderL;
+		uint8 faderR;
+		uint32 rate;
+		uint32 defaultRate;
+	};
+
+	/**
+	 * Channel state published by the mixing thread. The timing fields are
+	 * guarded by a sequence counter, so readers never see a torn update.
+	 */
+	struct SlotState {
+		std::atomic<uint32> handle;
+		std::atomic<uint32> sequence;
+		std::atomic<uint32> timingHandle;
+		std::atomic<uint32> samplesConsumed;
+		std::atomic<uint32> mixerTimeStamp;
+		std::atomic<uint32> pauseStartTime;
+		std::atomic<uint32> pauseTime;
+		std::atomic<bool> paused;
+	};
+
+	bool _queued;
+	Common::Mutex _queueMutex;
+	SlotInfo _slotInfo[NUM_CHANNELS];
+	SlotState _slotState[NUM_CHANNELS];
+	SoundTypeSettings _mixSoundTypeSettings[4];
+
+	Command _commands[COMMAND_QUEUE_SIZE];
+	std::atomic<uint32> _commandRead;
+	std::atomic<uint32> _commandWrite;
+
+	/** Number of commands posted, only accessed with _queueMutex held. */
+	uint32 _commandsPosted;
+	/** Number of commands executed by the mixing thread. */
+	std::atomic<uint32> _commandsDone;
+	/**
+	 * Set while the mixing thread is inside mixCallback() and holds the
+	 * mixer mutex, if it needs it.
+	 */
+	std::atomic<bool> _callbackActive;
+	/** Set once an audio player has asked for the mixer mutex. */
+	std::atomic<bool> _mutexShared;
+
+	int findQueuedSlot(SoundHandle handle) const;
+	void postCommand(CommandType type, uint32 handle, int32 param1 = 0, int32 param2 = 0, Channel *channel = nullptr);
+	/**
+	 * Wait until the mixing thread can no longer be using any channel that
+	 * the commands posted so far removed. Must be called with _queueMutex
+	 * held.
+	 */
+	void waitForCommands();
+	int mixQueued(byte *samples, uint len);
+	void processCommands();
+	void executeCommand(const Command &cmd);
+	void publishSlotState(int index);
+	void releaseSlot(int index, uint32 handle);
+	Timestamp getQueuedElapsedTime(int index) const;
+
+	void playQueuedStream(SoundType type, SoundHandle *handle, AudioStream *stream, int id, byte volume, int8 balance,
+	                      DisposeAfterUse::Flag autofreeStream, bool permanent, bool reverseStereo);
+#endif
+
 
 public:
 
@@ -89,7 +246,7 @@ public:
 
 	bool isReady() const override { Common::StackLock lock(_mutex); return _mixerReady; }
 
-	Common::Mutex &mutex() override { return _mutex; }
+	Common::Mutex &mutex() override;
 
 	void playStream(
 		SoundType type,
@@ -148,6 +305,56 @@ protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
 
 public:
+	/**
+	 * Switch the mixer into command queue mode (see above). This must be
+	 * called before the mixer is set ready, or at least before any sound
+	 * has been started.
+	 *
+	 * @return true if the mode is active, false if it is not supported
+	 *         on this platform.
+	 */
+	bool enableCommandQueue(bool enable);
+
+	/**
+	 * Return whether the mixer runs in command queue mode.
+	 */
+	bool isCommandQueueEnabled() const;
+
+	enum {
+		kDefaultLimiterThreshold = 32767,
+		kDefaultLimiterRelease = 100
+	};
+
+	/**
+	 * Mix the channels into an internal 32-bit bus instead of directly into
+	 * the output buffer (see above). This only has an effect if the mixer
+	 * produces 16-bit samples with clamping. In command queue mode, this
+	 * must be called before the mixer is set ready.
+	 */
+	void enableMixBus(bool enable);
+
+	/**
+	 * Return whether the channels are mixed into the internal bus.
+	 */
+	bool isMixBusEnabled() const;
+
+	/**
+	 * Return whether the master limiter is applied to the mix bus.
+	 */
+	bool isLimiterEnabled() const;
+
+	/**
+	 * Configure the master limiter of the mix bus. Whenever the mix would
+	 * exceed the threshold, the limiter instantly lowers the gain just
+	 * enough, and then lets it recover over the release time. In command
+	 * queue mode, this must be called before the mixer is set ready.
+	 *
+	 * @param enable     whether the limiter is active
+	 * @param threshold  highest output level, from 1 to 32767
+	 * @param releaseMs  time the gain takes to recover from full attenuation
+	 */
+	void setLimiter(bool enable, int threshold = kDefaultLimiterThreshold, uint releaseMs = kDefaultLimiterRelease);
+
 	/**
 	 * Adjust the output buffer size
 	 */
@@ -9,6 +9,7 @@ MODULE_OBJS := \
 	casio.o \
 	chip.o \
 	cms.o \
+	decodedcache.o \
 	fmopl.o \
 	mac_plugin.o \
 	mididrv.o \
@@ -27,6 +28,7 @@ MODULE_OBJS := \
 	musicplugin.o \
 	null.o \
 	rate.o \
+	readahead.o \
 	sid.o \
 	ym2149.o \
 	timestamp.o \
@@ -72,6 +74,19 @@ MODULE_OBJS := \
 	softsynth/pcspk.o \
 	softsynth/ay8912.o
 
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	rate_neon.o
+endif
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	rate_sse2.o
+endif
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	rate_avx2.o
+endif
+
 ifdef USE_HMI_AUDIO
 MODULE_OBJS += \
 	effects/hmi/interfaces/envelope.o \
@@ -31,23 +31,58 @@
 
 #include "audio/audiostream.h"
 #include "audio/rate.h"
+#include "audio/rate_intern.h"
 #include "audio/mixer.h"
 #include "common/config-manager.h"
 #include "common/debug.h"
+#include "common/system.h"
 #include "common/util.h"
 
 namespace Audio {
 
-/**
- * The default fractional type in frac.h (with 16 fractional bits) limits
- * the rate conversion code to 65536Hz audio: we need to able to handle
- * 192kHz audio, so we use fewer fractional bits in this code.
- */
-enum {
-	FRAC_BITS_LOW = 14,
-	FRAC_ONE_LOW = (1L << FRAC_BITS_LOW),
-	FRAC_HALF_LOW = (1L << (FRAC_BITS_LOW-1))
-};
+const RateConverterSIMD::Kernels *RateConverterSIMD::_kernels = nullptr;
+bool RateConverterSIMD::_initialized = false;
+
+void RateConverterSIMD::init() {
+	if (_initialized)
+		return;
+
+	_initialized = true;
+#ifndef OUTPUT_UNSIGNED_AUDIO
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) _kernels = &kernelsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) _kernels = &kernelsSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) _kernels = &kernelsAVX2;
+#endif
+#endif
+}
+
+void RateConverterSIMD::set(const Kernels *kernels) {
+	_initialized = true;
+	_kernels = kernels;
+}
+
+// Pick the kernels for the output sample type; the 32-bit mix bus is never
+// clamped per channel
+static inline void mixSIMD(const RateConverterSIMD::Kernels *simd, bool inStereo, int16 *out, const int16 *in, int count, int volL, int volR, bool clamp) {
+	(inStereo ? simd->mixStereo : simd->mixMono)(out, in, count, volL, volR, clamp);
+}
+
+static inline void mixSIMD(const RateConverterSIMD::Kernels *simd, bool inStereo, int32 *out, const int16 *in, int count, int volL, int volR, bool clamp) {
+	(inStereo ? simd->mixStereo32 : simd->mixMono32)(out, in, count, volL, volR);
+}
+
+static inline void interpolateSIMDFrames(const RateConverterSIMD::Kernels *simd, bool inStereo, int16 *out, const int16 *frames, frac_t pos, frac_t inc, int count, int volL, int volR, bool clamp) {
+	(inStereo ? simd->interpolateStereo : simd->interpolateMono)(out, frames, pos, inc, count, volL, volR, clamp);
+}
+
+static inline void interpolateSIMDFrames(const RateConverterSIMD::Kernels *simd, bool inStereo, int32 *out, const int16 *frames, frac_t pos, frac_t inc, int count, int volL, int volR, bool clamp) {
+	(inStereo ? simd->interpolateStereo32 : simd->interpolateMono32)(out, frames, pos, inc, count, volL, volR);
+}
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
 class RateConverter_Impl : public RateConverter {
@@ -80,6 +115,22 @@ private:
 	/** Current sample(s) in the input stream (left/right channel) */
 	int16 _inCurL, _inCurR;
 
+	/** Vectorized kernels, if supported by the CPU and this conversion */
+	const RateConverterSIMD::Kernels *_simd;
+
+	/**
+	 * Whether the vectorized kernels apply: they only produce stereo, only
+	 * clamp 16-bit output, and are only used where the generic code processes
+	 * both channels.
+	 */
+	template<st_volume_t volL, st_volume_t volR, typename st_sample_t, MixMode mixMode>
+	bool canUseSIMD() const {
+		return outStereo && !reverseStereo && (sizeof(st_sample_t) == sizeof(int16) || mixMode == MIX_ADD) && volL != 0 && volR != 0 && _simd;
+	}
+
+	template<typename st_sample_t>
+	st_sample_t *interpolateSIMD(st_sample_t *outBuffer, const st_sample_t *outEnd, frac_t outPos_inc, st_volume_t volL_val, st_volume_t volR_val, bool clamp);
+
 	template<st_volume_t volL, st_volume_t volR, typename st_sample_t, MixMode mixMode>
 	int commonConvert(AudioStream &input, st_sample_t *outBuffer, st_size_t numSamples, st_volume_t volL_val, st_volume_t volR_val, int outputSamples);
 
@@ -154,7 +205,13 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::commonConvert(AudioS
 			(int)(outEnd - outBuffer) / (outStereo ? 2 : 1) / outputSamples);
 		_bufferSize -= count * (inStereo ? 2 : 1);
 
-		if (volL | volR) {
+		if (outputSamples == 1 && canUseSIMD<volL, volR, st_sample_t, mixMode>()) {
+			// Mix the data into the output buffer using the vectorized kernels
+			mixSIMD(_simd, inStereo, outBuffer, _bufferPos, count, volL_val, volR_val, mixMode == MIX_CLAMPED_ADD);
+
+			_bufferPos += count * (inStereo ? 2 : 1);
+			outBuffer += count * 2;
+		} else if (volL | volR) {
 			// Mix the data into the output buffer
 			for (int i = 0; i < count; ++i) {
 				int16 inL, inR;
@@ -396,6 +453,11 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(A
 			_outPosFrac -= FRAC_ONE_LOW;
 		}
 
+		// Interpolate as far as the buffered input reaches in one go; the loop
+		// below then continues seamlessly where the kernel left off
+		if (canUseSIMD<volL, volR, st_sample_t, mixMode>() && (inStereo || _simd->interpolateMono))
+			outBuffer = interpolateSIMD(outBuffer, outEnd, outPos_inc, volL_val, volR_val, mixMode == MIX_CLAMPED_ADD);
+
 		// Loop as long as the _outPos trails behind, and as long as there is
 		// still space in the output buffer.
 		while (_outPosFrac < (frac_t)FRAC_ONE_LOW && outBuffer < outEnd) {
@@ -458,6 +520,51 @@ int RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateConvert(A
 	return (outBuffer - outStart) / (outStereo ? 2 : 1);
 }
 
+template<bool inStereo, bool outStereo, bool reverseStereo>
+template<typename st_sample_t>
+st_sample_t *RateConverter_Impl<inStereo, outStereo, reverseStereo>::interpolateSIMD(st_sample_t *outBuffer, const st_sample_t *outEnd, frac_t outPos_inc, st_volume_t volL_val, st_volume_t volR_val, bool clamp) {
+	enum {
+		kMaxFrames = 64,
+		kChannels = inStereo ? 2 : 1
+	};
+
+	// Gather the current interpolation points and the buffered input into
+	// one frame array
+	int16 frames[(kMaxFrames + 2) * kChannels];
+	const int available = MIN<int>(_bufferSize / kChannels, kMaxFrames);
+
+	frames[0] = _inLastL;
+	frames[kChannels] = _inCurL;
+	if (inStereo) {
+		frames[1] = _inLastR;
+		frames[3] = _inCurR;
+	}
+	memcpy(frames + 2 * kChannels, _bufferPos, available * kChannels * sizeof(int16));
+
+	// Produce all output frames which lie before the last gathered frame
+	const frac_t end = (frac_t)(available + 1) << FRAC_BITS_LOW;
+	const int count = MIN<int>((end - _outPosFrac + outPos_inc - 1) / outPos_inc, (outEnd - outBuffer) / 2);
+	if (count <= 0)
+		return outBuffer;
+
+	interpolateSIMDFrames(_simd, inStereo, outBuffer, frames, _outPosFrac, outPos_inc, count, volL_val, volR_val, clamp);
+
+	// Leave the input in the same state as the generic code would: positioned
+	// at the interpolation points of the last output frame
+	const int consumed = (_outPosFrac + (count - 1) * outPos_inc) >> FRAC_BITS_LOW;
+	_inLastL = frames[consumed * kChannels];
+	_inCurL = frames[(consumed + 1) * kChannels];
+	if (inStereo) {
+		_inLastR = frames[consumed * 2 + 1];
+		_inCurR = frames[consumed * 2 + 3];
+	}
+	_bufferPos += consumed * kChannels;
+	_bufferSize -= consumed * kChannels;
+	_outPosFrac += count * outPos_inc - (consumed << FRAC_BITS_LOW);
+
+	return outBuffer + count * 2;
+}
+
 template<bool inStereo, bool outStereo, bool reverseStereo>
 RateConverter_Impl<inStereo, outStereo, reverseStereo>::RateConverter_Impl(st_rate_t inputRate, st_rate_t outputRate) :
 	_inRate(inputRate),
@@ -469,7 +576,8 @@ RateConverter_Impl<inStereo, outStereo, reverseStereo>::RateConverter_Impl(st_ra
 	_inCurL(0),
 	_inCurR(0),
 	_bufferSize(0),
-	_bufferPos(nullptr) {}
+	_bufferPos(nullptr),
+	_simd(RateConverterSIMD::get()) {}
 
 template<bool inStereo, bool outStereo, bool reverseStereo>
 template<typename st_sample_t, MixMode mixMode>
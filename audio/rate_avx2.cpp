@@ -0,0 +1,214 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "audio/rate_intern.h"
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Audio {
+
+// Computes (in * vol) / kMaxMixerVolume for sixteen samples, rounding towards
+// zero like the generic code does
+static FORCEINLINE __m256i avx2_scale(__m256i in, __m256i vol) {
+	const __m256i lo = _mm256_mullo_epi16(in, vol);
+	const __m256i hi = _mm256_mulhi_epi16(in, vol);
+	__m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+	__m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+	p0 = _mm256_add_epi32(p0, _mm256_and_si256(_mm256_srai_epi32(p0, 31), _mm256_set1_epi32(Mixer::kMaxMixerVolume - 1)));
+	p1 = _mm256_add_epi32(p1, _mm256_and_si256(_mm256_srai_epi32(p1, 31), _mm256_set1_epi32(Mixer::kMaxMixerVolume - 1)));
+	// The unpack and pack instructions both work within 128-bit lanes, so
+	// the sample order is preserved
+	return _mm256_packs_epi32(_mm256_srai_epi32(p0, 8), _mm256_srai_epi32(p1, 8));
+}
+
+static FORCEINLINE void avx2_mix(int16 *out, __m256i val, bool clamp) {
+	const __m256i dst = _mm256_loadu_si256((const __m256i *)out);
+	_mm256_storeu_si256((__m256i *)out, clamp ? _mm256_adds_epi16(dst, val) : _mm256_add_epi16(dst, val));
+}
+
+// Widens the samples for the 32-bit mix bus, which is never clamped here
+static FORCEINLINE void avx2_mix(int32 *out, __m256i val, bool clamp) {
+	const __m256i lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(val));
+	const __m256i hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(val, 1));
+	_mm256_storeu_si256((__m256i *)out, _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)out), lo));
+	_mm256_storeu_si256((__m256i *)(out + 8), _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)(out + 8)), hi));
+}
+
+// Scales the samples in @p l and @p r like avx2_scale and interleaves them
+// into stereo frames
+static FORCEINLINE __m256i avx2_scaleFrames(__m256i l, __m256i r, __m256i volLeft, __m256i volRight) {
+	const __m256i bias = _mm256_set1_epi32(Mixer::kMaxMixerVolume - 1);
+
+	l = _mm256_mullo_epi32(l, volLeft);
+	r = _mm256_mullo_epi32(r, volRight);
+	l = _mm256_srai_epi32(_mm256_add_epi32(l, _mm256_and_si256(_mm256_srai_epi32(l, 31), bias)), 8);
+	r = _mm256_srai_epi32(_mm256_add_epi32(r, _mm256_and_si256(_mm256_srai_epi32(r, 31), bias)), 8);
+
+	// Both values fit into 16 bits, so they can be recombined into frames
+	return _mm256_or_si256(_mm256_and_si256(l, _mm256_set1_epi32(0xffff)), _mm256_slli_epi32(r, 16));
+}
+
+template<typename T>
+static void mixStereoAVX2(T *out, const int16 *in, int count, int volL, int volR, bool clamp) {
+	const __m256i vol = _mm256_set1_epi32((volR << 16) | volL);
+
+	for (; count >= 8; count -= 8, in += 16, out += 16)
+		avx2_mix(out, avx2_scale(_mm256_loadu_si256((const __m256i *)in), vol), clamp);
+
+	for (; count > 0; --count, in += 2, out += 2) {
+		RateConverterSIMD::mixSample(out[0], RateConverterSIMD::scaleSample(in[0], volL), clamp);
+		RateConverterSIMD::mixSample(out[1], RateConverterSIMD::scaleSample(in[1], volR), clamp);
+	}
+}
+
+template<typename T>
+static void mixMonoAVX2(T *out, const int16 *in, int count, int volL, int volR, bool clamp) {
+	const __m256i vol = _mm256_set1_epi32((volR << 16) | volL);
+
+	for (; count >= 16; count -= 16, in += 16, out += 32) {
+		// Spread the samples so that the in-lane unpacking below yields
+		// them in order
+		const __m256i src = _mm256_permute4x64_epi64(_mm256_loadu_si256((const __m256i *)in), _MM_SHUFFLE(3, 1, 2, 0));
+		avx2_mix(out, avx2_scale(_mm256_unpacklo_epi16(src, src), vol), clamp);
+		avx2_mix(out + 16, avx2_scale(_mm256_unpackhi_epi16(src, src), vol), clamp);
+	}
+
+	for (; count > 0; --count, ++in, out += 2) {
+		RateConverterSIMD::mixSample(out[0], RateConverterSIMD::scaleSample(in[0], volL), clamp);
+		RateConverterSIMD::mixSample(out[1], RateConverterSIMD::scaleSample(in[0], volR), clamp);
+	}
+}
+
+template<typename T>
+static void interpolateStereoAVX2(T *out, const int16 *frames, frac_t pos, frac_t inc, int count, int volL, int volR, bool clamp) {
+	const __m256i volLeft = _mm256_set1_epi32(volL);
+	const __m256i volRight = _mm256_set1_epi32(volR);
+	const __m256i half = _mm256_set1_epi32(FRAC_HALF_LOW);
+	const __m256i fracMask = _mm256_set1_epi32(FRAC_ONE_LOW - 1);
+	const __m256i one = _mm256_set1_epi32(1);
+	const __m256i step = _mm256_set1_epi32(inc * 8);
+
+	__m256i p = _mm256_add_epi32(_mm256_set1_epi32(pos), _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(inc)));
+
+	for (; count >= 8; count -= 8, out += 16, pos += inc * 8) {
+		const __m256i idx = _mm256_srai_epi32(p, FRAC_BITS_LOW);
+		const __m256i f = _mm256_and_si256(p, fracMask);
+		const __m256i a = _mm256_i32gather_epi32((const int *)frames, idx, 4);
+		const __m256i b = _mm256_i32gather_epi32((const int *)frames, _mm256_add_epi32(idx, one), 4);
+
+		const __m256i aL = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+		const __m256i aR = _mm256_srai_epi32(a, 16);
+		const __m256i bL = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+		const __m256i bR = _mm256_srai_epi32(b, 16);
+
+		__m256i l = _mm256_add_epi32(aL, _mm256_srai_epi32(_mm256_add_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(bL, aL), f), half), FRAC_BITS_LOW));
+		__m256i r = _mm256_add_epi32(aR, _mm256_srai_epi32(_mm256_add_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(bR, aR), f), half), FRAC_BITS_LOW));
+
+		avx2_mix(out, avx2_scaleFrames(l, r, volLeft, volRight), clamp);
+
+		p = _mm256_add_epi32(p, step);
+	}
+
+	for (; count > 0; --count, out += 2, pos += inc) {
+		const int16 *frame = frames + (pos >> FRAC_BITS_LOW) * 2;
+		const frac_t f = pos & (FRAC_ONE_LOW - 1);
+		RateConverterSIMD::mixSample(out[0], RateConverterSIMD::scaleSample(RateConverterSIMD::interpolateSample(frame[0], frame[2], f), volL), clamp);
+		RateConverterSIMD::mixSample(out[1], RateConverterSIMD::scaleSample(RateConverterSIMD::interpolateSample(frame[1], frame[3], f), volR), clamp);
+	}
+}
+
+template<typename T>
+static void interpolateMonoAVX2(T *out, const int16 *frames, frac_t pos, frac_t inc, int count, int volL, int volR, bool clamp) {
+	const __m256i volLeft = _mm256_set1_epi32(volL);
+	const __m256i volRight = _mm256_set1_epi32(volR);
+	const __m256i half = _mm256_set1_epi32(FRAC_HALF_LOW);
+	const __m256i fracMask = _mm256_set1_epi32(FRAC_ONE_LOW - 1);
+	const __m256i step = _mm256_set1_epi32(inc * 8);
+
+	__m256i p = _mm256_add_epi32(_mm256_set1_epi32(pos), _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(inc)));
+
+	for (; count >= 8; count -= 8, out += 16, pos += inc * 8) {
+		// Gathering 32 bits at each sample yields the (last, cur) pairs at once
+		const __m256i idx = _mm256_srai_epi32(p, FRAC_BITS_LOW);
+		const __m256i f = _mm256_and_si256(p, fracMask);
+		const __m256i pair = _mm256_i32gather_epi32((const int *)frames, idx, 2);
+
+		const __m256i a = _mm256_srai_epi32(_mm256_slli_epi32(pair, 16), 16);
+		const __m256i b = _mm256_srai_epi32(pair, 16);
+		const __m256i val = _mm256_add_epi32(a, _mm256_srai_epi32(_mm256_add_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(b, a), f), half), FRAC_BITS_LOW));
+
+		avx2_mix(out, avx2_scaleFrames(val, val, volLeft, volRight), clamp);
+
+		p = _mm256_add_epi32(p, step);
+	}
+
+	for (; count > 0; --count, out += 2, pos += inc) {
+		const int16 *frame = frames + (pos >> FRAC_BITS_LOW);
+		const int val = RateConverterSIMD::interpolateSample(frame[0], frame[1], pos & (FRAC_ONE_LOW - 1));
+		RateConverterSIMD::mixSample(out[0], RateConverterSIMD::scaleSample(val, volL), clamp);
+		RateConverterSIMD::mixSample(out[1], RateConverterSIMD::scaleSample(val, volR), clamp);
+	}
+}
+
+static void mixStereo32AVX2(int32 *out, const int16 *in, int count, int volL, int volR) {
+	mixStereoAVX2(out, in, count, volL, volR, false);
+}
+
+static void mixMono32AVX2(int32 *out, const int16 *in, int count, int volL, int volR) {
+	mixMonoAVX2(out, in, count, volL, volR, false);
+}
+
+static void interpolateStereo32AVX2(int32 *out, const int16 *frames, frac_t pos, frac_t inc, int count, int volL, int volR) {
+	interpolateStereoAVX2(out, frames, pos, inc, count, volL, volR, false);
+}
+
+static void interpolateMono32AVX2(int32 *out, const int16 *frames, frac_t pos, frac_t inc, int count, int volL, int volR) {
+	interpolateMonoAVX2(out, frames, pos, inc, count, volL, volR, false);
+}
+
+const RateConverterSIMD::Kernels RateConverterSIMD::kernelsAVX2 = {
+	"AVX2",
+	mixStereoAVX2<int16>,
+	mixMonoAVX2<int16>,
+	interpolateStereoAVX2<int16>,
+	interpolateMonoAVX2<int16>,
+	mixStereo32AVX2,
+	mixMono32AVX2,
+	interpolateStereo32AVX2,
+	interpolateMono32AVX2
+};
+
+} // End of namespace Audio
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
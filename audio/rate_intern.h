@@ -0,0 +1,142 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_RATE_INTERN_H
+#define AUDIO_RATE_INTERN_H
+
+#include "audio/mixer.h"
+#include "audio/rate.h"
+
+namespace Audio {
+
+/**
+ * The default fractional type in frac.h (with 16 fractional bits) limits
+ * the rate conversion code to 65536Hz audio: we need to able to handle
+ * 192kHz audio, so we use fewer fractional bits in this code.
+ */
+enum {
+	FRAC_BITS_LOW = 14,
+	FRAC_ONE_LOW = (1L << FRAC_BITS_LOW),
+	FRAC_HALF_LOW = (1L << (FRAC_BITS_LOW-1))
+};
+
+/**
+ * Vectorized inner loops of the rate converter, for the common case of
+ * stereo output, either 16-bit or into the 32-bit mix bus. The kernels give
+ * bit-identical results to the generic code in rate.cpp.
+ */
+class RateConverterSIMD {
+public:
+	/**
+	 * Scale @p count input frames by the channel volumes and mix them into
+	 * the stereo output buffer, with or without clamping.
+	 */
+	typedef void (*MixFunc)(int16 *out, const int16 *in, int count, int volL, int volR, bool clamp);
+
+	/**
+	 * Linearly interpolate @p count output frames from the input @p frames
+	 * (interleaved stereo or mono, depending on the kernel), starting at the
+	 * fractional frame position @p pos and advancing by @p inc (both with
+	 * FRAC_BITS_LOW fractional bits), then scale and mix them like MixFunc.
+	 * The caller must ensure that ((pos + (count - 1) * inc) >> FRAC_BITS_LOW) + 1
+	 * is a valid frame index.
+	 */
+	typedef void (*InterpolateFunc)(int16 *out, const int16 *frames, frac_t pos, frac_t inc, int count, int volL, int volR, bool clamp);
+
+	/**
+	 * The same as MixFunc and InterpolateFunc, for the 32-bit mix bus. The
+	 * bus is only clamped once all channels have been added up, so these
+	 * never clamp.
+	 */
+	typedef void (*MixFunc32)(int32 *out, const int16 *in, int count, int volL, int volR);
+	typedef void (*InterpolateFunc32)(int32 *out, const int16 *frames, frac_t pos, frac_t inc, int count, int volL, int volR);
+
+	struct Kernels {
+		const char *name;
+		MixFunc mixStereo;       ///< Interleaved stereo input
+		MixFunc mixMono;         ///< Mono input, played on both channels
+		InterpolateFunc interpolateStereo;
+		/** Mono input, nullptr where this is not faster than the generic code. */
+		InterpolateFunc interpolateMono;
+
+		MixFunc32 mixStereo32;
+		MixFunc32 mixMono32;
+		InterpolateFunc32 interpolateStereo32;
+		InterpolateFunc32 interpolateMono32;
+	};
+
+	/**
+	 * Pick the kernels best suited for the host CPU, unless set() was called
+	 * before. The mixer calls this on construction, so that the kernels are
+	 * known before its thread starts creating rate converters.
+	 */
+	static void init();
+
+	/**
+	 * Return the kernels picked by init() or set(), or nullptr if there are
+	 * none.
+	 */
+	static const Kernels *get() { return _kernels; }
+
+	/**
+	 * Override the kernels used by newly created rate converters. Passing
+	 * nullptr makes them use the generic code.
+	 */
+	static void set(const Kernels *kernels);
+
+#ifdef SCUMMVM_NEON
+	static const Kernels kernelsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	static const Kernels kernelsSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+	static const Kernels kernelsAVX2;
+#endif
+
+	/**
+	 * Generic helpers used for the remainder which does not fill a whole
+	 * vector.
+	 */
+	static inline int scaleSample(int in, int vol) {
+		return (in * vol) / Mixer::kMaxMixerVolume;
+	}
+
+	static inline int interpolateSample(int last, int cur, frac_t frac) {
+		return (int16)(last + (((cur - last) * frac + FRAC_HALF_LOW) >> FRAC_BITS_LOW));
+	}
+
+	template<typename T>
+	static inline void mixSample(T &out, int val, bool clamp) {
+		if (clamp)
+			processSample<MIX_CLAMPED_ADD>(out, val);
+		else
+			processSample<MIX_ADD>(out, val);
+	}
+
+private:
+	static const Kernels *_kernels;
+	static bool _initialized;
+};
+
+} // End of namespace Audio
+
+#endif
@@ -0,0 +1,175 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "audio/rate_intern.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+namespace Audio {
+
+// Divides four products by kMaxMixerVolume, rounding towards zero like the
+// generic code does
+static inline int16x4_t neon_div(int32x4_t p) {
+	p = vaddq_s32(p, vandq_s32(vshrq_n_s32(p, 31), vdupq_n_s32(Mixer::kMaxMixerVolume - 1)));
+	return vshrn_n_s32(p, 8);
+}
+
+static inline int16x8_t neon_scale(int16x8_t in, int16x4_t vol) {
+	return vcombine_s16(neon_div(vmull_s16(vget_low_s16(in), vol)), neon_div(vmull_s16(vget_high_s16(in), vol)));
+}
+
+static inline void neon_mix(int16 *out, int16x8_t val, bool clamp) {
+	const int16x8_t dst = vld1q_s16(out);
+	vst1q_s16(out, clamp ? vqaddq_s16(dst, val) : vaddq_s16(dst, val));
+}
+
+// Widens the samples for the 32-bit mix bus, which is never clamped here
+static inline void neon_mix(int32 *out, int16x8_t val, bool clamp) {
+	vst1q_s32(out, vaddq_s32(vld1q_s32(out), vmovl_s16(vget_low_s16(val))));
+	vst1q_s32(out + 4, vaddq_s32(vld1q_s32(out + 4), vmovl_s16(vget_high_s16(val))));
+}
+
+static inline int16x4_t neon_volume(int volL, int volR) {
+	const int16 vol[4] = { (int16)volL, (int16)volR, (int16)volL, (int16)volR };
+	return vld1_s16(vol);
+}
+
+template<typename T>
+static void mixStereoNEON(T *out, const int16 *in, int count, int volL, int volR, bool clamp) {
+	const int16x4_t vol = neon_volume(volL, volR);
+
+	for (; count >= 4; count -= 4, in += 8, out += 8)
+		neon_mix(out, neon_scale(vld1q_s16(in), vol), clamp);
+
+	for (; count > 0; --count, in += 2, out += 2) {
+		RateConverterSIMD::mixSample(out[0], RateConverterSIMD::scaleSample(in[0], volL), clamp);
+		RateConverterSIMD::mixSample(out[1], RateConverterSIMD::scaleSample(in[1], volR), clamp);
+	}
+}
+
+template<typename T>
+static void mixMonoNEON(T *out, const int16 *in, int count, int volL, int volR, bool clamp) {
+	const int16x4_t vol = neon_volume(volL, volR);
+
+	for (; count >= 8; count -= 8, in += 8, out += 16) {
+		const int16x8_t src = vld1q_s16(in);
+		const int16x8x2_t dup = vzipq_s16(src, src);
+		neon_mix(out, neon_scale(dup.val[0], vol), clamp);
+		neon_mix(out + 8, neon_scale(dup.val[1], vol), clamp);
+	}
+
+	for (; count > 0; --count, ++in, out += 2) {
+		RateConverterSIMD::mixSample(out[0], RateConverterSIMD::scaleSample(in[0], volL), clamp);
+		RateConverterSIMD::mixSample(out[1], RateConverterSIMD::scaleSample(in[0], volR), clamp);
+	}
+}
+
+template<typename T>
+static void interpolateStereoNEON(T *out, const int16 *frames, frac_t pos, frac_t inc, int count, int volL, int volR, bool clamp) {
+	const int16x4_t vol = neon_volume(volL, volR);
+	const int32x4_t half = vdupq_n_s32(FRAC_HALF_LOW);
+
+	for (; count >= 4; count -= 4, out += 8) {
+		int16 last[8], cur[8], frac[8];
+		for (int i = 0; i < 4; ++i, pos += inc) {
+			const int16 *frame = frames + (pos >> FRAC_BITS_LOW) * 2;
+			last[i * 2] = frame[0];
+			last[i * 2 + 1] = frame[1];
+			cur[i * 2] = frame[2];
+			cur[i * 2 + 1] = frame[3];
+			frac[i * 2] = frac[i * 2 + 1] = pos & (FRAC_ONE_LOW - 1);
+		}
+
+		const int16x8_t a = vld1q_s16(last);
+		const int16x8_t b = vld1q_s16(cur);
+		const int16x8_t f = vld1q_s16(frac);
+
+		// cur * frac - last * frac, which is exact in 32 bits
+		int32x4_t lo = vmlsl_s16(vmull_s16(vget_low_s16(b), vget_low_s16(f)), vget_low_s16(a), vget_low_s16(f));
+		int32x4_t hi = vmlsl_s16(vmull_s16(vget_high_s16(b), vget_high_s16(f)), vget_high_s16(a), vget_high_s16(f));
+		lo = vaddq_s32(vmovl_s16(vget_low_s16(a)), vshrq_n_s32(vaddq_s32(lo, half), FRAC_BITS_LOW));
+		hi = vaddq_s32(vmovl_s16(vget_high_s16(a)), vshrq_n_s32(vaddq_s32(hi, half), FRAC_BITS_LOW));
+
+		neon_mix(out, neon_scale(vcombine_s16(vmovn_s32(lo), vmovn_s32(hi)), vol), clamp);
+	}
+
+	for (; count > 0; --count, out += 2, pos += inc) {
+		const int16 *frame = frames + (pos >> FRAC_BITS_LOW) * 2;
+		const frac_t f = pos & (FRAC_ONE_LOW - 1);
+		RateConverterSIMD::mixSample(out[0], RateConverterSIMD::scaleSample(RateConverterSIMD::interpolateSample(frame[0], frame[2], f), volL), clamp);
+		RateConverterSIMD::mixSample(out[1], RateConverterSIMD::scaleSample(RateConverterSIMD::interpolateSample(frame[1], frame[3], f), volR), clamp);
+	}
+}
+
+static void mixStereo32NEON(int32 *out, const int16 *in, int count, int volL, int volR) {
+	mixStereoNEON(out, in, count, volL, volR, false);
+}
+
+static void mixMono32NEON(int32 *out, const int16 *in, int count, int volL, int volR) {
+	mixMonoNEON(out, in, count, volL, volR, false);
+}
+
+static void interpolateStereo32NEON(int32 *out, const int16 *frames, frac_t pos, frac_t inc, int count, int volL, int volR) {
+	interpolateStereoNEON(out, frames, pos, inc, count, volL, volR, false);
+}
+
+// Mono input is interpolated by the generic code, since gathering the
+// samples has not been measured to be faster than that on NEON
+const RateConverterSIMD::Kernels RateConverterSIMD::kernelsNEON = {
+	"NEON",
+	mixStereoNEON<int16>,
+	mixMonoNEON<int16>,
+	interpolateStereoNEON<int16>,
+	nullptr,
+	mixStereo32NEON,
+	mixMono32NEON,
+	interpolateStereo32NEON,
+	nullptr
+};
+
+} // End of namespace Audio
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#endif // SCUMMVM_NEON
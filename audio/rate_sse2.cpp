@@ -0,0 +1,168 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "audio/rate_intern.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace Audio {
+
+// Computes (in * vol) / kMaxMixerVolume for eight samples, rounding towards
+// zero like the generic code does
+static FORCEINLINE __m128i sse2_scale(__m128i in, __m128i vol) {
+	const __m128i lo = _mm_mullo_epi16(in, vol);
+	const __m128i hi = _mm_mulhi_epi16(in, vol);
+	__m128i p0 = _mm_unpacklo_epi16(lo, hi);
+	__m128i p1 = _mm_unpackhi_epi16(lo, hi);
+	p0 = _mm_add_epi32(p0, _mm_and_si128(_mm_srai_epi32(p0, 31), _mm_set1_epi32(Mixer::kMaxMixerVolume - 1)));
+	p1 = _mm_add_epi32(p1, _mm_and_si128(_mm_srai_epi32(p1, 31), _mm_set1_epi32(Mixer::kMaxMixerVolume - 1)));
+	return _mm_packs_epi32(_mm_srai_epi32(p0, 8), _mm_srai_epi32(p1, 8));
+}
+
+static FORCEINLINE void sse2_mix(int16 *out, __m128i val, bool clamp) {
+	const __m128i dst = _mm_loadu_si128((const __m128i *)out);
+	_mm_storeu_si128((__m128i *)out, clamp ? _mm_adds_epi16(dst, val) : _mm_add_epi16(dst, val));
+}
+
+// Widens the samples for the 32-bit mix bus, which is never clamped here
+static FORCEINLINE void sse2_mix(int32 *out, __m128i val, bool clamp) {
+	const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(val, val), 16);
+	const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(val, val), 16);
+	_mm_storeu_si128((__m128i *)out, _mm_add_epi32(_mm_loadu_si128((const __m128i *)out), lo));
+	_mm_storeu_si128((__m128i *)(out + 4), _mm_add_epi32(_mm_loadu_si128((const __m128i *)(out + 4)), hi));
+}
+
+template<typename T>
+static void mixStereoSSE2(T *out, const int16 *in, int count, int volL, int volR, bool clamp) {
+	const __m128i vol = _mm_set1_epi32((volR << 16) | volL);
+
+	for (; count >= 4; count -= 4, in += 8, out += 8)
+		sse2_mix(out, sse2_scale(_mm_loadu_si128((const __m128i *)in), vol), clamp);
+
+	for (; count > 0; --count, in += 2, out += 2) {
+		RateConverterSIMD::mixSample(out[0], RateConverterSIMD::scaleSample(in[0], volL), clamp);
+		RateConverterSIMD::mixSample(out[1], RateConverterSIMD::scaleSample(in[1], volR), clamp);
+	}
+}
+
+template<typename T>
+static void mixMonoSSE2(T *out, const int16 *in, int count, int volL, int volR, bool clamp) {
+	const __m128i vol = _mm_set1_epi32((volR << 16) | volL);
+
+	for (; count >= 8; count -= 8, in += 8, out += 16) {
+		const __m128i src = _mm_loadu_si128((const __m128i *)in);
+		sse2_mix(out, sse2_scale(_mm_unpacklo_epi16(src, src), vol), clamp);
+		sse2_mix(out + 8, sse2_scale(_mm_unpackhi_epi16(src, src), vol), clamp);
+	}
+
+	for (; count > 0; --count, ++in, out += 2) {
+		RateConverterSIMD::mixSample(out[0], RateConverterSIMD::scaleSample(in[0], volL), clamp);
+		RateConverterSIMD::mixSample(out[1], RateConverterSIMD::scaleSample(in[0], volR), clamp);
+	}
+}
+
+template<typename T>
+static void interpolateStereoSSE2(T *out, const int16 *frames, frac_t pos, frac_t inc, int count, int volL, int volR, bool clamp) {
+	const __m128i vol = _mm_set1_epi32((volR << 16) | volL);
+	const __m128i half = _mm_set1_epi32(FRAC_HALF_LOW);
+
+	for (; count >= 4; count -= 4, out += 8) {
+		uint32 last[4], cur[4], frac[4];
+		for (int i = 0; i < 4; ++i, pos += inc) {
+			const int16 *frame = frames + (pos >> FRAC_BITS_LOW) * 2;
+			memcpy(&last[i], frame, sizeof(uint32));
+			memcpy(&cur[i], frame + 2, sizeof(uint32));
+			// Pairs of (frac, -frac), so that _mm_madd_epi16 yields cur * frac - last * frac
+			const uint16 f = pos & (FRAC_ONE_LOW - 1);
+			frac[i] = f | ((uint32)(uint16)-f << 16);
+		}
+
+		const __m128i a = _mm_set_epi32(last[3], last[2], last[1], last[0]);
+		const __m128i b = _mm_set_epi32(cur[3], cur[2], cur[1], cur[0]);
+		const __m128i f01 = _mm_set_epi32(frac[1], frac[1], frac[0], frac[0]);
+		const __m128i f23 = _mm_set_epi32(frac[3], frac[3], frac[2], frac[2]);
+
+		__m128i d01 = _mm_madd_epi16(_mm_unpacklo_epi16(b, a), f01);
+		__m128i d23 = _mm_madd_epi16(_mm_unpackhi_epi16(b, a), f23);
+		d01 = _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(d01, half), FRAC_BITS_LOW), _mm_srai_epi32(_mm_unpacklo_epi16(a, a), 16));
+		d23 = _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(d23, half), FRAC_BITS_LOW), _mm_srai_epi32(_mm_unpackhi_epi16(a, a), 16));
+
+		sse2_mix(out, sse2_scale(_mm_packs_epi32(d01, d23), vol), clamp);
+	}
+
+	for (; count > 0; --count, out += 2, pos += inc) {
+		const int16 *frame = frames + (pos >> FRAC_BITS_LOW) * 2;
+		const frac_t f = pos & (FRAC_ONE_LOW - 1);
+		RateConverterSIMD::mixSample(out[0], RateConverterSIMD::scaleSample(RateConverterSIMD::interpolateSample(frame[0], frame[2], f), volL), clamp);
+		RateConverterSIMD::mixSample(out[1], RateConverterSIMD::scaleSample(RateConverterSIMD::interpolateSample(frame[1], frame[3], f), volR), clamp);
+	}
+}
+
+static void mixStereo32SSE2(int32 *out, const int16 *in, int count, int volL, int volR) {
+	mixStereoSSE2(out, in, count, volL, volR, false);
+}
+
+static void mixMono32SSE2(int32 *out, const int16 *in, int count, int volL, int volR) {
+	mixMonoSSE2(out, in, count, volL, volR, false);
+}
+
+static void interpolateStereo32SSE2(int32 *out, const int16 *frames, frac_t pos, frac_t inc, int count, int volL, int volR) {
+	interpolateStereoSSE2(out, frames, pos, inc, count, volL, volR, false);
+}
+
+// Mono input is interpolated by the generic code: gathering the samples one
+// by one makes this slower than the scalar loop with SSE2
+const RateConverterSIMD::Kernels RateConverterSIMD::kernelsSSE2 = {
+	"SSE2",
+	mixStereoSSE2<int16>,
+	mixMonoSSE2<int16>,
+	interpolateStereoSSE2<int16>,
+	nullptr,
+	mixStereo32SSE2,
+	mixMono32SSE2,
+	interpolateStereo32SSE2,
+	nullptr
+};
+
+} // End of namespace Audio
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
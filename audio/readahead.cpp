@@ -0,0 +1,347 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "audio/readahead.h"
+
+#include "common/array.h"
+#include "common/mutex.h"
+#include "common/ptr.h"
+#include "common/singleton.h"
+#include "common/system.h"
+#include "common/timer.h"
+
+#ifndef NO_CXX11_ATOMIC
+#include <atomic>
+#endif
+
+namespace Audio {
+
+#ifndef NO_CXX11_ATOMIC
+
+/**
+ * The decoding side of a read-ahead stream. It outlives the stream and is
+ * freed by the filler, so that deleting the stream, which usually happens
+ * on the mixer thread, never has to wait for the decoder.
+ *
+ * Seeks are only requested by seek(). fill() carries them out and records
+ * the write position at which the new samples start. read() then jumps
+ * there, so each position is still only changed by one side.
+ */
+class ReadAheadBuffer {
+public:
+	ReadAheadBuffer(SeekableAudioStream *parent, uint32 size);
+	~ReadAheadBuffer() { delete[] _samples; }
+
+	int read(int16 *buffer, int numSamples);
+	bool endOfData() const;
+	void requestSeek(int frame);
+	void fill(uint32 maxSamples);
+
+	/** Set once the stream has been deleted. */
+	std::atomic<bool> released;
+
+	/**
+	 * Samples decoded per timer callback: twice the amount played in one
+	 * interval, so that the buffer catches up after a seek without a single
+	 * callback decoding all of it.
+	 */
+	const uint32 fillStep;
+
+private:
+	void fillBuffer(uint32 samples, uint32 maxSamples);
+
+	Common::ScopedPtr<SeekableAudioStream> _parent;
+	const int _rate;
+
+	/** Serializes fill(), which may be called directly besides the timer. */
+	Common::Mutex _decodeMutex;
+
+	int16 *_samples;
+	const uint32 _size; ///< Size of the ring buffer in samples, a power of two
+	std::atomic<uint32> _readPos;      ///< Only changed by read()
+	std::atomic<uint32> _writePos;     ///< Only changed by fill()
+	std::atomic<bool> _endOfParent;    ///< Only changed by fill()
+
+	std::atomic<int> _seekFrame;       ///< Target of the last requested seek
+	std::atomic<uint32> _seekRequest;  ///< Number of requested seeks
+	std::atomic<uint32> _seekApplied;  ///< Number of seeks carried out by fill()
+	std::atomic<uint32> _seekStart;    ///< Write position of the last seek carried out
+	std::atomic<uint32> _seekConsumed; ///< Last carried out seek read() has jumped to
+};
+
+ReadAheadBuffer::ReadAheadBuffer(SeekableAudioStream *parent, uint32 size)
+	: released(false), fillStep(MAX<uint32>(2, (parent->getRate() * (parent->isStereo() ? 2 : 1) / (500000 / ReadAheadAudioStream::kFillInterval)) & ~1)),
+	  _parent(parent), _rate(parent->getRate()), _decodeMutex(), _samples(new int16[size]), _size(size),
+	  _readPos(0), _writePos(0), _endOfParent(false),
+	  _seekFrame(0), _seekRequest(0), _seekApplied(0), _seekStart(0), _seekConsumed(0) {
+}
+
+int ReadAheadBuffer::read(int16 *buffer, int numSamples) {
+	// Play silence until a pending seek has been carried out, rather than
+	// the samples decoded before it
+	const uint32 applied = _seekApplied.load(std::memory_order_acquire);
+	if (_seekRequest.load(std::memory_order_acquire) != applied)
+		return 0;
+
+	uint32 read = _readPos.load(std::memory_order_relaxed);
+	if (_seekConsumed.load(std::memory_order_relaxed) != applied) {
+		read = _seekStart.load(std::memory_order_relaxed);
+		_seekConsumed.store(applied, std::memory_order_relaxed);
+	}
+
+	const uint32 write = _writePos.load(std::memory_order_acquire);
+	const uint32 samples = MIN<uint32>(numSamples, write - read);
+
+	const uint32 start = read & (_size - 1);
+	const uint32 first = MIN(samples, _size - start);
+	memcpy(buffer, _samples + start, first * sizeof(int16));
+	memcpy(buffer + first, _samples, (samples - first) * sizeof(int16));
+
+	_readPos.store(read + samples, std::memory_order_release);
+	return samples;
+}
+
+bool ReadAheadBuffer::endOfData() const {
+	const uint32 applied = _seekApplied.load(std::memory_order_acquire);
+	if (_seekRequest.load(std::memory_order_acquire) != applied)
+		return false;
+
+	// The end flag has to be checked first, since it is set after the last
+	// samples were written
+	if (!_endOfParent.load(std::memory_order_acquire))
+		return false;
+
+	uint32 read = _readPos.load(std::memory_order_relaxed);
+	if (_seekConsumed.load(std::memory_order_relaxed) != applied)
+		read = _seekStart.load(std::memory_order_relaxed);
+	return read == _writePos.load(std::memory_order_acquire);
+}
+
+void ReadAheadBuffer::requestSeek(int frame) {
+	_seekFrame.store(frame, std::memory_order_relaxed);
+	_seekRequest.fetch_add(1, std::memory_order_release);
+}
+
+void ReadAheadBuffer::fill(uint32 maxSamples) {
+	Common::StackLock lock(_decodeMutex);
+
+	const uint32 request = _seekRequest.load(std::memory_order_acquire);
+	if (request != _seekApplied.load(std::memory_order_relaxed)) {
+		if (!_parent->seek(Timestamp(0, _seekFrame.load(std::memory_order_relaxed), _rate)))
+			warning("ReadAheadAudioStream: Could not seek the parent stream");
+
+		// The samples decoded so far stay in the buffer until read() has
+		// skipped them, so that they are never overwritten while being read
+		_endOfParent.store(false, std::memory_order_relaxed);
+		_seekStart.store(_writePos.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		_seekApplied.store(request, std::memory_order_release);
+	}
+
+	fillBuffer(_size, maxSamples);
+}
+
+void ReadAheadBuffer::fillBuffer(uint32 samples, uint32 maxSamples) {
+	uint32 write = _writePos.load(std::memory_order_relaxed);
+	const uint32 end = write + maxSamples;
+
+	while (!_endOfParent.load(std::memory_order_relaxed) && write != end) {
+		if (_parent->endOfData()) {
+			_endOfParent.store(true, std::memory_order_release);
+			break;
+		}
+
+		const uint32 used = write - _readPos.load(std::memory_order_acquire);
+		if (used >= samples)
+			break;
+
+		// Positions stay even for stereo streams, since both the ring buffer
+		// size and the mixer's requests are even
+		const uint32 start = write & (_size - 1);
+		const int request = MIN(MIN(samples - used, _size - start), end - write);
+		const int decoded = _parent->readBuffer(_samples + start, request);
+		if (decoded > 0) {
+			write += decoded;
+			_writePos.store(write, std::memory_order_release);
+		}
+
+		// Try again on the next call if the decoder is not done yet
+		if (decoded < request) {
+			if (_parent->endOfData())
+				_endOfParent.store(true, std::memory_order_release);
+			break;
+		}
+	}
+}
+
+#pragma mark -
+
+/**
+ * Runs the timer callback which fills the buffers of all read-ahead
+ * streams, and frees the buffers of the streams which have been deleted.
+ */
+class ReadAheadFiller : public Common::Singleton<ReadAheadFiller> {
+public:
+	void add(ReadAheadBuffer *buffer);
+	void purge();
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+	ReadAheadFiller() : _timerInstalled(false) {}
+
+	static void timerProc(void *refCon);
+
+	/** Free the released buffers. Must be called with _bufferMutex held. */
+	void freeReleased();
+
+	/**
+	 * Serializes installing and removing the timer callback. The callback
+	 * itself runs with the timer manager's lock held and therefore must
+	 * never take this one.
+	 */
+	Common::Mutex _timerMutex;
+	bool _timerInstalled;
+	/** Protects the buffer list, held while the callback fills buffers. */
+	Common::Mutex _bufferMutex;
+	Common::Array<ReadAheadBuffer *> _buffers;
+};
+
+} // End of namespace Audio
+
+namespace Common {
+DECLARE_SINGLETON(Audio::ReadAheadFiller);
+}
+
+namespace Audio {
+
+void ReadAheadFiller::add(ReadAheadBuffer *buffer) {
+	Common::StackLock timerLock(_timerMutex);
+
+	{
+		Common::StackLock lock(_bufferMutex);
+		_buffers.push_back(buffer);
+	}
+
+	Common::TimerManager *timer = g_system->getTimerManager();
+	if (!_timerInstalled && timer)
+		_timerInstalled = timer->installTimerProc(&timerProc, ReadAheadAudioStream::kFillInterval, this, "audioReadAhead");
+}
+
+void ReadAheadFiller::purge() {
+	Common::StackLock timerLock(_timerMutex);
+
+	bool empty;
+	{
+		Common::StackLock lock(_bufferMutex);
+		freeReleased();
+		empty = _buffers.empty();
+	}
+
+	Common::TimerManager *timer = g_system->getTimerManager();
+	if (empty && _timerInstalled && timer) {
+		timer->removeTimerProc(&timerProc);
+		_timerInstalled = false;
+	}
+}
+
+void ReadAheadFiller::freeReleased() {
+	for (uint i = 0; i < _buffers.size();) {
+		if (_buffers[i]->released.load(std::memory_order_acquire)) {
+			delete _buffers[i];
+			_buffers.remove_at(i);
+		} else {
+			++i;
+		}
+	}
+}
+
+void ReadAheadFiller::timerProc(void *refCon) {
+	ReadAheadFiller *filler = (ReadAheadFiller *)refCon;
+	Common::StackLock lock(filler->_bufferMutex);
+
+	// This runs with the timer manager's lock held, so only decode a bit of
+	// every stream per call
+	filler->freeReleased();
+	for (uint i = 0; i < filler->_buffers.size(); ++i)
+		filler->_buffers[i]->fill(filler->_buffers[i]->fillStep);
+}
+
+#pragma mark -
+
+ReadAheadAudioStream::ReadAheadAudioStream(SeekableAudioStream *parent, uint bufferMs)
+	: _stereo(parent->isStereo()), _rate(parent->getRate()), _length(parent->getLength()), _buffer(nullptr) {
+
+	const uint32 samples = (uint32)_rate * (_stereo ? 2 : 1) * bufferMs / 1000;
+	uint32 size = 2;
+	while (size < samples)
+		size <<= 1;
+
+	_buffer = new ReadAheadBuffer(parent, size);
+	_buffer->fill(size);
+	ReadAheadFiller::instance().add(_buffer);
+}
+
+ReadAheadAudioStream::~ReadAheadAudioStream() {
+	// The buffer is freed by the filler, so this never waits for the decoder
+	_buffer->released.store(true, std::memory_order_release);
+}
+
+int ReadAheadAudioStream::readBuffer(int16 *buffer, const int numSamples) {
+	return _buffer->read(buffer, numSamples);
+}
+
+bool ReadAheadAudioStream::endOfData() const {
+	return _buffer->endOfData();
+}
+
+bool ReadAheadAudioStream::seek(const Timestamp &where) {
+	const Timestamp frame = where.convertToFramerate(_rate);
+	if (_length.totalNumberOfFrames() != 0 && frame > _length)
+		return false;
+
+	_buffer->requestSeek(frame.totalNumberOfFrames());
+	return true;
+}
+
+void ReadAheadAudioStream::fill(uint32 maxSamples) {
+	_buffer->fill(maxSamples);
+}
+
+#endif
+
+SeekableAudioStream *makeReadAheadStream(SeekableAudioStream *stream, uint bufferMs) {
+	if (!stream)
+		return nullptr;
+
+#ifndef NO_CXX11_ATOMIC
+	return new ReadAheadAudioStream(stream, bufferMs);
+#else
+	return stream;
+#endif
+}
+
+void purgeReadAheadStreams() {
+#ifndef NO_CXX11_ATOMIC
+	if (ReadAheadFiller::hasInstance())
+		ReadAheadFiller::instance().purge();
+#endif
+}
+
+} // End of namespace Audio
@@ -0,0 +1,142 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef AUDIO_READAHEAD_H
+#define AUDIO_READAHEAD_H
+
+#include "audio/audiostream.h"
+
+namespace Audio {
+
+/**
+ * @defgroup audio_readahead Read-ahead audio streams
+ * @ingroup audio
+ *
+ * @brief Decoding of audio streams ahead of the mixer.
+ * @{
+ */
+
+#ifndef NO_CXX11_ATOMIC
+
+class ReadAheadBuffer;
+
+/**
+ * A stream which decodes its parent stream ahead of playback into a ring
+ * buffer, so that the mixer only copies samples and is never held up by a
+ * slow decoder or slow storage.
+ *
+ * The ring buffer is filled from a timer callback installed with the
+ * backend's TimerManager, which decodes a few milliseconds of every stream
+ * per call so that other timers are not held up. The mixer and the timer
+ * callback do not share a lock, so a stream which is starved returns fewer
+ * samples than requested instead of blocking the mixer; the missing samples
+ * are played as silence. Neither seeking nor deleting the stream waits for
+ * the decoder: seeks are carried out by the timer callback, which also frees
+ * the parent stream once the read-ahead stream has been deleted.
+ *
+ * The parent stream must not be accessed by anything else while it is
+ * wrapped, and it must not share a file handle with streams which are
+ * played without read-ahead.
+ */
+class ReadAheadAudioStream : public SeekableAudioStream {
+public:
+	enum {
+		/** Default amount of audio decoded ahead of playback, in milliseconds. */
+		kDefaultBufferMs = 500,
+		/** Interval of the timer callback filling the buffers, in microseconds. */
+		kFillInterval = 10000
+	};
+
+	/**
+	 * Create a new read-ahead stream. The buffer is filled right away, so
+	 * the stream can be played without a delay.
+	 *
+	 * @param parent    The stream to decode ahead. It is deleted after the
+	 *                  read-ahead stream, by the timer callback or by
+	 *                  purgeReadAheadStreams().
+	 * @param bufferMs  Amount of audio to decode ahead, in milliseconds.
+	 */
+	ReadAheadAudioStream(SeekableAudioStream *parent, uint bufferMs = kDefaultBufferMs);
+	~ReadAheadAudioStream() override;
+
+	int readBuffer(int16 *buffer, const int numSamples) override;
+
+	bool isStereo() const override { return _stereo; }
+	int getRate() const override { return _rate; }
+
+	bool endOfData() const override;
+	bool endOfStream() const override { return endOfData(); }
+
+	/**
+	 * Request the parent stream to be seeked. This returns right away; the
+	 * decoded samples are discarded and the stream plays silence until the
+	 * next fill() has carried out the seek.
+	 */
+	bool seek(const Timestamp &where) override;
+	Timestamp getLength() const override { return _length; }
+
+	/**
+	 * Carry out a pending seek, then decode from the parent stream until the
+	 * buffer is full, the parent stream ends or @p maxSamples samples have
+	 * been decoded. The timer callback calls this with a small limit, but it
+	 * can also be called directly, e.g. when no timer is running.
+	 */
+	void fill(uint32 maxSamples = 0xFFFFFFFF);
+
+private:
+	const bool _stereo;
+	const int _rate;
+	const Timestamp _length;
+
+	/** Owned by the timer callback once this stream is deleted. */
+	ReadAheadBuffer *_buffer;
+};
+
+#endif
+
+/**
+ * Wrap a stream so that it is decoded ahead of playback.
+ *
+ * This is meant for long compressed streams like music tracks, which
+ * otherwise may cause dropouts when decoding takes longer than the mixer
+ * can wait. If read-ahead is not available on the platform, @p stream is
+ * returned unchanged.
+ *
+ * @param stream    The stream to decode ahead (will be deleted together
+ *                  with the returned stream).
+ * @param bufferMs  Amount of audio to decode ahead, in milliseconds.
+ *
+ * @return A stream playing @p stream, or nullptr if @p stream was nullptr.
+ */
+SeekableAudioStream *makeReadAheadStream(SeekableAudioStream *stream, uint bufferMs = 500);
+
+/**
+ * Free the parent streams of all read-ahead streams which have been deleted,
+ * and stop the timer callback if no read-ahead streams remain. This is done
+ * when an engine is destroyed; it must not be called from the mixer thread,
+ * since it waits for the timer callback.
+ */
+void purgeReadAheadStreams();
+
+/** @} */
+} // End of namespace Audio
+
+#endif
@@ -33,6 +33,7 @@
 
 #include "backends/fs/posix/posix-fs.h"
 #include "backends/fs/posix/posix-iostream.h"
+#include "backends/fs/posix/posix-mappedstream.h"
 #include "common/algorithm.h"
 
 #include <sys/param.h>
@@ -279,6 +280,20 @@ Common::SeekableReadStream *POSIXFilesystemNode::createReadStream() {
 	return PosixIoStream::makeFromPath(getPath(), StdioStream::WriteMode_Read);
 }
 
+Common::SeekableReadStream *POSIXFilesystemNode::createMappedReadStream() {
+#if defined(POSIX) && defined(HAS_MMAP)
+	// Large game data files are mapped into memory, which saves the stdio
+	// buffer copies and system calls when engines seek around in them.
+	// Files which may be truncated while open, like savegames, must not
+	// come through here: accessing the lost pages would raise SIGBUS.
+	Common::SeekableReadStream *stream = PosixMappedReadStream::makeFromPath(getPath());
+	if (stream)
+		return stream;
+#endif
+
+	return createReadStream();
+}
+
 Common::SeekableReadStream *POSIXFilesystemNode::createReadStreamForAltStream(Common::AltStreamType altStreamType) {
 #ifdef MACOSX
 	if (altStreamType == Common::AltStreamType::MacResourceFork) {
@@ -0,0 +1,59 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#ifndef BACKENDS_FS_POSIX_POSIXMAPPEDSTREAM_H
+#define BACKENDS_FS_POSIX_POSIXMAPPEDSTREAM_H
+
+#include "common/memstream.h"
+
+/**
+ * A read stream for a file which is mapped into memory with mmap().
+ *
+ * Reading and seeking does not involve any system calls or copies into a
+ * stdio buffer, and the pages are shared with the page cache.
+ */
+class PosixMappedReadStream final : public Common::MemoryReadStream {
+public:
+	enum {
+		/** Files smaller than this are read with stdio instead. */
+		kMinMappedSize = 256 * 1024
+	};
+
+	/**
+	 * Map the given file into memory.
+	 *
+	 * @return The new stream, or nullptr if the file is not a regular file
+	 *         of at least kMinMappedSize bytes or cannot be mapped. The
+	 *         caller is expected to fall back to PosixIoStream then.
+	 */
+	static PosixMappedReadStream *makeFromPath(const Common::String &path);
+
+	~PosixMappedReadStream() override;
+
+private:
+	PosixMappedReadStream(void *data, uint32 size);
+
+	void *_data;
+	uint32 _mappedSize;
+};
+
+#endif
@@ -787,6 +787,11 @@ void OpenGLGraphicsManager::updateScreen() {
 	}
 	_overlay->updateGLTexture();
 
+	const uint gameScreenPixels = _gameScreen ? _gameScreen->getUpdatedPixels() : 0;
+	if (gameScreenPixels || _overlay->getUpdatedPixels()) {
+		debug(9, "OpenGL: Updated %u game screen and %u overlay pixels", gameScreenPixels, _overlay->getUpdatedPixels());
+	}
+
 #if !USE_FORCED_GLES
 	if (_libretroPipeline) {
 		_libretroPipeline->beginScaling();
@@ -43,8 +43,18 @@ namespace OpenGL {
 // Surface
 //
 
+namespace {
+enum {
+	// Bounding boxes of dirty areas are used as long as they only cover
+	// this many clean pixels. This avoids an upload per tiny rect.
+	kDirtyRectMaxWaste = 4096,
+	// Beyond this, every new area is merged into the closest one
+	kMaxDirtyRects = 16
+};
+} // End of anonymous namespace
+
 Surface::Surface()
-	: _allDirty(false), _dirtyArea() {
+	: _updatedPixels(0), _allDirty(false), _dirtyRects() {
 }
 
 void Surface::copyRectToTexture(uint x, uint y, uint w, uint h, const void *srcPtr, uint srcPitch) {
@@ -85,22 +95,21 @@ void Surface::fill(const Common::Rect &r, uint32 color) {
 }
 
 void Surface::addDirtyArea(const Common::Rect &r) {
-	// *sigh* Common::Rect::extend behaves unexpected whenever one of the two
-	// parameters is an empty rect. Thus, we check whether the current dirty
-	// area is valid. In case it is not we simply use the parameters as new
-	// dirty area. Otherwise, we simply call extend.
-	if (_dirtyArea.isEmpty()) {
-		_dirtyArea = r;
-	} else {
-		_dirtyArea.extend(r);
+	// Everything is updated anyway
+	if (_allDirty) {
+		return;
 	}
+
+	_dirtyRects.addCoalesced(r, kDirtyRectMaxWaste, kMaxDirtyRects);
 }
 
-Common::Rect Surface::getDirtyArea() const {
+Graphics::DirtyRectList Surface::getDirtyRects() const {
 	if (_allDirty) {
-		return Common::Rect(getWidth(), getHeight());
+		Graphics::DirtyRectList dirtyRects;
+		dirtyRects.push_back(Common::Rect(getWidth(), getHeight()));
+		return dirtyRects;
 	} else {
-		return _dirtyArea;
+		return _dirtyRects;
 	}
 }
 
@@ -161,13 +170,20 @@ void TextureSurface::allocate(uint width, uint height) {
 }
 
 void TextureSurface::updateGLTexture() {
+	_updatedPixels = 0;
 	if (!isDirty()) {
 		return;
 	}
 
-	Common::Rect dirtyArea = getDirtyArea();
+	const Graphics::DirtyRectList dirtyRects = getDirtyRects();
+
+	for (Graphics::DirtyRectList::const_iterator i = dirtyRects.begin(); i != dirtyRects.end(); ++i) {
+		Common::Rect dirtyArea = *i;
+		updateGLTexture(dirtyArea);
+	}
 
-	updateGLTexture(dirtyArea);
+	// We should have handled everything, thus not dirty anymore.
+	clearDirty();
 }
 
 void TextureSurface::updateGLTexture(Common::Rect &dirtyArea) {
@@ -201,9 +217,7 @@ void TextureSurface::updateGLTexture(Common::Rect &dirtyArea) {
 	}
 
 	_glTexture.updateArea(dirtyArea, _textureData);
-
-	// We should have handled everything, thus not dirty anymore.
-	clearDirty();
+	_updatedPixels += dirtyArea.width() * dirtyArea.height();
 }
 
 FakeTextureSurface::FakeTextureSurface(GLenum glIntFormat, GLenum glFormat, GLenum glType, const Graphics::PixelFormat &format, const Graphics::PixelFormat &fakeFormat)
@@ -281,6 +295,7 @@ void FakeTextureSurface::setPalette(uint start, uint colors, const byte *palData
 }
 
 void FakeTextureSurface::updateGLTexture() {
+	_updatedPixels = 0;
 	if (!isDirty()) {
 		return;
 	}
@@ -288,15 +303,21 @@ void FakeTextureSurface::updateGLTexture() {
 	// Convert color space.
 	Graphics::Surface *outSurf = TextureSurface::getSurface();
 
-	const Common::Rect dirtyArea = getDirtyArea();
+	const Graphics::DirtyRectList dirtyRects = getDirtyRects();
+
+	for (Graphics::DirtyRectList::const_iterator i = dirtyRects.begin(); i != dirtyRects.end(); ++i) {
+		Common::Rect dirtyArea = *i;
 
-	byte *dst = (byte *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
-	const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
+		byte *dst = (byte *)outSurf->getBasePtr(dirtyArea.left, dirtyArea.top);
+		const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
 
-	applyPaletteAndMask(dst, src, outSurf->pitch, _rgbData.pitch, _rgbData.w, dirtyArea, outSurf->format, _rgbData.format);
+		applyPaletteAndMask(dst, src, outSurf->pitch, _rgbData.pitch, _rgbData.w, dirtyArea, outSurf->format, _rgbData.format);
 
-	// Do generic handling of updating the texture.
-	TextureSurface::updateGLTexture();
+		// Do generic handling of updating the texture.
+		TextureSurface::updateGLTexture(dirtyArea);
+	}
+
+	clearDirty();
 }
 
 void FakeTextureSurface::applyPaletteAndMask(byte *dst, const byte *src, uint dstPitch, uint srcPitch, uint srcWidth, const Common::Rect &dirtyArea, const Graphics::PixelFormat &dstFormat, const Graphics::PixelFormat &srcFormat) const {
@@ -372,6 +393,7 @@ void ScaledTextureSurface::allocate(uint width, uint height) {
 }
 
 void ScaledTextureSurface::updateGLTexture() {
+	_updatedPixels = 0;
 	if (!isDirty()) {
 		return;
 	}
@@ -379,46 +401,52 @@ void ScaledTextureSurface::updateGLTexture() {
 	// Convert color space.
 	Graphics::Surface *outSurf = TextureSurface::getSurface();
 
-	Common::Rect dirtyArea = getDirtyArea();
+	const Graphics::DirtyRectList dirtyRects = getDirtyRects();
 
-	// Extend the dirty region for scalers
-	// that "smear" the screen, e.g. 2xSAI
-	dirtyArea.grow(_extraPixels);
-	dirtyArea.clip(Common::Rect(0, 0, _rgbData.w, _rgbData.h));
+	for (Graphics::DirtyRectList::const_iterator i = dirtyRects.begin(); i != dirtyRects.end(); ++i) {
+		Common::Rect dirtyArea = *i;
 
-	const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
-	uint srcPitch = _rgbData.pitch;
-	byte *dst;
-	uint dstPitch;
+		// Extend the dirty region for scalers
+		// that "smear" the screen, e.g. 2xSAI
+		dirtyArea.grow(_extraPixels);
+		dirtyArea.clip(Common::Rect(0, 0, _rgbData.w, _rgbData.h));
 
-	if (_convData) {
-		dst = (byte *)_convData->getBasePtr(dirtyArea.left + _extraPixels, dirtyArea.top + _extraPixels);
-		dstPitch = _convData->pitch;
+		const byte *src = (const byte *)_rgbData.getBasePtr(dirtyArea.left, dirtyArea.top);
+		uint srcPitch = _rgbData.pitch;
+		byte *dst;
+		uint dstPitch;
 
-		applyPaletteAndMask(dst, src, dstPitch, srcPitch, _rgbData.w, dirtyArea, _convData->format, _rgbData.format);
+		if (_convData) {
+			dst = (byte *)_convData->getBasePtr(dirtyArea.left + _extraPixels, dirtyArea.top + _extraPixels);
+			dstPitch = _convData->pitch;
 
-		src = dst;
-		srcPitch = dstPitch;
-	}
+			applyPaletteAndMask(dst, src, dstPitch, srcPitch, _rgbData.w, dirtyArea, _convData->format, _rgbData.format);
 
-	dst = (byte *)outSurf->getBasePtr(dirtyArea.left * _scaleFactor, dirtyArea.top * _scaleFactor);
-	dstPitch = outSurf->pitch;
+			src = dst;
+			srcPitch = dstPitch;
+		}
 
-	if (_scaler && (uint)dirtyArea.height() >= _extraPixels) {
-		_scaler->scale(src, srcPitch, dst, dstPitch, dirtyArea.width(), dirtyArea.height(), dirtyArea.left, dirtyArea.top);
-	} else {
-		Graphics::scaleBlit(dst, src, dstPitch, srcPitch,
-		                    dirtyArea.width() * _scaleFactor, dirtyArea.height() * _scaleFactor,
-		                    dirtyArea.width(), dirtyArea.height(), outSurf->format);
-	}
+		dst = (byte *)outSurf->getBasePtr(dirtyArea.left * _scaleFactor, dirtyArea.top * _scaleFactor);
+		dstPitch = outSurf->pitch;
 
-	dirtyArea.left   *= _scaleFactor;
-	dirtyArea.right  *= _scaleFactor;
-	dirtyArea.top    *= _scaleFactor;
-	dirtyArea.bottom *= _scaleFactor;
+		if (_scaler && (uint)dirtyArea.height() >= _extraPixels) {
+			_scaler->scale(src, srcPitch, dst, dstPitch, dirtyArea.width(), dirtyArea.height(), dirtyArea.left, dirtyArea.top);
+		} else {
+			Graphics::scaleBlit(dst, src, dstPitch, srcPitch,
+			                    dirtyArea.width() * _scaleFactor, dirtyArea.height() * _scaleFactor,
+			                    dirtyArea.width(), dirtyArea.height(), outSurf->format);
+		}
+
+		dirtyArea.left   *= _scaleFactor;
+		dirtyArea.right  *= _scaleFactor;
+		dirtyArea.top    *= _scaleFactor;
+		dirtyArea.bottom *= _scaleFactor;
+
+		// Do generic handling of updating the texture.
+		TextureSurface::updateGLTexture(dirtyArea);
+	}
 
-	// Do generic handling of updating the texture.
-	TextureSurface::updateGLTexture(dirtyArea);
+	clearDirty();
 }
 
 void ScaledTextureSurface::setScaler(uint scalerIndex, int scaleFactor) {
@@ -581,8 +609,13 @@ void TextureSurfaceCLUT8GPU::updateGLTexture() {
 	const bool needLookUp = Surface::isDirty() || _paletteDirty;
 
 	// Update CLUT8 texture if necessary.
+	_updatedPixels = 0;
 	if (Surface::isDirty()) {
-		_clut8Texture.updateArea(getDirtyArea(), _clut8Data);
+		const Graphics::DirtyRectList dirtyRects = getDirtyRects();
+		for (Graphics::DirtyRectList::const_iterator i = dirtyRects.begin(); i != dirtyRects.end(); ++i) {
+			_clut8Texture.updateArea(*i, _clut8Data);
+			_updatedPixels += i->width() * i->height();
+		}
 		clearDirty();
 	}
 
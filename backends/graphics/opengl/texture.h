@@ -29,6 +29,7 @@
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 #include "graphics/blit.h"
+#include "graphics/dirtyrects.h"
 
 #include "common/rect.h"
 #include "common/rotationmode.h"
@@ -108,7 +109,7 @@ public:
 	void fill(const Common::Rect &r, uint32 color);
 
 	void flagDirty() { _allDirty = true; }
-	virtual bool isDirty() const { return _allDirty || !_dirtyArea.isEmpty(); }
+	virtual bool isDirty() const { return _allDirty || !_dirtyRects.empty(); }
 
 	virtual uint getWidth() const = 0;
 	virtual uint getHeight() const = 0;
@@ -147,14 +148,27 @@ public:
 	 * Obtain underlying OpenGL texture.
 	 */
 	virtual const Texture &getGLTexture() const = 0;
+
+	/**
+	 * @return The number of pixels which the last call to updateGLTexture
+	 *         converted and uploaded.
+	 */
+	uint getUpdatedPixels() const { return _updatedPixels; }
 protected:
-	void clearDirty() { _allDirty = false; _dirtyArea = Common::Rect(); }
+	void clearDirty() { _allDirty = false; _dirtyRects.clear(); }
 
 	void addDirtyArea(const Common::Rect &r);
-	Common::Rect getDirtyArea() const;
+
+	/**
+	 * @return The areas which changed since the last update. Areas which
+	 *         are close to each other are merged into one.
+	 */
+	Graphics::DirtyRectList getDirtyRects() const;
+
+	uint _updatedPixels;
 private:
 	bool _allDirty;
-	Common::Rect _dirtyArea;
+	Graphics::DirtyRectList _dirtyRects;
 };
 
 /**
@@ -0,0 +1,124 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#if defined(SDL_BACKEND)
+
+#include "backends/graphics/sdl/sdl-scalerpool.h"
+#include "common/textconsole.h"
+
+#if SDL_VERSION_ATLEAST(3, 0, 0)
+#define SDL_CreateCond SDL_CreateCondition
+#define SDL_DestroyCond SDL_DestroyCondition
+#define SDL_CondWait SDL_WaitCondition
+#define SDL_CondBroadcast SDL_BroadcastCondition
+#endif
+
+SdlScalerWorkerPool::SdlScalerWorkerPool(uint threads) :
+		_job(nullptr), _data(nullptr), _count(0), _next(0), _finished(0),
+		_generation(0), _quit(false) {
+	_mutex = SDL_CreateMutex();
+	_start = SDL_CreateCond();
+	_done = SDL_CreateCond();
+
+	for (uint i = 0; i < threads; ++i) {
+#if SDL_VERSION_ATLEAST(2, 0, 0)
+		SDL_Thread *thread = SDL_CreateThread(&threadProc, "ScummVM scaler", this);
+#else
+		SDL_Thread *thread = SDL_CreateThread(&threadProc, this);
+#endif
+		if (!thread) {
+			warning("Could not create scaler thread: %s", SDL_GetError());
+			break;
+		}
+		_threads.push_back(thread);
+	}
+}
+
+SdlScalerWorkerPool::~SdlScalerWorkerPool() {
+	SDL_LockMutex(_mutex);
+	_quit = true;
+	SDL_CondBroadcast(_start);
+	SDL_UnlockMutex(_mutex);
+
+	for (uint i = 0; i < _threads.size(); ++i)
+		SDL_WaitThread(_threads[i], nullptr);
+
+	SDL_DestroyCond(_done);
+	SDL_DestroyCond(_start);
+	SDL_DestroyMutex(_mutex);
+}
+
+void SdlScalerWorkerPool::run(JobFunc job, void *data, uint count) {
+	if (!count)
+		return;
+
+	SDL_LockMutex(_mutex);
+	_job = job;
+	_data = data;
+	_count = count;
+	_next = 0;
+	_finished = 0;
+	_generation++;
+	SDL_CondBroadcast(_start);
+
+	runJobs();
+	while (_finished < _count)
+		SDL_CondWait(_done, _mutex);
+	SDL_UnlockMutex(_mutex);
+}
+
+void SdlScalerWorkerPool::runJobs() {
+	while (_next < _count) {
+		JobFunc job = _job;
+		void *data = _data;
+		uint index = _next++;
+
+		SDL_UnlockMutex(_mutex);
+		job(data, index);
+		SDL_LockMutex(_mutex);
+
+		if (++_finished == _count)
+			SDL_CondBroadcast(_done);
+	}
+}
+
+int SDLCALL SdlScalerWorkerPool::threadProc(void *data) {
+	SdlScalerWorkerPool *pool = (SdlScalerWorkerPool *)data;
+
+	SDL_LockMutex(pool->_mutex);
+	uint32 generation = pool->_generation;
+	while (true) {
+		while (!pool->_quit && pool->_generation == generation)
+			SDL_CondWait(pool->_start, pool->_mutex);
+		if (pool->_quit)
+			break;
+
+		generation = pool->_generation;
+		pool->runJobs();
+	}
+	SDL_UnlockMutex(pool->_mutex);
+
+	return 0;
+}
+
+#endif
@@ -0,0 +1,66 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef BACKENDS_GRAPHICS_SDL_SCALERPOOL_H
+#define BACKENDS_GRAPHICS_SDL_SCALERPOOL_H
+
+#include "graphics/scalerplugin.h"
+#include "common/array.h"
+
+#include "backends/platform/sdl/sdl-sys.h"
+
+/**
+ * Scaler worker pool running the bands of large rects on SDL threads.
+ *
+ * The thread calling run() takes part in the work, so a pool with N threads
+ * scales up to N + 1 bands at the same time.
+ */
+class SdlScalerWorkerPool final : public ScalerWorkerPool {
+public:
+	explicit SdlScalerWorkerPool(uint threads);
+	~SdlScalerWorkerPool() override;
+
+	uint getConcurrency() const override { return _threads.size() + 1; }
+	void run(JobFunc job, void *data, uint count) override;
+
+private:
+	static int SDLCALL threadProc(void *pool);
+
+	/** Run the jobs which have not been started yet. Needs _mutex to be locked. */
+	void runJobs();
+
+	Common::Array<SDL_Thread *> _threads;
+#if SDL_VERSION_ATLEAST(3, 0, 0)
+	SDL_Mutex *_mutex;
+	SDL_Condition *_start, *_done;
+#else
+	SDL_mutex *_mutex;
+	SDL_cond *_start, *_done;
+#endif
+
+	JobFunc _job;
+	void *_data;
+	uint _count, _next, _finished;
+	uint32 _generation;
+	bool _quit;
+};
+
+#endif
@@ -35,6 +35,7 @@
 #include "common/list.h"
 #endif
 #include "graphics/blit.h"
+#include "graphics/dirtyrects.h"
 #include "graphics/font.h"
 #include "graphics/fontman.h"
 #include "graphics/scaler.h"
@@ -191,8 +192,9 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 	_enableFocusRectDebugCode(false), _enableFocusRect(false), _focusRect(),
 #endif
 	_transactionMode(kTransactionNone),
-	_scalerPlugins(ScalerMan.getPlugins()), _scalerPlugin(nullptr), _scaler(nullptr),
+	_scalerPlugins(ScalerMan.getPlugins()), _scalerPlugin(nullptr), _scaler(nullptr), _scalerPool(nullptr),
 	_needRestoreAfterOverlay(false), _isInOverlayPalette(false), _isDoubleBuf(false), _prevForceRedraw(false), _numPrevDirtyRects(0),
+	_frameDiff(false), _scaledPixels(0),
 	_prevCursorNeedsRedraw(false),
 	_mouseKeyColor(0), _disableMouseKeyColor(false) {
 
@@ -214,6 +216,9 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 	_mouseLastRect.x = _mouseLastRect.y = _mouseLastRect.w = _mouseLastRect.h = 0;
 	_mouseNextRect.x = _mouseNextRect.y = _mouseNextRect.w = _mouseNextRect.h = 0;
 
+	if (ConfMan.hasKey("frame_diff"))
+		_frameDiff = ConfMan.getBool("frame_diff");
+
 #ifdef USE_SDL_DEBUG_FOCUSRECT
 	if (ConfMan.hasKey("use_sdl_debug_focusrect"))
 		_enableFocusRectDebugCode = ConfMan.getBool("use_sdl_debug_focusrect");
@@ -229,6 +234,15 @@ SurfaceSdlGraphicsManager::SurfaceSdlGraphicsManager(SdlEventSource *sdlEventSou
 	_scaler = nullptr;
 	_maxExtraPixels = ScalerMan.getMaxExtraPixels();
 
+	// Scale large rects in bands on several threads at the same time
+	if (ConfMan.hasKey("scaler_threads")) {
+		int threads = ConfMan.getInt("scaler_threads");
+		if (threads > 1) {
+			_scalerPool = new SdlScalerWorkerPool(MIN(threads, 16) - 1);
+			Scaler::setWorkerPool(_scalerPool);
+		}
+	}
+
 	_videoMode.fullscreen = ConfMan.getBool("fullscreen");
 	_videoMode.filtering = ConfMan.getBool("filtering");
 #if SDL_VERSION_ATLEAST(2, 0, 0)
@@ -244,6 +258,10 @@ SurfaceSdlGraphicsManager::~SurfaceSdlGraphicsManager() {
 	unloadGFXMode();
 	delete _scaler;
 	delete _mouseScaler;
+	if (_scalerPool) {
+		Scaler::setWorkerPool(nullptr);
+		delete _scalerPool;
+	}
 	if (_mouseOrigSurface) {
 		destroySurface(_mouseOrigSurface);
 		if (_mouseOrigSurface == _mouseSurface) {
@@ -1360,6 +1378,8 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 		_dirtyRectList[0].h = height;
 	}
 
+	_scaledPixels = 0;
+
 	_prevForceRedraw = _forceRedraw;
 	if (!_prevForceRedraw && _numDirtyRects && _isDoubleBuf) {
 		memcpy(_prevDirtyRectList, _dirtyRectList, _numDirtyRects * sizeof(_dirtyRectList[0]));
@@ -1445,6 +1465,7 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 
 				_scaler->scale((byte *)srcSurf->pixels + (src_x + _maxExtraPixels) * bpp + (src_y + _maxExtraPixels) * srcPitch, srcPitch,
 						(byte *)_hwScreen->pixels + dst_x * bpp + dst_y * dstPitch, dstPitch, dst_w, dst_h, src_x, src_y);
+				_scaledPixels += dst_w * dst_h;
 
 				r->x = dst_x;
 				r->y = dst_y;
@@ -1577,6 +1598,9 @@ void SurfaceSdlGraphicsManager::internUpdateScreen() {
 	if (_scaler)
 		_scaler->setFactor(oldScaleFactor);
 
+	if (_scaledPixels)
+		debug(9, "SDL: Scaled %u pixels", _scaledPixels);
+
 	_numDirtyRects = 0;
 	_forceRedraw = false;
 	_cursorNeedsRedraw = false;
@@ -1720,13 +1744,25 @@ void SurfaceSdlGraphicsManager::copyRectToScreen(const void *buf, int pitch, int
 	assert(h > 0 && y + h <= _videoMode.screenHeight);
 	assert(w > 0 && x + w <= _videoMode.screenWidth);
 
-	addDirtyRect(x, y, w, h, false);
-
 	// Try to lock the screen surface
 	if (!lockSurface(_screen))
 		error("SDL_LockSurface failed: %s", SDL_GetError());
 
 	byte *dst = (byte *)_screen->pixels + y * _screen->pitch + x * _screenFormat.bytesPerPixel;
+
+	if (_frameDiff && !_forceRedraw) {
+		// Engines often copy the whole screen even if only a small part
+		// of it changed. Only the changed blocks need to be scaled.
+		Graphics::DirtyRectList changes;
+		changes.addChangedBlocks(dst, _screen->pitch, (const byte *)buf, pitch, x, y, w, h,
+		                         _screenFormat.bytesPerPixel, DIFF_BLOCK_SIZE);
+
+		for (Graphics::DirtyRectList::const_iterator r = changes.begin(); r != changes.end(); ++r)
+			addDirtyRect(r->left, r->top, r->width(), r->height(), false);
+	} else {
+		addDirtyRect(x, y, w, h, false);
+	}
+
 	if (_videoMode.screenWidth == w && pitch == _screen->pitch) {
 		memcpy(dst, buf, h*pitch);
 	} else {
@@ -24,6 +24,7 @@
 
 #include "backends/graphics/graphics.h"
 #include "backends/graphics/sdl/sdl-graphics.h"
+#include "backends/graphics/sdl/sdl-scalerpool.h"
 #include "graphics/pixelformat.h"
 #include "graphics/scaler.h"
 #include "graphics/scalerplugin.h"
@@ -78,6 +79,12 @@ public:
 	void initSize(uint w, uint h, const Graphics::PixelFormat *format = NULL) override;
 	int getScreenChangeID() const override { return _screenChangeCount; }
 
+	/**
+	 * Return the number of game or overlay pixels which were scaled by the
+	 * last screen update.
+	 */
+	uint getScaledPixels() const { return _scaledPixels; }
+
 	void beginGFXTransaction() override;
 	OSystem::TransactionError endGFXTransaction() override;
 
@@ -335,6 +342,7 @@ protected:
 	const PluginList &_scalerPlugins;
 	ScalerPluginObject *_scalerPlugin;
 	Scaler *_scaler, *_mouseScaler;
+	SdlScalerWorkerPool *_scalerPool;
 	uint _maxExtraPixels;
 	uint _extraPixels;
 
@@ -345,9 +353,18 @@ protected:
 
 	enum {
 		NUM_DIRTY_RECT = 100,
-		MAX_SCALING = 3
+		MAX_SCALING = 3,
+		DIFF_BLOCK_SIZE = 16
 	};
 
+	/**
+	 * When enabled, copyRectToScreen compares the new data with the screen
+	 * and only marks the blocks which actually changed as dirty.
+	 */
+	bool _frameDiff;
+
+	uint _scaledPixels;
+
 	// Dirty rect management
 	// When double-buffering we need to redraw both updates from
 	// current frame and previous frame. For convenience we copy
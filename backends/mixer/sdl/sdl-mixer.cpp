@@ -144,6 +144,33 @@ void SdlMixerManager::init() {
 
 	_mixer = new Audio::MixerImpl(_obtained.freq, _obtained.channels >= 2, desiredSamples);
 	assert(_mixer);
+
+	// Advanced users may let the game post mixer commands through a queue
+	// instead of locking the audio thread, see MixerImpl::enableCommandQueue
+	if (ConfMan.hasKey("mixer_command_queue", Common::ConfigManager::kApplicationDomain) &&
+	    ConfMan.getBool("mixer_command_queue", Common::ConfigManager::kApplicationDomain))
+		_mixer->enableCommandQueue(true);
+
+	// Mixing into a 32-bit bus avoids clipping when many loud sounds overlap,
+	// and the limiter keeps the sum from clipping at the output
+	if (ConfMan.hasKey("mixer_headroom", Common::ConfigManager::kApplicationDomain) &&
+	    ConfMan.getBool("mixer_headroom", Common::ConfigManager::kApplicationDomain)) {
+		_mixer->enableMixBus(true);
+
+		if (ConfMan.hasKey("mixer_limiter", Common::ConfigManager::kApplicationDomain) &&
+		    ConfMan.getBool("mixer_limiter", Common::ConfigManager::kApplicationDomain)) {
+			int threshold = Audio::MixerImpl::kDefaultLimiterThreshold;
+			if (ConfMan.hasKey("mixer_limiter_threshold", Common::ConfigManager::kApplicationDomain))
+				threshold = ConfMan.getInt("mixer_limiter_threshold", Common::ConfigManager::kApplicationDomain);
+
+			int releaseMs = Audio::MixerImpl::kDefaultLimiterRelease;
+			if (ConfMan.hasKey("mixer_limiter_release", Common::ConfigManager::kApplicationDomain))
+				releaseMs = ConfMan.getInt("mixer_limiter_release", Common::ConfigManager::kApplicationDomain);
+
+			_mixer->setLimiter(true, threshold, MAX(releaseMs, 0));
+		}
+	}
+
 	_mixer->setReady(true);
 
 	startAudio();
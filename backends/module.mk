@@ -214,6 +214,7 @@ ifdef SDL_BACKEND
 MODULE_OBJS += \
 	events/sdl/sdl-common-events.o \
 	graphics/sdl/sdl-graphics.o \
+	graphics/sdl/sdl-scalerpool.o \
 	graphics/surfacesdl/surfacesdl-graphics.o \
 	mixer/sdl/sdl-mixer.o \
 	mixer/null/null-mixer.o \
@@ -280,6 +281,7 @@ MODULE_OBJS += \
 	fs/posix/posix-fs.o \
 	fs/posix/posix-fs-factory.o \
 	fs/posix/posix-iostream.o \
+	fs/posix/posix-mappedstream.o \
 	fs/posix-drives/posix-drives-fs.o \
 	fs/posix-drives/posix-drives-fs-factory.o \
 	fs/chroot/chroot-fs-factory.o \
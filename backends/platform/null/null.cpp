@@ -50,6 +50,7 @@ typedef void (*sighandler_t)(int);
 #include "common/events.h"
 
 #include "backends/modular-backend.h"
+#include "backends/mixer/mixer.h"
 #include "backends/mutex/null/null-mutex.h"
 #include "base/main.h"
 
@@ -97,6 +98,10 @@ public:
 
 	virtual void addSysArchivesToSearchSet(Common::SearchSet &s, int priority);
 
+#ifdef NULL_DRIVER_USE_FOR_TEST
+	void setMixerManager(MixerManager *mixerManager);
+#endif
+
 private:
 #ifdef POSIX
 	timeval _startTime;
@@ -256,6 +261,15 @@ void OSystem_NULL::addSysArchivesToSearchSet(Common::SearchSet &s, int priority)
 	s.addDirectory(".", ".", priority - 1);
 }
 
+#ifdef NULL_DRIVER_USE_FOR_TEST
+void OSystem_NULL::setMixerManager(MixerManager *mixerManager) {
+	delete _mixerManager;
+	_mixerManager = mixerManager;
+	if (_mixerManager)
+		_mixerManager->init();
+}
+#endif
+
 OSystem *OSystem_NULL_create(bool silenceLogs) {
 	return new OSystem_NULL(silenceLogs);
 }
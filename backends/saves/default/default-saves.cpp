@@ -32,6 +32,7 @@
 #include "backends/saves/default/default-saves.h"
 
 #include "common/savefile.h"
+#include "common/saveindex.h"
 #include "common/util.h"
 #include "common/fs.h"
 #include "common/archive.h"
@@ -151,6 +152,8 @@ Common::OutSaveFile *DefaultSaveFileManager::openForSaving(const Common::String
 	saveTimestamps(timestamps);
 #endif
 
+	removeFromSaveIndex(filename);
+
 	// Obtain node.
 	SaveFileCache::const_iterator file = _saveFileCache.find(filename);
 	Common::FSNode fileNode;
@@ -191,6 +194,8 @@ bool DefaultSaveFileManager::removeSavefile(const Common::String &filename) {
 	}
 #endif
 
+	removeFromSaveIndex(filename);
+
 	// Obtain node if exists.
 	SaveFileCache::const_iterator file = _saveFileCache.find(filename);
 	if (file == _saveFileCache.end()) {
@@ -298,6 +303,17 @@ void DefaultSaveFileManager::assureCached(const Common::Path &savePathName) {
 	_cachedDirectory = savePathName;
 }
 
+void DefaultSaveFileManager::removeFromSaveIndex(const Common::String &filename) {
+	const Common::String indexName = Common::SaveIndex::getIndexName(filename);
+	if (indexName.empty() || !_saveFileCache.contains(indexName))
+		return;
+
+	Common::SaveIndex index;
+	index.load(this, indexName);
+	if (index.remove(filename))
+		index.save(this, indexName);
+}
+
 #ifdef USE_CLOUD
 
 Common::HashMap<Common::String, uint32> DefaultSaveFileManager::loadTimestamps() {
@@ -82,6 +82,12 @@ protected:
 	 */
 	void assureCached(const Common::Path &savePathName);
 
+	/**
+	 * Drop the given savefile from the save index of its target, since it
+	 * is about to be overwritten or removed.
+	 */
+	void removeFromSaveIndex(const Common::String &filename);
+
 	typedef Common::HashMap<Common::String, Common::FSNode, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> SaveFileCache;
 
 	/**
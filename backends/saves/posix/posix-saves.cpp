@@ -127,4 +127,23 @@ POSIXSaveFileManager::POSIXSaveFileManager() {
 	}
 }
 
+bool POSIXSaveFileManager::getSavefileStamp(const Common::String &filename, uint32 &size, uint32 &modTime) {
+	// Assure the savefile name cache is up-to-date.
+	assureCached(getSavePath());
+	if (getError().getCode() != Common::kNoError)
+		return false;
+
+	SaveFileCache::const_iterator file = _saveFileCache.find(filename);
+	if (file == _saveFileCache.end())
+		return false;
+
+	struct stat sb;
+	if (stat(file->_value.getPath().toString(Common::Path::kNativeSeparator).c_str(), &sb) != 0)
+		return false;
+
+	size = sb.st_size;
+	modTime = sb.st_mtime;
+	return true;
+}
+
 #endif
@@ -30,10 +30,13 @@
  * The only two differences are that the default constructor sets
  * up the savepath based on HOME, and that checkPath tries to
  * create the savedir, if missing, via the mkdir() syscall.
+ * Savefile stamps are queried via stat() instead of opening the file.
  */
 class POSIXSaveFileManager : public DefaultSaveFileManager {
 public:
 	POSIXSaveFileManager();
+
+	bool getSavefileStamp(const Common::String &filename, uint32 &size, uint32 &modTime) override;
 };
 #endif
 
@@ -124,6 +124,17 @@ bool SaveFileManager::renameSavefile(const String &oldFilename, const String &ne
 	return removeSavefile(oldFilename);
 }
 
+bool SaveFileManager::getSavefileStamp(const String &name, uint32 &size, uint32 &modTime) {
+	InSaveFile *file = openRawFile(name);
+	if (!file)
+		return false;
+
+	size = file->size();
+	modTime = 0;
+	delete file;
+	return true;
+}
+
 String SaveFileManager::popErrorDesc() {
 	String err = _errorDesc;
 	clearError();
@@ -57,6 +57,7 @@
 #include "gui/error.h"
 #include "gui/message.h"
 
+#include "audio/decodedcache.h"
 #include "audio/mididrv.h"
 #include "audio/musicplugin.h"  /* for music manager */
 
@@ -953,6 +954,7 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 	Common::MainTranslationManager::destroy();
 #endif
 	MusicManager::destroy();
+	Audio::DecodedAudioCache::destroy();
 	Graphics::CursorManager::destroy();
 	Graphics::FontManager::destroy();
 #ifdef USE_FREETYPE2
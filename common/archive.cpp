@@ -362,6 +362,7 @@ void SearchSet::insert(const Node &node) {
 			break;
 	}
 	_list.insert(it, node);
+	invalidateIndex();
 }
 
 void SearchSet::add(const String &name, Archive *archive, int priority, bool autoFree) {
@@ -458,6 +459,7 @@ void SearchSet::remove(const String &name) {
 		if (it->_autoFree)
 			delete it->_arc;
 		_list.erase(it);
+		invalidateIndex();
 	}
 }
 
@@ -481,6 +483,7 @@ void SearchSet::clear() {
 	}
 
 	_list.clear();
+	invalidateIndex();
 }
 
 void SearchSet::setPriority(const String &name, int priority) {
@@ -499,10 +502,53 @@ void SearchSet::setPriority(const String &name, int priority) {
 	insert(node);
 }
 
+void SearchSet::setUseIndex(bool useIndex) {
+	_useIndex = useIndex;
+	invalidateIndex();
+}
+
+const SearchSet::MemberIndex &SearchSet::getIndex() const {
+	if (_indexValid)
+		return _index;
+
+	// Archives are sorted by descending priority: the first one listing a
+	// path is the one a lookup would pick
+	for (const auto &archive : _list) {
+		ArchiveMemberList members;
+		archive._arc->listMembers(members);
+
+		for (const ArchiveMemberPtr &member : members) {
+			Path path = member->getPathInArchive();
+			if (!_index.contains(path))
+				_index[path] = &archive;
+		}
+	}
+
+	_indexValid = true;
+	return _index;
+}
+
+const SearchSet::Node *SearchSet::lookupIndex(const Path &path) const {
+	const MemberIndex &index = getIndex();
+	MemberIndex::const_iterator it = index.find(path);
+	if (it == index.end())
+		return nullptr;
+
+	return it->_value;
+}
+
 bool SearchSet::hasFile(const Path &path) const {
 	if (path.empty())
 		return false;
 
+	if (_useIndex) {
+		// Archives may also hold files they don't list, or the indexed
+		// member may be a directory: on a miss, look further
+		const Node *node = lookupIndex(path);
+		if (node && node->_arc->hasFile(path))
+			return true;
+	}
+
 	for (const auto &archive : _list) {
 		if (archive._arc->hasFile(path))
 			return true;
@@ -583,6 +629,16 @@ const ArchiveMemberPtr SearchSet::getMember(const Path &path, Archive **containe
 	if (path.empty())
 		return ArchiveMemberPtr();
 
+	if (_useIndex) {
+		const Node *node = lookupIndex(path);
+		if (node && node->_arc->hasFile(path)) {
+			if (container) {
+				*container = node->_arc;
+			}
+			return node->_arc->getMember(path);
+		}
+	}
+
 	for (const auto &archive : _list) {
 		if (archive._arc->hasFile(path)) {
 			if (container) {
@@ -603,6 +659,13 @@ SeekableReadStream *SearchSet::createReadStreamForMember(const Path &path) const
 	if (path.empty())
 		return nullptr;
 
+	if (_useIndex) {
+		const Node *node = lookupIndex(path);
+		SeekableReadStream *stream = node ? node->_arc->createReadStreamForMember(path) : nullptr;
+		if (stream)
+			return stream;
+	}
+
 	for (const auto &archive : _list) {
 		SeekableReadStream *stream = archive._arc->createReadStreamForMember(path);
 		if (stream)
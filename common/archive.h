@@ -326,6 +326,9 @@ private:
  * contained Archives, hence the simplistic policy of always looking for the first
  * match. SearchSet does guarantee that searches are performed in DESCENDING
  * priority order. In case of conflicting priorities, insertion order prevails.
+ *
+ * Optionally, the SearchSet can merge the member lists of all its archives in a
+ * single index, see setUseIndex().
  */
 class SearchSet : public Archive {
 	struct Node {
@@ -347,8 +350,17 @@ class SearchSet : public Archive {
 
 	bool _ignoreClashes;
 
+	typedef HashMap<Path, const Node *, Path::IgnoreCaseAndMac_Hash, Path::IgnoreCaseAndMac_EqualTo> MemberIndex;
+
+	bool _useIndex;
+	mutable bool _indexValid;
+	mutable MemberIndex _index;
+
+	const MemberIndex &getIndex() const; //!< Build the index if needed.
+	const Node *lookupIndex(const Path &path) const;
+
 public:
-	SearchSet() : _ignoreClashes(false) { }
+	SearchSet() : _ignoreClashes(false), _useIndex(false), _indexValid(false) { }
 	virtual ~SearchSet() { clear(); }
 
 	char getPathSeparator() const override { return '/'; }
@@ -476,6 +488,25 @@ public:
 	 */
 	void setIgnoreClashes(bool ignoreClashes) { _ignoreClashes = ignoreClashes; }
 
+	/**
+	 * Look up members in a merged index instead of asking every archive in turn.
+	 *
+	 * The index maps every member listed by the archives to the archive with the
+	 * highest priority containing it. It is built on first use and dropped
+	 * whenever archives are added, removed or reordered. Files found in the
+	 * index are opened from that archive directly, everything else is still
+	 * looked up in every archive, and listing members is not affected.
+	 *
+	 * Only enable this when the archives list all the files they can open and
+	 * their contents do not change, or call invalidateIndex() when they do.
+	 */
+	void setUseIndex(bool useIndex);
+
+	/**
+	 * Drop the merged index, it will be rebuilt on next lookup.
+	 */
+	void invalidateIndex() { _indexValid = false; _index.clear(); }
+
 	bool getChildren(const Common::Path &path, Common::Array<Common::String> &list, ListMode mode = kListDirectoriesOnly, bool hidden = true) const override;
 };
 
@@ -0,0 +1,658 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// The open addressing scheme in this file follows the "Swiss table" design
+// of Abseil's flat_hash_map: a byte of metadata per slot is kept in a
+// separate control array and probed one group of slots at a time.
+
+#ifndef COMMON_FLAT_HASHMAP_H
+#define COMMON_FLAT_HASHMAP_H
+
+#include "common/hashmap.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FLAT_HASHMAP_USE_SSE2
+#include <emmintrin.h>
+#else
+#include "common/endian.h"
+#endif
+
+namespace Common {
+
+/**
+ * @defgroup common_flat_hashmap Flat hash table (FlatHashMap)
+ * @ingroup common
+ *
+ * @brief API for operations on a flat, open addressing hash table.
+ *
+ * @{
+ */
+
+/**
+ * FlatHashMap<Key,Val> is a drop-in alternative to HashMap<Key,Val> for
+ * lookup heavy code. It offers the same API, but stores keys and values
+ * inline in a single array instead of allocating a node per entry.
+ *
+ * Every slot has a control byte holding seven bits of the key's hash, or a
+ * marker for empty and erased slots. Lookups compare the control bytes of a
+ * whole group of slots at once (using SSE2 where available), so most of
+ * them touch one cache line of control bytes and the slot of the key.
+ *
+ * Unlike with HashMap, inserting an element may move the other elements,
+ * so iterators as well as pointers and references to values are
+ * invalidated by operator[], getOrCreateVal() and setVal() for keys which
+ * are not in the map yet. Erasing elements does not move the others.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key> >
+class FlatHashMap {
+public:
+	typedef uint size_type;
+
+	struct Node {
+		Val _value;
+		const Key _key;
+		explicit Node(const Key &key) : _value(), _key(key) {}
+		Node(const Key &key, Val &&value) : _value(Common::move(value)), _key(key) {}
+	};
+
+private:
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc> FHM_t;
+	typedef int8 ctrl_t;
+
+	enum {
+		FLATHASHMAP_MIN_CAPACITY = 16,
+
+		// Control bytes of slots which do not hold an element. Full slots
+		// have the lower seven bits of the hash as their control byte.
+		FLATHASHMAP_EMPTY = -128,
+		FLATHASHMAP_DELETED = -2,
+
+		// The map is rehashed when more than 7/8 of the slots are full
+		// or deleted, which guarantees that every probe finds an empty slot.
+		FLATHASHMAP_LOADFACTOR_NUMERATOR = 7,
+		FLATHASHMAP_LOADFACTOR_DENOMINATOR = 8
+	};
+
+#ifdef FLAT_HASHMAP_USE_SSE2
+	enum { GROUP_WIDTH = 16 };
+
+	/** A group of control bytes, with one bit per slot in the masks. */
+	struct Group {
+		__m128i _ctrl;
+
+		explicit Group(const ctrl_t *ctrl) : _ctrl(_mm_loadu_si128((const __m128i *)ctrl)) {}
+
+		uint32 match(ctrl_t h2) const {
+			return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), _ctrl));
+		}
+		uint32 matchEmpty() const {
+			return match(FLATHASHMAP_EMPTY);
+		}
+		uint32 matchEmptyOrDeleted() const {
+			// Only empty and deleted slots have the top bit set
+			return _mm_movemask_epi8(_ctrl);
+		}
+
+		static uint index(uint32 mask) { return lowestBit(mask); }
+	};
+#else
+	enum { GROUP_WIDTH = 8 };
+
+	/** A group of control bytes, with the top bit of each slot's byte set in the masks. */
+	struct Group {
+		uint64 _ctrl;
+
+		explicit Group(const ctrl_t *ctrl) : _ctrl(READ_LE_UINT64(ctrl)) {}
+
+		uint64 match(ctrl_t h2) const {
+			// This may report false positives after a real match, which are
+			// harmless since the keys of all candidates are compared anyway
+			const uint64 x = _ctrl ^ (0x0101010101010101ULL * (byte)h2);
+			return (x - 0x0101010101010101ULL) & ~x & 0x8080808080808080ULL;
+		}
+		uint64 matchEmpty() const {
+			// Empty slots are the only ones with the top bit set and bit 1 clear
+			return _ctrl & ~(_ctrl << 6) & 0x8080808080808080ULL;
+		}
+		uint64 matchEmptyOrDeleted() const {
+			return _ctrl & 0x8080808080808080ULL;
+		}
+
+		static uint index(uint64 mask) { return lowestBit(mask) >> 3; }
+	};
+#endif
+
+	static uint lowestBit(uint64 mask) {
+#if defined(__GNUC__)
+		return __builtin_ctzll(mask);
+#else
+		uint bit = 0;
+		while (!(mask & 1)) {
+			mask >>= 1;
+			++bit;
+		}
+		return bit;
+#endif
+	}
+
+	/** Default value, returned by the const getVal. */
+	Val _defaultVal;
+
+	ctrl_t *_ctrl;  ///< Control bytes, followed by copies of the first GROUP_WIDTH ones
+	Node *_slots;   ///< Uninitialized storage for the elements
+	size_type _mask;    ///< Capacity of the FlatHashMap minus one; the capacity is a power of two
+	size_type _size;
+	size_type _deleted; ///< Number of slots marked as deleted
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	size_type hashOf(const Key &key) const {
+		// Many of the hash functors are weak, e.g. the identity for integers,
+		// so mix the bits before they are split into position and control byte
+		uint32 hash = (uint32)_hash(key) * 0x9E3779B1U;
+		return hash ^ (hash >> 15);
+	}
+
+	void setCtrl(size_type idx, ctrl_t value) {
+		_ctrl[idx] = value;
+		// Keep the copy behind the end in sync, so that groups starting
+		// close to the end can be loaded without wrapping around
+		_ctrl[((idx - GROUP_WIDTH) & _mask) + GROUP_WIDTH] = value;
+	}
+
+	void allocStorage(size_type capacity);
+	void freeStorage();
+	void assign(const FHM_t &map);
+	size_type lookup(const Key &key) const;
+	size_type lookupAndCreateIfMissing(const Key &key);
+	size_type findFreeSlot(size_type hash) const;
+	void rehash(size_type newCapacity);
+
+	/**
+	 * Simple FlatHashMap iterator implementation.
+	 */
+	template<class NodeType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+		template<class T> friend class IteratorImpl;
+	protected:
+		typedef const FlatHashMap hashmap_t;
+
+		size_type _idx;
+		hashmap_t *_hashmap;
+
+	protected:
+		IteratorImpl(size_type idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		NodeType *deref() const {
+			assert(_hashmap != nullptr);
+			assert(_idx <= _hashmap->_mask);
+			assert(_hashmap->_ctrl[_idx] >= 0);
+			return &_hashmap->_slots[_idx];
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(nullptr) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		NodeType &operator*() const { return *deref(); }
+		NodeType *operator->() const { return deref(); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			_idx = _hashmap->nextFull(_idx + 1);
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+	size_type nextFull(size_type idx) const {
+		while (idx <= _mask && _ctrl[idx] < 0)
+			++idx;
+		return idx <= _mask ? idx : (size_type)-1;
+	}
+
+public:
+	typedef IteratorImpl<Node> iterator;
+	typedef IteratorImpl<const Node> const_iterator;
+
+	FlatHashMap();
+	FlatHashMap(const FHM_t &map);
+	~FlatHashMap();
+
+	FHM_t &operator=(const FHM_t &map) {
+		if (this == &map)
+			return *this;
+
+		// Remove the previous content and ...
+		clear();
+		freeStorage();
+		// ... copy the new stuff.
+		assign(map);
+		return *this;
+	}
+
+	bool contains(const Key &key) const;
+
+	Val &operator[](const Key &key);
+	const Val &operator[](const Key &key) const;
+
+	Val &getOrCreateVal(const Key &key);
+	Val &getVal(const Key &key);
+	const Val &getVal(const Key &key) const;
+	const Val &getValOrDefault(const Key &key) const;
+	const Val &getValOrDefault(const Key &key, const Val &defaultVal) const;
+	bool tryGetVal(const Key &key, Val &out) const;
+	void setVal(const Key &key, const Val &val);
+
+	void clear(bool shrinkArray = 0);
+
+	void erase(iterator entry);
+	void erase(const Key &key);
+
+	size_type size() const { return _size; }
+
+	iterator	begin() {
+		return iterator(nextFull(0), this);
+	}
+	iterator	end() {
+		return iterator((size_type)-1, this);
+	}
+
+	const_iterator	begin() const {
+		return const_iterator(nextFull(0), this);
+	}
+	const_iterator	end() const {
+		return const_iterator((size_type)-1, this);
+	}
+
+	iterator	find(const Key &key) {
+		size_type ctr = lookup(key);
+		if (ctr <= _mask)
+			return iterator(ctr, this);
+		return end();
+	}
+
+	const_iterator	find(const Key &key) const {
+		size_type ctr = lookup(key);
+		if (ctr <= _mask)
+			return const_iterator(ctr, this);
+		return end();
+	}
+
+	/** Return true if hashmap is empty. */
+	bool empty() const {
+		return (_size == 0);
+	}
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+/**
+ * Base constructor, creates an empty hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap() : _defaultVal() {
+	allocStorage(FLATHASHMAP_MIN_CAPACITY);
+}
+
+/**
+ * Copy constructor, creates a full copy of the given hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap(const FHM_t &map) : _defaultVal() {
+	assign(map);
+}
+
+/**
+ * Destructor, frees all used memory.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::~FlatHashMap() {
+	clear();
+	freeStorage();
+}
+
+/**
+ * Internal method for allocating empty storage with the given capacity.
+ *
+ * @note The previous storage is *not* deallocated here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::allocStorage(size_type capacity) {
+	assert(capacity >= FLATHASHMAP_MIN_CAPACITY && (capacity & (capacity - 1)) == 0);
+
+	_mask = capacity - 1;
+	_size = 0;
+	_deleted = 0;
+
+	_ctrl = (ctrl_t *)malloc(capacity + GROUP_WIDTH);
+	_slots = (Node *)malloc(capacity * sizeof(Node));
+	if (!_ctrl || !_slots)
+		::error("Common::FlatHashMap: failure to allocate %u slots", capacity);
+	memset(_ctrl, FLATHASHMAP_EMPTY, capacity + GROUP_WIDTH);
+}
+
+/**
+ * Internal method for freeing the storage. The elements must have been
+ * destroyed already.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::freeStorage() {
+	free(_ctrl);
+	free(_slots);
+	_ctrl = nullptr;
+	_slots = nullptr;
+}
+
+/**
+ * Internal method for assigning the content of another FlatHashMap
+ * to this one.
+ *
+ * @note The previous storage here is *not* deallocated here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::assign(const FHM_t &map) {
+	allocStorage(map._mask + 1);
+
+	// The hash functors are the same, so the layout can be copied as is
+	memcpy(_ctrl, map._ctrl, _mask + 1 + GROUP_WIDTH);
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (_ctrl[ctr] >= 0)
+			new ((void *)&_slots[ctr]) Node(map._slots[ctr]);
+	}
+	_size = map._size;
+	_deleted = map._deleted;
+}
+
+/**
+ * Clear all values in the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (_ctrl[ctr] >= 0)
+			_slots[ctr].~Node();
+	}
+
+	if (shrinkArray && _mask >= FLATHASHMAP_MIN_CAPACITY) {
+		freeStorage();
+		allocStorage(FLATHASHMAP_MIN_CAPACITY);
+	} else {
+		memset(_ctrl, FLATHASHMAP_EMPTY, _mask + 1 + GROUP_WIDTH);
+		_size = 0;
+		_deleted = 0;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::rehash(size_type newCapacity) {
+	ctrl_t *old_ctrl = _ctrl;
+	Node *old_slots = _slots;
+	const size_type old_mask = _mask;
+#ifndef RELEASE_BUILD
+	const size_type old_size = _size;
+#endif
+
+	allocStorage(newCapacity);
+
+	// Move all the old elements. Since no key exists twice in the old
+	// table, they can go to the first free slot without calling _equal().
+	for (size_type ctr = 0; ctr <= old_mask; ++ctr) {
+		if (old_ctrl[ctr] < 0)
+			continue;
+
+		Node &node = old_slots[ctr];
+		const size_type hash = hashOf(node._key);
+		const size_type idx = findFreeSlot(hash);
+		new ((void *)&_slots[idx]) Node(node._key, Common::move(node._value));
+		setCtrl(idx, hash & 0x7F);
+		node.~Node();
+		_size++;
+	}
+
+#ifndef RELEASE_BUILD
+	// Perform a sanity check: Old number of elements should match the new one!
+	assert(_size == old_size);
+#endif
+
+	free(old_ctrl);
+	free(old_slots);
+}
+
+/**
+ * Internal method returning the first empty or deleted slot on the probe
+ * sequence of the given hash.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::findFreeSlot(size_type hash) const {
+	size_type pos = (hash >> 7) & _mask;
+	for (size_type step = GROUP_WIDTH; ; step += GROUP_WIDTH) {
+		const Group group(_ctrl + pos);
+		const auto candidates = group.matchEmptyOrDeleted();
+		if (candidates)
+			return (pos + Group::index(candidates)) & _mask;
+
+		// Triangular probing visits every group once, since the
+		// capacity is a power of two
+		pos = (pos + step) & _mask;
+	}
+}
+
+/**
+ * Internal method returning the slot of the given key, or _mask + 1 if
+ * the key is not in the map.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key) const {
+	const size_type hash = hashOf(key);
+	const ctrl_t h2 = hash & 0x7F;
+	size_type pos = (hash >> 7) & _mask;
+	for (size_type step = GROUP_WIDTH; ; step += GROUP_WIDTH) {
+		const Group group(_ctrl + pos);
+		for (auto match = group.match(h2); match; match &= match - 1) {
+			const size_type ctr = (pos + Group::index(match)) & _mask;
+			if (_ctrl[ctr] == h2 && _equal(_slots[ctr]._key, key))
+				return ctr;
+		}
+
+		// An empty slot ends every probe sequence the key could be on
+		if (group.matchEmpty())
+			return _mask + 1;
+
+		pos = (pos + step) & _mask;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr <= _mask)
+		return ctr;
+
+	// Keep the load factor below a certain threshold. Deleted slots are
+	// also counted; if they make up much of the map, they are just removed.
+	const size_type capacity = _mask + 1;
+	if ((_size + _deleted + 1) * FLATHASHMAP_LOADFACTOR_DENOMINATOR > capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR)
+		rehash(_size * 2 < capacity ? capacity : capacity * 2);
+
+	const size_type hash = hashOf(key);
+	ctr = findFreeSlot(hash);
+	if (_ctrl[ctr] == FLATHASHMAP_DELETED)
+		_deleted--;
+	new ((void *)&_slots[ctr]) Node(key);
+	setCtrl(ctr, hash & 0x7F);
+	_size++;
+
+	return ctr;
+}
+
+/**
+ * Check whether the hashmap contains the given key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::contains(const Key &key) const {
+	return lookup(key) <= _mask;
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) {
+	return getOrCreateVal(key);
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) const {
+	return getVal(key);
+}
+
+/**
+ * Get a value from the hashmap.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getOrCreateVal(const Key &key) {
+	// The lookup may reallocate _slots, so it has to happen first
+	const size_type ctr = lookupAndCreateIfMissing(key);
+	return _slots[ctr]._value;
+}
+
+/**
+ * @overload
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr <= _mask)
+		return _slots[ctr]._value;
+	else
+		// See the comment in HashMap::getVal().
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) const {
+	size_type ctr = lookup(key);
+	if (ctr <= _mask)
+		return _slots[ctr]._value;
+	else
+		// See the comment in HashMap::getVal().
+#ifdef RELEASE_BUILD
+		return _defaultVal;
+#else
+		unknownKeyError(key);
+#endif
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key) const {
+	return getValOrDefault(key, _defaultVal);
+}
+
+/**
+ * Get a value from the hashmap. If the key is not present, then return @p defaultVal.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getValOrDefault(const Key &key, const Val &defaultVal) const {
+	size_type ctr = lookup(key);
+	if (ctr <= _mask)
+		return _slots[ctr]._value;
+	else
+		return defaultVal;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::tryGetVal(const Key &key, Val &out) const {
+	size_type ctr = lookup(key);
+	if (ctr <= _mask) {
+		out = _slots[ctr]._value;
+		return true;
+	} else {
+		return false;
+	}
+}
+
+/**
+ * Assign an element specified by @p key to a value @p val.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::setVal(const Key &key, const Val &val) {
+	const size_type ctr = lookupAndCreateIfMissing(key);
+	_slots[ctr]._value = val;
+}
+
+/**
+ * Erase an element referred to by an iterator.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(iterator entry) {
+	// Check whether we have a valid iterator
+	assert(entry._hashmap == this);
+	const size_type ctr = entry._idx;
+	assert(ctr <= _mask);
+	assert(_ctrl[ctr] >= 0);
+
+	// If we remove a key, we mark its slot as deleted, so that probe
+	// sequences passing through it continue
+	_slots[ctr].~Node();
+	setCtrl(ctr, FLATHASHMAP_DELETED);
+	_size--;
+	_deleted++;
+}
+
+/**
+ * Erase an element specified by a key.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr > _mask)
+		return;
+
+	erase(iterator(ctr, this));
+}
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -261,6 +261,16 @@ public:
 	 */
 	SeekableReadStream *createReadStream() const override;
 
+	/**
+	 * Create a SeekableReadStream instance for a file which is not modified
+	 * while the stream is open, such as game data. The backend may map the
+	 * file into memory, so this must not be used for savegames, configuration
+	 * files or anything else which is written to at run time.
+	 *
+	 * @return Pointer to the stream object, nullptr in case of a failure.
+	 */
+	SeekableReadStream *createMappedReadStream() const;
+
 	/**
 	 * Create a SeekableReadStream instance corresponding to an alternate stream
 	 * of the file referred by this node. This assumes that the node actually
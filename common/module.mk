@@ -32,6 +32,7 @@ MODULE_OBJS := \
 	rational.o \
 	rendermode.o \
 	rotationmode.o \
+	saveindex.o \
 	str.o \
 	stream.o \
 	streamdebug.o \
@@ -432,6 +432,8 @@ int Path::numComponents() const {
 }
 
 Path &Path::appendInPlace(const Path &x) {
+	invalidateHashes();
+
 	if (x._str.empty()) {
 		return *this;
 	}
@@ -482,6 +484,8 @@ Path &Path::appendInPlace(const Path &x) {
 }
 
 Path &Path::appendInPlace(const char *str, char separator) {
+	invalidateHashes();
+
 	if (!*str) {
 		return *this;
 	}
@@ -541,6 +545,7 @@ Path Path::appendComponent(const char *str) const {
 	if (isEscaped()) {
 		// We are escaped, escape str as well
 		Path ret(*this);
+		ret.invalidateHashes();
 		if (addSeparator) {
 			ret._str += SEPARATOR;
 		}
@@ -561,6 +566,7 @@ Path Path::appendComponent(const char *str) const {
 	} else {
 		// No need to escape anything
 		Path ret(*this);
+		ret.invalidateHashes();
 		if (addSeparator) {
 			ret._str += SEPARATOR;
 		}
@@ -570,6 +576,8 @@ Path Path::appendComponent(const char *str) const {
 }
 
 Path &Path::joinInPlace(const Path &x) {
+	invalidateHashes();
+
 	if (x.empty()) {
 		return *this;
 	}
@@ -593,6 +601,8 @@ Path &Path::joinInPlace(const Path &x) {
 }
 
 Path &Path::joinInPlace(const char *str, char separator) {
+	invalidateHashes();
+
 	if (*str == '\0') {
 		return *this;
 	}
@@ -609,6 +619,8 @@ Path &Path::joinInPlace(const char *str, char separator) {
 }
 
 Path &Path::removeTrailingSeparators() {
+	invalidateHashes();
+
 	while (_str.size() > 1 && _str.lastChar() == SEPARATOR) {
 		_str.deleteLastChar();
 	}
@@ -616,6 +628,8 @@ Path &Path::removeTrailingSeparators() {
 }
 
 Path &Path::removeExtension(const char *ext) {
+	invalidateHashes();
+
 	if (_str.empty()) {
 		return *this;
 	}
@@ -1121,8 +1135,31 @@ uint Path::hash() const {
 	return hashit(_str.c_str());
 }
 
+bool Path::getCachedHash(byte flag, uint &hash) const {
+#ifndef NO_CXX11_ATOMIC
+	if (_hashValid.load(std::memory_order_acquire) & flag) {
+		hash = (flag == kHashIgnoreCaseValid ? _hashIgnoreCase : _hashIgnoreCaseAndMac).load(std::memory_order_relaxed);
+		return true;
+	}
+#endif
+	return false;
+}
+
+void Path::setCachedHash(byte flag, uint hash) const {
+#ifndef NO_CXX11_ATOMIC
+	// Threads racing here store the same value
+	(flag == kHashIgnoreCaseValid ? _hashIgnoreCase : _hashIgnoreCaseAndMac).store(hash, std::memory_order_relaxed);
+	_hashValid.fetch_or(flag, std::memory_order_release);
+#endif
+}
+
 uint Path::hashIgnoreCase() const {
-	return hashit_lower(_str);
+	uint hash;
+	if (!getCachedHash(kHashIgnoreCaseValid, hash)) {
+		hash = hashit_lower(_str);
+		setCachedHash(kHashIgnoreCaseValid, hash);
+	}
+	return hash;
 }
 
 // This hash algorithm is inspired by a Python proposal to hash for tuples
@@ -1135,6 +1172,11 @@ struct hasher {
 };
 
 uint Path::hashIgnoreCaseAndMac() const {
+	uint hash;
+	if (getCachedHash(kHashIgnoreCaseAndMacValid, hash)) {
+		return hash;
+	}
+
 	hasher v = { 0x345678, 1000003 };
 	reduceComponents<hasher &>(
 		[](hasher &value, const String &in, bool last) -> hasher & {
@@ -1144,6 +1186,8 @@ uint Path::hashIgnoreCaseAndMac() const {
 			value.mult = (value.mult * 69069);
 			return value;
 		}, v);
+
+	setCachedHash(kHashIgnoreCaseAndMacValid, v.result);
 	return v.result;
 }
 
@@ -1246,6 +1290,7 @@ String Path::toConfig() const {
 		// If we are escaped, we have forbidden characters which must be encoded
 		// Try to replace all : by SEPARATOR and check if we need puny encoding: if we don't, we are safe
 		Path tmp(*this);
+		tmp.invalidateHashes();
 		tmp._str.replace(':', SEPARATOR);
 #if defined(RISCOS)
 		// RiscOS uses these characters everywhere
@@ -26,6 +26,10 @@
 #include "common/str.h"
 #include "common/str-array.h"
 
+#ifndef NO_CXX11_ATOMIC
+#include <atomic>
+#endif
+
 #ifdef CXXTEST_RUNNING
 class PathTestSuite;
 #endif
@@ -70,6 +74,45 @@ private:
 
 	String _str;
 
+	/**
+	 * Case insensitive hashes are computed on demand and kept until the path
+	 * changes: archive lookups hash the same path once for every archive of a
+	 * SearchSet and hashIgnoreCaseAndMac() has to split the path in components.
+	 *
+	 * The hashes are stored by const methods, possibly on several threads
+	 * sharing the path, hence the atomics. Without them nothing is kept.
+	 */
+	enum {
+		kHashIgnoreCaseValid       = 1 << 0,
+		kHashIgnoreCaseAndMacValid = 1 << 1
+	};
+
+#ifndef NO_CXX11_ATOMIC
+	mutable std::atomic<uint> _hashIgnoreCase{0};
+	mutable std::atomic<uint> _hashIgnoreCaseAndMac{0};
+	mutable std::atomic<byte> _hashValid{0};
+#endif
+
+	/** Must be called by every method which modifies _str. */
+	void invalidateHashes() {
+#ifndef NO_CXX11_ATOMIC
+		_hashValid.store(0, std::memory_order_relaxed);
+#endif
+	}
+
+	void copyHashes(const Path &path) {
+#ifndef NO_CXX11_ATOMIC
+		const byte valid = path._hashValid.load(std::memory_order_acquire);
+		_hashIgnoreCase.store(path._hashIgnoreCase.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		_hashIgnoreCaseAndMac.store(path._hashIgnoreCaseAndMac.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		_hashValid.store(valid, std::memory_order_relaxed);
+#endif
+	}
+
+	/** Return the cached hash for @p flag, if there is one. */
+	bool getCachedHash(byte flag, uint &hash) const;
+	void setCachedHash(byte flag, uint hash) const;
+
 	/**
 	 * Escapes a path:
 	 * - all ESCAPE are encoded to ESCAPE ESCAPED_ESCAPE
@@ -237,7 +280,7 @@ public:
 	Path() {}
 
 	/** Construct a copy of the given path. */
-	Path(const Path &path) : _str(path._str) { }
+	Path(const Path &path) : _str(path._str) { copyHashes(path); }
 
 	/**
 	 * Construct a new path from the given NULL-terminated C string.
@@ -276,7 +319,7 @@ public:
 	/**
 	 * Clears the path object
 	 */
-	void clear() { _str.clear(); }
+	void clear() { _str.clear(); invalidateHashes(); }
 
 	/**
 	 * Returns the Path for the parent directory of this path.
@@ -357,6 +400,7 @@ public:
 	/** Assign a given path to this path. */
 	Path &operator=(const Path &path) {
 		_str = path._str;
+		copyHashes(path);
 		return *this;
 	}
 
@@ -378,6 +422,7 @@ public:
 		} else {
 			_str = str;
 		}
+		invalidateHashes();
 	}
 
 	/**
@@ -587,6 +632,7 @@ public:
 	void toLowercase() {
 		// Escapism is not changed by changing case
 		_str.toLowercase();
+		invalidateHashes();
 	}
 
 	/**
@@ -598,6 +644,7 @@ public:
 	void toUppercase() {
 		// Escapism is not changed by changing case
 		_str.toUppercase();
+		invalidateHashes();
 	}
 
 	/**
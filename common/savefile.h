@@ -276,6 +276,21 @@ public:
 	 * @return true if the file exists. false otherwise.
 	 */
 	virtual bool exists(const String &name) = 0;
+
+	/**
+	 * Query the size and the modification time of the given save file, to
+	 * tell whether information cached about it is still current.
+	 *
+	 * The default implementation opens the file to get its size and reports
+	 * an unknown modification time of 0.
+	 *
+	 * @param name     Name of the save file.
+	 * @param size     Receives the raw size of the file.
+	 * @param modTime  Receives the modification time of the file.
+	 *
+	 * @return true if the file exists. false otherwise.
+	 */
+	virtual bool getSavefileStamp(const String &name, uint32 &size, uint32 &modTime);
 };
 
 /** @} */
@@ -0,0 +1,156 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/saveindex.h"
+#include "common/endian.h"
+#include "common/ptr.h"
+#include "common/savefile.h"
+
+namespace Common {
+
+#define SAVEINDEX_EXTENSION "idx"
+#define SAVEINDEX_TAG MKTAG('S', 'V', 'M', 'I')
+#define SAVEINDEX_VERSION 1
+
+String SaveIndex::getIndexName(const String &saveName) {
+	const size_t dot = saveName.findLastOf('.');
+	if (dot == String::npos || dot == 0)
+		return String();
+
+	String indexName(saveName.c_str(), dot + 1);
+	indexName += SAVEINDEX_EXTENSION;
+	if (indexName.equalsIgnoreCase(saveName))
+		return String();
+	return indexName;
+}
+
+bool SaveIndex::load(SaveFileManager *saveFileMan, const String &indexName) {
+	_entries.clear();
+	_modified = false;
+
+	if (!saveFileMan->exists(indexName))
+		return false;
+
+	ScopedPtr<InSaveFile> in(saveFileMan->openForLoading(indexName));
+	if (!in || !loadFromStream(*in)) {
+		// Rewrite it on the next save
+		_entries.clear();
+		_modified = true;
+		return false;
+	}
+	return true;
+}
+
+bool SaveIndex::save(SaveFileManager *saveFileMan, const String &indexName) {
+	if (!_modified)
+		return true;
+
+	ScopedPtr<OutSaveFile> out(saveFileMan->openForSaving(indexName, false));
+	if (!out)
+		return false;
+
+	saveToStream(*out);
+	out->finalize();
+	if (out->err())
+		return false;
+
+	_modified = false;
+	return true;
+}
+
+bool SaveIndex::loadFromStream(ReadStream &stream) {
+	_entries.clear();
+
+	if (stream.readUint32BE() != SAVEINDEX_TAG || stream.readByte() != SAVEINDEX_VERSION)
+		return false;
+
+	const uint32 count = stream.readUint32LE();
+	for (uint32 i = 0; i < count && !stream.eos(); ++i) {
+		SaveIndexEntry entry;
+		const String saveName = stream.readString();
+		entry.size = stream.readUint32LE();
+		entry.modTime = stream.readUint32LE();
+		entry.saveDate = stream.readUint32LE();
+		entry.saveTime = stream.readUint16LE();
+		entry.playTime = stream.readUint32LE();
+		entry.isAutosave = stream.readByte() != 0;
+		entry.description = stream.readString();
+		_entries[saveName] = entry;
+	}
+
+	return !stream.err() && !stream.eos() && _entries.size() == count;
+}
+
+void SaveIndex::saveToStream(WriteStream &stream) const {
+	stream.writeUint32BE(SAVEINDEX_TAG);
+	stream.writeByte(SAVEINDEX_VERSION);
+	stream.writeUint32LE(_entries.size());
+
+	for (EntryMap::const_iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		const SaveIndexEntry &entry = i->_value;
+		stream.writeString(i->_key);
+		stream.writeByte(0);
+		stream.writeUint32LE(entry.size);
+		stream.writeUint32LE(entry.modTime);
+		stream.writeUint32LE(entry.saveDate);
+		stream.writeUint16LE(entry.saveTime);
+		stream.writeUint32LE(entry.playTime);
+		stream.writeByte(entry.isAutosave);
+		stream.writeString(entry.description);
+		stream.writeByte(0);
+	}
+}
+
+const SaveIndexEntry *SaveIndex::find(const String &saveName) const {
+	EntryMap::const_iterator i = _entries.find(saveName);
+	return i != _entries.end() ? &i->_value : nullptr;
+}
+
+void SaveIndex::set(const String &saveName, const SaveIndexEntry &entry) {
+	_entries[saveName] = entry;
+	_modified = true;
+}
+
+bool SaveIndex::remove(const String &saveName) {
+	EntryMap::iterator i = _entries.find(saveName);
+	if (i == _entries.end())
+		return false;
+
+	_entries.erase(i);
+	_modified = true;
+	return true;
+}
+
+void SaveIndex::retain(const StringArray &saveNames) {
+	EntryMap kept;
+	for (StringArray::const_iterator i = saveNames.begin(); i != saveNames.end(); ++i) {
+		EntryMap::const_iterator entry = _entries.find(*i);
+		if (entry != _entries.end())
+			kept[entry->_key] = entry->_value;
+	}
+
+	if (kept.size() != _entries.size()) {
+		_entries = kept;
+		_modified = true;
+	}
+}
+
+} // End of namespace Common
@@ -0,0 +1,115 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef COMMON_SAVEINDEX_H
+#define COMMON_SAVEINDEX_H
+
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/str-array.h"
+
+namespace Common {
+
+/**
+ * @addtogroup common_savefile
+ * @{
+ */
+
+class ReadStream;
+class SaveFileManager;
+class WriteStream;
+
+/**
+ * Save header information of a single savefile, as stored in a SaveIndex.
+ */
+struct SaveIndexEntry {
+	uint32 size;            /*!< Raw size of the savefile when the entry was made. */
+	uint32 modTime;         /*!< Modification time of the savefile, 0 if unknown. */
+	uint32 saveDate;        /*!< Save date, in the extended save header format. */
+	uint16 saveTime;        /*!< Save time, in the extended save header format. */
+	uint32 playTime;        /*!< Total play time until this savegame. */
+	bool isAutosave;        /*!< Whether this savegame is an autosave. */
+	String description;     /*!< Description of the savegame. */
+
+	SaveIndexEntry() : size(0), modTime(0), saveDate(0), saveTime(0), playTime(0), isAutosave(false) {}
+};
+
+/**
+ * Index of the save headers of one target, stored beside its savefiles.
+ *
+ * It allows listing the saves without opening every single one of them.
+ * Entries are only trusted as long as the size and the modification time
+ * of their savefile did not change, and the savefile manager drops the
+ * entry of a savefile whenever it is written or removed.
+ */
+class SaveIndex {
+public:
+	SaveIndex() : _modified(false) {}
+
+	/**
+	 * Return the name of the index covering the given savefile, which is
+	 * the savefile name with its extension replaced.
+	 *
+	 * @return The index name, or an empty string if the savefile has no
+	 *         extension or is an index itself.
+	 */
+	static String getIndexName(const String &saveName);
+
+	/**
+	 * Load the index from the save directory. A missing or broken index
+	 * leaves it empty.
+	 *
+	 * @return True if the index was loaded.
+	 */
+	bool load(SaveFileManager *saveFileMan, const String &indexName);
+
+	/**
+	 * Write the index to the save directory if it was modified.
+	 */
+	bool save(SaveFileManager *saveFileMan, const String &indexName);
+
+	bool loadFromStream(ReadStream &stream);
+	void saveToStream(WriteStream &stream) const;
+
+	/** Return the entry of the given savefile, or nullptr if there is none. */
+	const SaveIndexEntry *find(const String &saveName) const;
+
+	void set(const String &saveName, const SaveIndexEntry &entry);
+	bool remove(const String &saveName);
+
+	/** Remove all the entries except the ones of the given savefiles. */
+	void retain(const StringArray &saveNames);
+
+	uint size() const { return _entries.size(); }
+	bool isModified() const { return _modified; }
+
+private:
+	typedef HashMap<String, SaveIndexEntry, IgnoreCase_Hash, IgnoreCase_EqualTo> EntryMap;
+
+	EntryMap _entries;
+	bool _modified;
+};
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
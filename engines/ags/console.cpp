@@ -34,6 +34,7 @@ AGSConsole::AGSConsole(AGSEngine *vm) : GUI::Debugger(), _vm(vm), _logOutputTarg
 	registerCmd("ags_debug_groups_list",   WRAP_METHOD(AGSConsole, Cmd_listDebugGroups));
 	registerCmd("ags_debug_groups_set",  WRAP_METHOD(AGSConsole, Cmd_setDebugGroupLevel));
 	registerCmd("ags_set_script_dump", WRAP_METHOD(AGSConsole, Cmd_SetScriptDump));
+	registerCmd("ags_script_stats", WRAP_METHOD(AGSConsole, Cmd_scriptStats));
 	registerCmd("ags_sprite_info",   WRAP_METHOD(AGSConsole, Cmd_getSpriteInfo));
 	registerCmd("ags_sprite_dump",  WRAP_METHOD(AGSConsole, Cmd_dumpSprite));
 
@@ -185,6 +186,30 @@ bool AGSConsole::Cmd_SetScriptDump(int argc, const char **argv) {
 	return true;
 }
 
+bool AGSConsole::Cmd_scriptStats(int argc, const char **argv) {
+	if (argc > 2 || (argc == 2 && strcmp(argv[1], "reset") != 0)) {
+		debugPrintf("Usage: %s [reset]\n", argv[0]);
+		return true;
+	}
+
+	if (argc == 2) {
+		_G(scriptInstructionCount) = 0;
+		_G(scriptRunTimeUs) = 0;
+		_G(scriptRunCount) = 0;
+		debugPrintf("Script interpreter statistics reset\n");
+		return true;
+	}
+
+	const double instructions = (double)_G(scriptInstructionCount);
+	const double seconds = (double)_G(scriptRunTimeUs) / 1000000.0;
+	debugPrintf("Script calls:        %u\n", _G(scriptRunCount));
+	debugPrintf("Instructions run:    %.0f\n", instructions);
+	debugPrintf("Time in scripts:     %.3f s\n", seconds);
+	if (seconds > 0.0)
+		debugPrintf("Instructions/second: %.0f\n", instructions / seconds);
+	return true;
+}
+
 bool AGSConsole::Cmd_getSpriteInfo(int argc, const char **argv) {
 	if (argc != 2) {
 		debugPrintf("Usage: %s SpriteNumber\n", argv[0]);
@@ -253,6 +253,7 @@ ccInstance::ccInstance() {
 	numimports = 0;
 	resolved_imports = nullptr;
 	code_fixups         = nullptr;
+	decoded_code        = nullptr;
 
 	memset(callStackLineNumber, 0, sizeof(callStackLineNumber));
 	memset(callStackAddr, 0, sizeof(callStackAddr));
@@ -432,7 +433,14 @@ int ccInstance::CallScriptFunction(const char *funcname, int32_t numargs, const
 
 	_GP(InstThreads).push_back(this); // push instance thread
 	runningInst = this;
+	// Only the outermost call is timed, nested ones are a part of it
+	const bool timed = _GP(InstThreads).size() == 1;
+	const auto runStart = timed ? AGS_Clock::now() : AGS_Clock::time_point();
 	const int reterr = Run(startat);
+	if (timed) {
+		_G(scriptRunTimeUs) += std::chrono::duration_cast<std::chrono::microseconds>(AGS_Clock::now() - runStart).count();
+		_G(scriptRunCount)++;
+	}
 	// Cleanup before returning, even if error
 	ASSERT_STACK_SIZE(numargs);
 	PopValuesFromStack(numargs);
@@ -542,6 +550,16 @@ inline bool FixupArgument(RuntimeScriptValue &arg, const int fixup, const uintpt
 	}
 }
 
+// Adds the instructions executed by a Run() call to the interpreter
+// statistics when it returns, whichever way it does
+struct ScriptInstructionCounter {
+	uint64_t Count = 0u;
+
+	~ScriptInstructionCounter() {
+		_G(scriptInstructionCount) += Count;
+	}
+};
+
 #define MAXNEST 50  // number of recursive function calls allowed
 int ccInstance::Run(int32_t curpc) {
 	pc = curpc;
@@ -562,6 +580,7 @@ int ccInstance::Run(int32_t curpc) {
 	ccInstance *codeInst = runningInst;
 	ScriptOperation codeOp;
 	FunctionCallStack func_callstack;
+	ScriptInstructionCounter instructionCounter;
 #if DEBUG_CC_EXEC
 	const bool dump_opcodes = (ccGetOption(SCOPT_DEBUGRUN) != 0) ||
 							  (gDebugLevel > 0 && DebugMan.isDebugChannelEnabled(::AGS::kDebugScript));
@@ -583,17 +602,21 @@ int ccInstance::Run(int32_t curpc) {
 		//
 		/* Read operation */
 		//=====================================================================
-		codeOp.Instruction.Code         = codeInst->code[pc];
-		codeOp.Instruction.InstanceId   = (codeOp.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
-		codeOp.Instruction.Code        &= INSTANCE_ID_REMOVEMASK; // now this is pure instruction code
-
-		CC_ERROR_IF_RETCODE((codeOp.Instruction.Code < 0 || codeOp.Instruction.Code >= CC_NUM_SCCMDS),
-							"invalid instruction %d found in code stream", codeOp.Instruction.Code);
-
-		codeOp.ArgCount = (*g_commands)[codeOp.Instruction.Code].ArgCount;
-
-		CC_ERROR_IF_RETCODE(pc + codeOp.ArgCount >= codeInst->codesize,
-							"unexpected end of code data (%d; %d)", pc + codeOp.ArgCount, codeInst->codesize);
+		// The instruction was already unpacked and validated when the
+		// instance was created, see DecodeInstruction()
+		const ScriptDecodedOp &decodedOp = codeInst->decoded_code[pc];
+		if (decodedOp.Code == ScriptDecodedOp::kInvalidCode) {
+			const int32_t instruction = static_cast<int32_t>(codeInst->code[pc] & INSTANCE_ID_REMOVEMASK);
+			if (instruction < 0 || instruction >= CC_NUM_SCCMDS)
+				cc_error("invalid instruction %d found in code stream", instruction);
+			else
+				cc_error("unexpected end of code data (%d; %d)", pc + (*g_commands)[instruction].ArgCount, codeInst->codesize);
+			return -1;
+		}
+		codeOp.Instruction.Code         = decodedOp.Code;
+		codeOp.Instruction.InstanceId   = decodedOp.InstanceId;
+		codeOp.ArgCount                 = decodedOp.ArgCount;
+		instructionCounter.Count++;
 
 
 		// Read arguments; use switch as it proved to be faster than the loop
@@ -1651,6 +1674,7 @@ bool ccInstance::_Create(PScript scri, const ccInstance *joined) {
 	if (joined) {
 		resolved_imports = joined->resolved_imports;
 		code_fixups = joined->code_fixups;
+		decoded_code = joined->decoded_code;
 	} else {
 		if (!CreateGlobalVars(scri.get())) {
 			return false;
@@ -1658,6 +1682,10 @@ bool ccInstance::_Create(PScript scri, const ccInstance *joined) {
 		if (!CreateRuntimeCodeFixups(scri.get())) {
 			return false;
 		}
+		// NOTE: this is done after the fixups, because they may change the code
+		decoded_code = new ScriptDecodedOp[codesize];
+		for (int32_t i = 0; i < codesize; ++i)
+			DecodeInstruction(i);
 	}
 
 	exports = new RuntimeScriptValue[scri->numexports];
@@ -1737,9 +1765,11 @@ void ccInstance::Free() {
 	if ((flags & INSTF_SHAREDATA) == 0) {
 		delete[] resolved_imports;
 		delete[] code_fixups;
+		delete[] decoded_code;
 	}
 	resolved_imports = nullptr;
 	code_fixups = nullptr;
+	decoded_code = nullptr;
 }
 
 bool ccInstance::ResolveScriptImports(const ccScript *scri) {
@@ -1945,14 +1975,36 @@ bool ccInstance::ResolveImportFixups(const ccScript *scri) {
 			return false;
 		}
 		code[fixup] = import_index;
+		DecodeInstruction(fixup);
 		// If the call is to another script function next CALLEXT
 		// must be replaced with CALLAS
-		if (import->InstancePtr != nullptr && (code[fixup + 1] & INSTANCE_ID_REMOVEMASK) == SCMD_CALLEXT)
+		if (import->InstancePtr != nullptr && (code[fixup + 1] & INSTANCE_ID_REMOVEMASK) == SCMD_CALLEXT) {
 			code[fixup + 1] = SCMD_CALLAS | (import->InstancePtr->loadedInstanceId << INSTANCE_ID_SHIFT);
+			DecodeInstruction(fixup + 1);
+		}
 	}
 	return true;
 }
 
+void ccInstance::DecodeInstruction(int32_t at) {
+	ScriptDecodedOp &decoded = decoded_code[at];
+	decoded = ScriptDecodedOp();
+
+	// NOTE: every position is decoded, including the ones holding arguments,
+	// because the interpreter must report whatever a bad jump lands on
+	const int32_t instruction = static_cast<int32_t>(code[at]);
+	const int32_t op = instruction & INSTANCE_ID_REMOVEMASK;
+	if (op < 0 || op >= CC_NUM_SCCMDS)
+		return;
+	const int arg_count = (*g_commands)[op].ArgCount;
+	if (at + arg_count >= codesize)
+		return;
+
+	decoded.Code = static_cast<uint8_t>(op);
+	decoded.ArgCount = static_cast<uint8_t>(arg_count);
+	decoded.InstanceId = static_cast<uint8_t>((instruction >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK);
+}
+
 void ccInstance::PushValueToStack(const RuntimeScriptValue &rval) {
 	// Write value to the stack tail and advance stack ptr
 	registers[SREG_SP].WriteValue(rval);
@@ -67,6 +67,18 @@ struct ScriptInstruction {
 	int32_t InstanceId = 0;
 };
 
+// Instruction found at some position of the byte-code, decoded and validated
+// once when the script instance is created, so that the interpreter does not
+// have to do this every time it executes an instruction
+struct ScriptDecodedOp {
+	// Code value of the positions that do not hold a valid instruction
+	static const uint8_t kInvalidCode = 0xFF;
+
+	uint8_t Code = kInvalidCode; // pure instruction code
+	uint8_t ArgCount = 0;
+	uint8_t InstanceId = 0;
+};
+
 struct ScriptOperation {
 	ScriptInstruction   Instruction;
 	RuntimeScriptValue  Args[MAX_SCMD_ARGS];
@@ -154,6 +166,8 @@ public:
 	int  numimports;
 
 	char *code_fixups;
+	// decoded instruction for each position of the byte-code
+	ScriptDecodedOp *decoded_code;
 
 	// returns the currently executing instance, or NULL if none
 	static ccInstance *GetCurrentInstance(void);
@@ -208,6 +222,8 @@ private:
 	bool    AddGlobalVar(const ScriptVariable &glvar);
 	ScriptVariable *FindGlobalVar(int32_t var_addr);
 	bool    CreateRuntimeCodeFixups(const ccScript *scri);
+	// Decode the instruction at the given position of the byte-code into decoded_code[]
+	void    DecodeInstruction(int32_t at);
 
 	// Begin executing script starting from the given bytecode index
 	int     Run(int32_t curpc);
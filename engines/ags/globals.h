@@ -1315,6 +1315,10 @@ public:
 	// after which the interpreter will abort
 	unsigned _maxWhileLoops = 0u;
 	ccInstance *_loadedInstances[MAX_LOADED_INSTANCES];
+	// Script interpreter statistics, reported by the ags_script_stats console command
+	uint64_t _scriptInstructionCount = 0;
+	uint64_t _scriptRunTimeUs = 0; // time spent in the outermost script calls
+	uint32_t _scriptRunCount = 0;
 	ScriptString *_myScriptStringImpl;
 	ScriptUserObject _globalDynamicStruct;
 
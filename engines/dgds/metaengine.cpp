@@ -42,6 +42,9 @@ public:
 
 	Common::KeymapArray initKeymaps(const char *target) const override;
 	SaveStateDescriptor querySaveMetaInfos(const char *target, int slot) const override;
+	SaveStateDescriptor queryIndexedSaveMetaInfos(const char *target, int slot, Common::SaveIndex &index) const override {
+		return querySaveMetaInfos(target, slot);
+	}
 };
 
 bool DgdsMetaEngine::hasFeature(MetaEngineFeature f) const {
@@ -571,21 +571,16 @@ void LC::cb_call() {
 
 void LC::cb_globalpush() {
 	Common::String name = g_lingo->readString();
-	Datum target(name);
-	target.type = GLOBALREF;
 	debugC(3, kDebugLingoExec, "cb_globalpush: pushing %s to stack", name.c_str());
-	Datum result = g_lingo->varFetch(target);
-	g_lingo->push(result);
+	g_lingo->push(g_lingo->varFetch(GLOBALREF, name));
 }
 
 
 void LC::cb_globalassign() {
 	Common::String name = g_lingo->readString();
-	Datum target(name);
-	target.type = GLOBALREF;
 	debugC(3, kDebugLingoExec, "cb_globalassign: assigning to %s", name.c_str());
 	Datum source = g_lingo->pop();
-	g_lingo->varAssign(target, source);
+	g_lingo->varAssign(GLOBALREF, name, source);
 }
 
 void LC::cb_objectfieldassign() {
@@ -683,22 +678,17 @@ void LC::cb_thepush2() {
 
 void LC::cb_varpush() {
 	Common::String name = g_lingo->readString();
-	Datum target(name);
-	target.type = LOCALREF;
 	debugC(3, kDebugLingoExec, "cb_varpush: pushing %s to stack", name.c_str());
-	Datum result = g_lingo->varFetch(target);
-	g_lingo->push(result);
+	g_lingo->push(g_lingo->varFetch(LOCALREF, name));
 }
 
 
 void LC::cb_varassign() {
 	Common::String name = g_lingo->readString();
-	Datum target(name);
-	target.type = LOCALREF;
 	debugC(3, kDebugLingoExec, "cb_varassign: assigning to %s", name.c_str());
 	Datum source = g_lingo->pop();
 	// Local variables should be initialised by the script, no varCreate here
-	g_lingo->varAssign(target, source);
+	g_lingo->varAssign(LOCALREF, name, source);
 }
 
 
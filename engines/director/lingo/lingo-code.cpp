@@ -186,7 +186,7 @@ void Lingo::cleanupFuncs() {
 }
 
 void Lingo::push(Datum d) {
-	_state->stack.push_back(d);
+	_state->stack.push_back(Common::move(d));
 }
 
 Datum Lingo::getVoid() {
@@ -204,7 +204,7 @@ void Lingo::pushVoid() {
 Datum Lingo::pop() {
 	assert (_state->stack.size() != 0);
 
-	Datum ret = _state->stack.back();
+	Datum ret = Common::move(_state->stack.back());
 	_state->stack.pop_back();
 
 	return ret;
@@ -548,27 +548,23 @@ void LC::c_proprefpush() {
 }
 
 void LC::c_varpush() {
-	LC::c_varrefpush();
-	Datum d = g_lingo->pop();
-	g_lingo->push(g_lingo->varFetch(d));
+	Common::String name(g_lingo->readString());
+	g_lingo->push(g_lingo->varFetch(VARREF, name));
 }
 
 void LC::c_globalpush() {
-	LC::c_globalrefpush();
-	Datum d = g_lingo->pop();
-	g_lingo->push(g_lingo->varFetch(d));
+	Common::String name(g_lingo->readString());
+	g_lingo->push(g_lingo->varFetch(GLOBALREF, name));
 }
 
 void LC::c_localpush() {
-	LC::c_localrefpush();
-	Datum d = g_lingo->pop();
-	g_lingo->push(g_lingo->varFetch(d));
+	Common::String name(g_lingo->readString());
+	g_lingo->push(g_lingo->varFetch(LOCALREF, name));
 }
 
 void LC::c_proppush() {
-	LC::c_proprefpush();
-	Datum d = g_lingo->pop();
-	g_lingo->push(g_lingo->varFetch(d));
+	Common::String name(g_lingo->readString());
+	g_lingo->push(g_lingo->varFetch(PROPREF, name));
 }
 
 void LC::c_stackpeek() {
@@ -896,29 +896,80 @@ int Lingo::getAlignedType(const Datum &d1, const Datum &d2, bool equality) {
 	return opType;
 }
 
+// Values of these types are not shared between copies of a Datum
+static bool isScalarType(DatumType type) {
+	switch (type) {
+	case ARGC:
+	case ARGCNORET:
+	case CASTLIBREF:
+	case FLOAT:
+	case INT:
+	case SPRITEREF:
+	case VOID:
+		return true;
+	default:
+		return false;
+	}
+}
+
+// A Datum without a reference count is the only owner of its value, so that
+// numbers and fresh values don't need one. It is allocated once the value
+// gets shared.
+static int *shareRefCount(const Datum &d) {
+	if (!d.refCount && !isScalarType(d.type)) {
+		d.refCount = new int;
+		*d.refCount = 1;
+	}
+	if (d.refCount)
+		*d.refCount += 1;
+	return d.refCount;
+}
+
 Datum::Datum() {
 	u.s = nullptr;
 	type = VOID;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
 Datum::Datum(const Datum &d) {
+	type = d.type;
+	u = d.u;
+	refCount = shareRefCount(d);
+	ignoreGlobal = false;
+}
+
+Datum::Datum(Datum &&d) {
 	type = d.type;
 	u = d.u;
 	refCount = d.refCount;
-	*refCount += 1;
 	ignoreGlobal = false;
+
+	d.u.s = nullptr;
+	d.type = VOID;
+	d.refCount = nullptr;
 }
 
 Datum& Datum::operator=(const Datum &d) {
-	if (this != &d && refCount != d.refCount) {
+	if (this != &d) {
+		// Copy first, d may be owned by our current value
+		Datum tmp(d);
+		*this = Common::move(tmp);
+	}
+	ignoreGlobal = false;
+	return *this;
+}
+
+Datum& Datum::operator=(Datum &&d) {
+	if (this != &d) {
 		reset();
 		type = d.type;
 		u = d.u;
 		refCount = d.refCount;
-		*refCount += 1;
+
+		d.u.s = nullptr;
+		d.type = VOID;
+		d.refCount = nullptr;
 	}
 	ignoreGlobal = false;
 	return *this;
@@ -927,24 +978,21 @@ Datum& Datum::operator=(const Datum &d) {
 Datum::Datum(int val) {
 	u.i = val;
 	type = INT;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
 Datum::Datum(double val) {
 	u.f = val;
 	type = FLOAT;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
 Datum::Datum(const Common::String &val) {
 	u.s = new Common::String(val);
 	type = STRING;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
@@ -956,8 +1004,7 @@ Datum::Datum(AbstractObject *val) {
 		*refCount += 1;
 	} else {
 		type = VOID;
-		refCount = new int;
-		*refCount = 1;
+		refCount = nullptr;
 	}
 	ignoreGlobal = false;
 }
@@ -970,8 +1017,7 @@ Datum::Datum(CastMember *val) {
 		*refCount += 1;
 	} else {
 		type = VOID;
-		refCount = new int;
-		*refCount = 1;
+		refCount = nullptr;
 	}
 	ignoreGlobal = false;
 }
@@ -979,8 +1025,7 @@ Datum::Datum(CastMember *val) {
 Datum::Datum(const CastMemberID &val) {
 	u.cast = new CastMemberID(val);
 	type = CASTREF;
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
@@ -989,8 +1034,7 @@ Datum::Datum(const Common::Point &point) {
 	u.farr = new FArray;
 	u.farr->arr.push_back(Datum(point.x));
 	u.farr->arr.push_back(Datum(point.y));
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
@@ -1001,21 +1045,18 @@ Datum::Datum(const Common::Rect &rect) {
 	u.farr->arr.push_back(Datum(rect.top));
 	u.farr->arr.push_back(Datum(rect.right));
 	u.farr->arr.push_back(Datum(rect.bottom));
-	refCount = new int;
-	*refCount = 1;
+	refCount = nullptr;
 	ignoreGlobal = false;
 }
 
 void Datum::reset() {
-	if (!refCount)
-		return;
-
-	*refCount -= 1;
+	if (refCount)
+		*refCount -= 1;
 	// Coverity thinks that we always free memory, as it assumes
 	// (correctly) that there are cases when refCount == 0
 	// Thus, DO NOT COMPILE, trick it and shut tons of false positives
 #ifndef __COVERITY__
-	if (*refCount <= 0) {
+	if (!refCount || *refCount <= 0) {
 		switch (type) {
 		case VOID:
 		case INT:
@@ -1047,7 +1088,8 @@ void Datum::reset() {
 		case OBJECT:
 			if (u.obj->getObjType() == kWindowObj) {
 				// Window has an override for decRefCount, use it directly
-				*refCount += 1;
+				if (refCount)
+					*refCount += 1;
 				static_cast<Window *>(u.obj)->decRefCount();
 			} else {
 				// *refCount is copied between the Datum and the Object,
@@ -1072,7 +1114,7 @@ void Datum::reset() {
 			warning("Datum::reset(): Unprocessed REF type %d", type);
 			break;
 		}
-		if (type != OBJECT && type != MEDIA) // object owns refCount
+		if (refCount && type != OBJECT && type != MEDIA) // object owns refCount
 			delete refCount;
 	}
 #endif
@@ -1723,55 +1765,66 @@ int Lingo::getInt(uint pc) {
 	return (int)READ_UINT32(&((*_state->script)[pc]));
 }
 
-void Lingo::varAssign(const Datum &var, const Datum &value) {
-	switch (var.type) {
+void Lingo::varAssign(DatumType refType, const Common::String &name, const Datum &value) {
+	switch (refType) {
 	case VARREF:
-		{
-			Common::String name = *var.u.s;
-			if (_state->localVars && _state->localVars->contains(name)) {
-				(*_state->localVars)[name] = value;
+		if (_state->localVars) {
+			DatumHash::iterator it = _state->localVars->find(name);
+			if (it != _state->localVars->end()) {
+				it->_value = value;
 				g_debugger->varWriteHook(name);
 				return;
 			}
-			if (_state->me.type == OBJECT && _state->me.u.obj->hasProp(name)) {
-				_state->me.u.obj->setProp(name, value);
-				g_debugger->varWriteHook(name);
-				return;
-			}
-			_globalvars[name] = value;
+		}
+		if (_state->me.type == OBJECT && _state->me.u.obj->hasProp(name)) {
+			_state->me.u.obj->setProp(name, value);
 			g_debugger->varWriteHook(name);
+			return;
 		}
+		_globalvars[name] = value;
+		g_debugger->varWriteHook(name);
 		break;
 	case GLOBALREF:
 		// Global variables declared by `global varname` within a handler are not listed anywhere
 		// in Lscr, unlike globals declared outside of a handler and every other variable type.
 		// So while we require other variable types to be initialized before assigning to them,
 		// let's not enforce that for globals.
-		_globalvars[*var.u.s] = value;
-		g_debugger->varWriteHook(*var.u.s);
+		_globalvars[name] = value;
+		g_debugger->varWriteHook(name);
 		break;
 	case LOCALREF:
-		{
-			Common::String name = *var.u.s;
-			if (_state->localVars && _state->localVars->contains(name)) {
-				(*_state->localVars)[name] = value;
+		if (_state->localVars) {
+			DatumHash::iterator it = _state->localVars->find(name);
+			if (it != _state->localVars->end()) {
+				it->_value = value;
 				g_debugger->varWriteHook(name);
-			} else {
-				warning("varAssign: local variable %s not defined", name.c_str());
+				return;
 			}
 		}
+		warning("varAssign: local variable %s not defined", name.c_str());
 		break;
 	case PROPREF:
-		{
-			Common::String name = *var.u.s;
-			if (_state->me.type == OBJECT && _state->me.u.obj->hasProp(name)) {
-				_state->me.u.obj->setProp(name, value);
-				g_debugger->varWriteHook(name);
-			} else {
-				warning("varAssign: property %s not defined", name.c_str());
-			}
+		if (_state->me.type == OBJECT && _state->me.u.obj->hasProp(name)) {
+			_state->me.u.obj->setProp(name, value);
+			g_debugger->varWriteHook(name);
+		} else {
+			warning("varAssign: property %s not defined", name.c_str());
 		}
 		break;
+	default:
+		warning("varAssign: assignment to non-variable");
+		break;
+	}
+}
+
+void Lingo::varAssign(const Datum &var, const Datum &value) {
+	switch (var.type) {
+	case VARREF:
+	case GLOBALREF:
+	case LOCALREF:
+	case PROPREF:
+		varAssign(var.type, *var.u.s, value);
+		break;
 	case FIELDREF:
 	case CASTREF:
 		{
@@ -1838,64 +1891,67 @@ void Lingo::varAssign(const Datum &var, const Datum &value) {
 	}
 }
 
-Datum Lingo::varFetch(const Datum &var, bool silent) {
-	Datum result;
+Datum Lingo::varFetch(DatumType refType, const Common::String &name, bool silent) {
+	g_debugger->varReadHook(name);
 
-	switch (var.type) {
+	switch (refType) {
 	case VARREF:
 		{
-			Datum d;
-			Common::String name = *var.u.s;
-			g_debugger->varReadHook(name);
-
-			if (_state->localVars && _state->localVars->contains(name)) {
-				return (*_state->localVars)[name];
+			if (_state->localVars) {
+				DatumHash::const_iterator it = _state->localVars->find(name);
+				if (it != _state->localVars->end())
+					return it->_value;
 			}
 			if (_state->me.type == OBJECT && _state->me.u.obj->hasProp(name)) {
 				return _state->me.u.obj->getProp(name);
 			}
-			if (_globalvars.contains(name)) {
-				return _globalvars[name];
-			}
+			DatumHash::const_iterator it = _globalvars.find(name);
+			if (it != _globalvars.end())
+				return it->_value;
 
 			if (!silent)
 				debugC(1, kDebugLingoExec, "varFetch: variable %s not found", name.c_str());
-			return result;
 		}
 		break;
 	case GLOBALREF:
 		{
-			Common::String name = *var.u.s;
-			g_debugger->varReadHook(name);
-			if (_globalvars.contains(name)) {
-				return _globalvars[name];
-			}
+			DatumHash::const_iterator it = _globalvars.find(name);
+			if (it != _globalvars.end())
+				return it->_value;
 			debugC(1, kDebugLingoExec, "varFetch: global variable %s not defined", name.c_str());
-			return result;
 		}
 		break;
 	case LOCALREF:
-		{
-			Common::String name = *var.u.s;
-			g_debugger->varReadHook(name);
-			if (_state->localVars && _state->localVars->contains(name)) {
-				return (*_state->localVars)[name];
-			}
-			debugC(1, kDebugLingoExec, "varFetch: local variable %s not defined", name.c_str());
-			return result;
+		if (_state->localVars) {
+			DatumHash::const_iterator it = _state->localVars->find(name);
+			if (it != _state->localVars->end())
+				return it->_value;
 		}
+		debugC(1, kDebugLingoExec, "varFetch: local variable %s not defined", name.c_str());
 		break;
 	case PROPREF:
-		{
-			Common::String name = *var.u.s;
-			g_debugger->varReadHook(name);
-			if (_state->me.type == OBJECT && _state->me.u.obj->hasProp(name)) {
-				return _state->me.u.obj->getProp(name);
-			}
-			warning("varFetch: property %s not defined", name.c_str());
-			return result;
+		if (_state->me.type == OBJECT && _state->me.u.obj->hasProp(name)) {
+			return _state->me.u.obj->getProp(name);
 		}
+		warning("varFetch: property %s not defined", name.c_str());
+		break;
+	default:
+		warning("varFetch: fetch from non-variable");
 		break;
+	}
+
+	return Datum();
+}
+
+Datum Lingo::varFetch(const Datum &var, bool silent) {
+	Datum result;
+
+	switch (var.type) {
+	case VARREF:
+	case GLOBALREF:
+	case LOCALREF:
+	case PROPREF:
+		return varFetch(var.type, *var.u.s, silent);
 	case FIELDREF:
 	case CASTREF:
 	case CHUNKREF:
@@ -144,13 +144,15 @@ struct Datum {	/* interpreter stack type */
 		PictureReference *picture; /* PICTUREREF */
 	} u;
 
-	int *refCount;
+	mutable int *refCount; // nullptr while the value is not shared, see shareRefCount()
 
 	bool ignoreGlobal; // True if this Datum should be ignored by showGlobals and clearGlobals
 
 	Datum();
 	Datum(const Datum &d);
+	Datum(Datum &&d);
 	Datum& operator=(const Datum &d);
+	Datum& operator=(Datum &&d);
 	Datum(int val);
 	Datum(double val);
 	Datum(const Common::String &val);
@@ -435,6 +437,9 @@ public:
 	void cleanLocalVars();
 	void varAssign(const Datum &var, const Datum &value);
 	Datum varFetch(const Datum &var, bool silent = false);
+	// Same as above for VARREF, GLOBALREF, LOCALREF and PROPREF, without building a reference first
+	void varAssign(DatumType refType, const Common::String &name, const Datum &value);
+	Datum varFetch(DatumType refType, const Common::String &name, bool silent = false);
 	Common::U32String evalChunkRef(const Datum &var);
 	Datum findVarV4(int varType, const Datum &id);
 	CastMemberID resolveCastMember(const Datum &memberID, const Datum &castLib, CastType type);
@@ -54,7 +54,9 @@
 #include "gui/saveload.h"
 #include "gui/unknown-game-dialog.h"
 
+#include "audio/decodedcache.h"
 #include "audio/mixer.h"
+#include "audio/readahead.h"
 
 #include "graphics/cursorman.h"
 #include "graphics/fontman.h"
@@ -218,6 +220,13 @@ Engine::Engine(OSystem *syst)
 Engine::~Engine() {
 	_mixer->stopAll();
 
+	// Decoded clips are keyed by file names, which only make sense for this game
+	if (Audio::DecodedAudioCache::hasInstance())
+		DecodedAudioCacheMan.clear();
+
+	// The decoders of the read-ahead streams stopped above are freed here
+	Audio::purgeReadAheadStreams();
+
 	// Flush any pending remaining events
 	Common::Event evt;
 	while (g_system->getEventManager()->pollEvent(evt)) {}
@@ -53,6 +53,9 @@ public:
 	bool loadStream(Common::SeekableReadStream *stream) override;
 
 protected:
+	// decodeNextFrame() reads and handles the frame itself
+	bool supportsDecodeAhead() const override { return false; }
+
 	bool readHeader();
 	void handleFrameDemo();
 	void handleFrame();
@@ -27,6 +27,7 @@
 #include "backends/keymapper/standard-actions.h"
 
 #include "common/savefile.h"
+#include "common/saveindex.h"
 #include "common/system.h"
 #include "common/translation.h"
 
@@ -392,6 +393,16 @@ SaveStateList MetaEngine::listSaves(const char *target) const {
 
 	filenames = saveFileMan->listSavefiles(pattern);
 
+	// Keep the save headers in an index beside the saves, so that they
+	// don't have to be read again. This requires all the slots to share it.
+	Common::String indexName = Common::SaveIndex::getIndexName(getSavegameFile(0, target));
+	if (indexName != Common::SaveIndex::getIndexName(getSavegameFile(1, target)))
+		indexName.clear();
+
+	Common::SaveIndex index;
+	if (!indexName.empty())
+		index.load(saveFileMan, indexName);
+
 	SaveStateList saveList;
 	for (const auto &file : filenames) {
 		// Obtain the last 2/3 digits of the filename, since they correspond to the save slot
@@ -402,13 +413,19 @@ SaveStateList MetaEngine::listSaves(const char *target) const {
 		int slotNum = atoi(slotStr);
 
 		if (slotNum >= 0 && slotNum <= getMaximumSaveSlot()) {
-			SaveStateDescriptor desc = querySaveMetaInfos(target, slotNum);
+			// Listing the saves does not need the thumbnails
+			SaveStateDescriptor desc = indexName.empty() ? querySaveMetaInfos(target, slotNum) : queryIndexedSaveMetaInfos(target, slotNum, index);
 			if (desc.getSaveSlot() != -1) {
 				saveList.push_back(desc);
 			}
 		}
 	}
 
+	if (!indexName.empty()) {
+		index.retain(filenames);
+		index.save(saveFileMan, indexName);
+	}
+
 	// Sort saves based on slot number.
 	Common::sort(saveList.begin(), saveList.end(), SaveStateDescriptorSlotComparator());
 	return saveList;
@@ -492,3 +509,45 @@ SaveStateDescriptor MetaEngine::querySaveMetaInfos(const char *target, int slot)
 
 	return SaveStateDescriptor();
 }
+
+SaveStateDescriptor MetaEngine::queryIndexedSaveMetaInfos(const char *target, int slot, Common::SaveIndex &index) const {
+	if (!hasFeature(kSavesUseExtendedFormat))
+		return SaveStateDescriptor();
+
+	Common::SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	const Common::String filename = getSavegameFile(slot, target);
+
+	Common::SaveIndexEntry stamp;
+	if (!saveFileMan->getSavefileStamp(filename, stamp.size, stamp.modTime))
+		return SaveStateDescriptor();
+
+	const Common::SaveIndexEntry *entry = index.find(filename);
+	if (!entry || entry->size != stamp.size || entry->modTime != stamp.modTime) {
+		Common::ScopedPtr<Common::InSaveFile> f(saveFileMan->openForLoading(filename));
+
+		ExtendedSavegameHeader header;
+		if (!f || !readSavegameHeader(f.get(), &header, true)) {
+			index.remove(filename);
+			return SaveStateDescriptor();
+		}
+
+		stamp.saveDate = header.date;
+		stamp.saveTime = header.time;
+		stamp.playTime = header.playtime;
+		stamp.isAutosave = header.isAutosave;
+		stamp.description = header.description;
+		index.set(filename, stamp);
+		entry = index.find(filename);
+	}
+
+	ExtendedSavegameHeader header;
+	header.date = entry->saveDate;
+	header.time = entry->saveTime;
+	header.playtime = entry->playTime;
+	header.description = entry->description;
+
+	SaveStateDescriptor desc(this, slot);
+	parseSavegameHeader(&header, &desc);
+	desc.setAutosave(entry->isAutosave);
+	return desc;
+}
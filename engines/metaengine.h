@@ -40,6 +40,7 @@ namespace Common {
 class Keymap;
 class FSList;
 class OutSaveFile;
+class SaveIndex;
 class String;
 
 typedef SeekableReadStream InSaveFile;
@@ -216,6 +217,21 @@ protected:
 	 */
 	int findEmptySaveSlot(const char *target);
 
+	/**
+	 * Return meta information from the specified save state for listSaves(),
+	 * taken from the save index of the target. The save header is only read
+	 * if the index entry is missing or out of date, and the thumbnail is
+	 * left out.
+	 *
+	 * MetaEngines which override querySaveMetaInfos() but not listSaves()
+	 * must override this as well, usually to call querySaveMetaInfos().
+	 *
+	 * @param target  Name of a config manager target.
+	 * @param slot    Slot number of the save state.
+	 * @param index   The save index of the target, updated as needed.
+	 */
+	virtual SaveStateDescriptor queryIndexedSaveMetaInfos(const char *target, int slot, Common::SaveIndex &index) const;
+
 	/**
 	 * Return a list of extra GUI options for the specified target.
 	 *
@@ -123,6 +123,9 @@ public:
 
 	int getMaximumSaveSlot() const override;
 	SaveStateDescriptor querySaveMetaInfos(const char *target, int slot) const override;
+	SaveStateDescriptor queryIndexedSaveMetaInfos(const char *target, int slot, Common::SaveIndex &index) const override {
+		return querySaveMetaInfos(target, slot);
+	}
 
 	Common::KeymapArray initKeymaps(const char *target) const override;
 
@@ -30,6 +30,7 @@
 #include "sci/version.h"
 #include "sci/engine/state.h"
 #include "sci/engine/kernel.h"
+#include "sci/engine/kpathing.h"
 #include "sci/engine/selector.h"
 #include "sci/engine/savegame.h"
 #include "sci/engine/gc.h"
@@ -163,6 +164,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("gc_reachable",		WRAP_METHOD(Console, cmdGCShowReachable));
 	registerCmd("gc_freeable",		WRAP_METHOD(Console, cmdGCShowFreeable));
 	registerCmd("gc_normalize",		WRAP_METHOD(Console, cmdGCNormalize));
+	registerCmd("gc_stats",			WRAP_METHOD(Console, cmdGCStats));
 	// Music/SFX
 	registerCmd("songlib",			WRAP_METHOD(Console, cmdSongLib));
 	registerCmd("songinfo",			WRAP_METHOD(Console, cmdSongInfo));
@@ -233,6 +235,8 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("bpe",				WRAP_METHOD(Console, cmdBreakpointFunction));		// alias
 	// VM
 	registerCmd("script_steps",		WRAP_METHOD(Console, cmdScriptSteps));
+	registerCmd("selector_cache",	WRAP_METHOD(Console, cmdSelectorCache));
+	registerCmd("path_stats",		WRAP_METHOD(Console, cmdPathStats));
 	registerCmd("script_objects",   WRAP_METHOD(Console, cmdScriptObjects));
 	registerCmd("scro",             WRAP_METHOD(Console, cmdScriptObjects));
 	registerCmd("script_strings",   WRAP_METHOD(Console, cmdScriptStrings));
@@ -398,6 +402,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" gc_reachable - Lists all addresses directly reachable from a given memory object\n");
 	debugPrintf(" gc_freeable - Lists all addresses freeable in a given segment\n");
 	debugPrintf(" gc_normalize - Prints the \"normal\" address of a given address\n");
+	debugPrintf(" gc_stats - Shows the pause times of the garbage collector\n");
 	debugPrintf("\n");
 	debugPrintf("Music/SFX:\n");
 	debugPrintf(" songlib - Shows the song library\n");
@@ -447,6 +452,8 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf("\n");
 	debugPrintf("VM:\n");
 	debugPrintf(" script_steps - Shows the number of executed SCI operations\n");
+	debugPrintf(" selector_cache - Shows the hit rate of the selector lookup cache\n");
+	debugPrintf(" path_stats - Shows the time spent in kAvoidPath per room\n");
 	debugPrintf(" script_objects / scro - Shows all objects inside a specified script\n");
 	debugPrintf(" script_strings / scrs - Shows all strings inside a specified script\n");
 	debugPrintf(" script_said - Shows all said - strings inside a specified script\n");
@@ -2904,6 +2911,30 @@ bool Console::cmdGCShowFreeable(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdGCStats(int argc, const char **argv) {
+	GCState *gc = _engine->_gamestate->_gcState;
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		if (gc)
+			gc->resetStats();
+		debugPrintf("Garbage collector statistics reset\n");
+		return true;
+	}
+
+	if (!gc || !gc->_collections) {
+		debugPrintf("No garbage collection has been performed yet\n");
+		return true;
+	}
+
+	debugPrintf("Collections: %u\n", gc->_collections);
+	debugPrintf("Pause times: last %u ms, max %u ms, average %.1f ms\n",
+		gc->_lastPause, gc->_maxPause, (double)gc->_totalPause / gc->_collections);
+	debugPrintf("Last collection: %u reachable references, %u entries freed\n", gc->_lastReachable, gc->_lastFreed);
+	debugPrintf("Entries freed in total: %u\n", gc->_totalFreed);
+	debugPrintf("Use \"%s reset\" to reset the statistics\n", argv[0]);
+	return true;
+}
+
 bool Console::cmdGCNormalize(int argc, const char **argv) {
 	if (argc != 2) {
 		debugPrintf("Prints the \"normal\" address of a given address,\n");
@@ -3436,6 +3467,52 @@ bool Console::cmdScriptSteps(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdSelectorCache(int argc, const char **argv) {
+	SelectorLookupCache &cache = _engine->_gamestate->_segMan->getSelectorLookupCache();
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		cache._hits = cache._misses = cache._flushes = 0;
+		debugPrintf("Selector lookup cache statistics reset\n");
+		return true;
+	}
+
+	const uint32 lookups = cache._hits + cache._misses;
+	debugPrintf("Selector lookups: %u, hits: %u (%.1f%%), misses: %u, flushes: %u\n",
+		lookups, cache._hits, lookups ? cache._hits * 100.0 / lookups : 0.0, cache._misses, cache._flushes);
+	debugPrintf("Use \"%s reset\" to reset the statistics\n", argv[0]);
+	return true;
+}
+
+bool Console::cmdPathStats(int argc, const char **argv) {
+	PathfindingCache *cache = _engine->_gamestate->_pathfindingCache;
+
+	if (argc == 2 && !scumm_stricmp(argv[1], "reset")) {
+		if (cache)
+			cache->resetRoomStats();
+		debugPrintf("Pathfinding statistics reset\n");
+		return true;
+	}
+
+	if (!cache || cache->getAllRoomStats().empty()) {
+		debugPrintf("No paths have been computed yet\n");
+		return true;
+	}
+
+	Common::Array<uint16> rooms;
+	for (PathfindingCache::RoomStatsMap::const_iterator it = cache->getAllRoomStats().begin(); it != cache->getAllRoomStats().end(); ++it)
+		rooms.push_back(it->_key);
+	Common::sort(rooms.begin(), rooms.end());
+
+	debugPrintf("Room  Paths  Cached  Visibility tests  Total ms  Avg ms  Max ms\n");
+	for (uint i = 0; i < rooms.size(); i++) {
+		const PathfindingCache::RoomStats &stats = cache->getRoomStats(rooms[i]);
+		debugPrintf("%4d  %5u  %6u  %16u  %8u  %6.1f  %6u\n", rooms[i], stats.queries, stats.cachedQueries,
+			stats.visibilityTests, stats.totalTime, (double)stats.totalTime / stats.queries, stats.maxTime);
+	}
+	debugPrintf("Use \"%s reset\" to reset the statistics\n", argv[0]);
+	return true;
+}
+
 bool Console::cmdScriptObjects(int argc, const char **argv) {
 	if (argc < 2) {
 		debugPrintf("Shows all objects inside a specified script.\n");
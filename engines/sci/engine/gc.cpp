@@ -21,6 +21,7 @@
 
 #include "sci/engine/gc.h"
 #include "common/array.h"
+#include "common/system.h"
 #include "sci/graphics/ports.h"
 
 #ifdef ENABLE_SCI32
@@ -67,20 +68,26 @@ void WorklistManager::pushArray(const Common::Array<reg_t> &tmp) {
 		push(*it);
 }
 
-static AddrSet *normalizeAddresses(SegManager *segMan, const AddrSet &nonnormal_map) {
-	AddrSet *normal_map = new AddrSet();
+void GCState::resetStats() {
+	_collections = 0;
+	_lastPause = 0;
+	_maxPause = 0;
+	_totalPause = 0;
+	_lastReachable = 0;
+	_lastFreed = 0;
+	_totalFreed = 0;
+}
 
+static void normalizeAddresses(SegManager *segMan, const AddrSet &nonnormal_map, AddrSet &normal_map) {
 	for (AddrSet::const_iterator i = nonnormal_map.begin(); i != nonnormal_map.end(); ++i) {
 		reg_t reg = i->_key;
 		SegmentObj *mobj = segMan->getSegmentObj(reg.getSegment());
 
 		if (mobj) {
 			reg = mobj->findCanonicAddress(segMan, reg);
-			normal_map->setVal(reg, true);
+			normal_map.setVal(reg, true);
 		}
 	}
-
-	return normal_map;
 }
 
 static void processWorkList(SegManager *segMan, WorklistManager &wm, const Common::Array<SegmentObj *> &heap) {
@@ -98,11 +105,9 @@ static void processWorkList(SegManager *segMan, WorklistManager &wm, const Commo
 	}
 }
 
-AddrSet *findAllActiveReferences(EngineState *s) {
+static void markActiveReferences(EngineState *s, WorklistManager &wm) {
 	assert(!s->_executionStack.empty());
 
-	WorklistManager wm;
-
 	// Initialize registers
 	wm.push(s->r_acc);
 	wm.push(s->r_prev);
@@ -174,13 +179,26 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 
 	if (g_sci->_gfxPorts)
 		g_sci->_gfxPorts->processEngineHunkList(wm);
+}
+
+AddrSet *findAllActiveReferences(EngineState *s) {
+	WorklistManager wm;
+	markActiveReferences(s, wm);
 
-	return normalizeAddresses(s->_segMan, wm._map);
+	AddrSet *normal_map = new AddrSet();
+	normalizeAddresses(s->_segMan, wm._map, *normal_map);
+	return normal_map;
 }
 
 void run_gc(EngineState *s) {
 	SegManager *segMan = s->_segMan;
 
+	if (!s->_gcState)
+		s->_gcState = new GCState();
+	GCState &gc = *s->_gcState;
+	const uint32 startTime = g_system->getMillis();
+	uint32 freed = 0;
+
 	// Some debug stuff
 	debugC(kDebugLevelGC, "[GC] Running...");
 #ifdef GC_DEBUG_CODE
@@ -191,7 +209,12 @@ void run_gc(EngineState *s) {
 #endif
 
 	// Compute the set of all segments references currently in use.
-	AddrSet *activeRefs = findAllActiveReferences(s);
+	// Clearing the sets keeps their storage for the next collection.
+	gc._marks._map.clear();
+	gc._activeRefs.clear();
+	markActiveReferences(s, gc._marks);
+	normalizeAddresses(segMan, gc._marks._map, gc._activeRefs);
+	const AddrSet *activeRefs = &gc._activeRefs;
 
 	// Iterate over all segments, and check for each whether it
 	// contains stuff that can be collected.
@@ -213,6 +236,7 @@ void run_gc(EngineState *s) {
 				if (!activeRefs->contains(addr)) {
 					// Not found -> we can free it
 					mobj->freeAtAddress(segMan, addr);
+					freed++;
 					debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
 #ifdef GC_DEBUG_CODE
 					segcount[type]++;
@@ -223,7 +247,15 @@ void run_gc(EngineState *s) {
 		}
 	}
 
-	delete activeRefs;
+	const uint32 pause = g_system->getMillis() - startTime;
+	gc._collections++;
+	gc._lastPause = pause;
+	gc._maxPause = MAX(gc._maxPause, pause);
+	gc._totalPause += pause;
+	gc._lastReachable = activeRefs->size();
+	gc._lastFreed = freed;
+	gc._totalFreed += freed;
+	debugC(kDebugLevelGC, "[GC] Done in %u ms, %u reachable references, %u entries freed", pause, gc._lastReachable, freed);
 
 #ifdef GC_DEBUG_CODE
 	// Output debug summary of garbage collection
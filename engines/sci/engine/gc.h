@@ -62,6 +62,28 @@ struct WorklistManager {
 	void pushArray(const Common::Array<reg_t> &tmp);
 };
 
+/**
+ * Garbage collector state kept between collections. The reference sets are
+ * reused, so that their storage doesn't need to be grown again every time.
+ */
+struct GCState {
+	WorklistManager _marks;
+	AddrSet _activeRefs;	// normalised references of the last collection
+
+	// Statistics, for the debugger. Times are in milliseconds.
+	uint32 _collections;
+	uint32 _lastPause;
+	uint32 _maxPause;
+	uint32 _totalPause;
+	uint32 _lastReachable;
+	uint32 _lastFreed;
+	uint32 _totalFreed;
+
+	GCState() { resetStats(); }
+
+	void resetStats();
+};
+
 
 } // End of namespace Sci
 
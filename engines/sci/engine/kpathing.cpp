@@ -23,6 +23,7 @@
 #include "sci/engine/state.h"
 #include "sci/engine/selector.h"
 #include "sci/engine/kernel.h"
+#include "sci/engine/kpathing.h"
 #include "sci/graphics/paint16.h"
 #include "sci/graphics/palette16.h"
 #include "sci/graphics/screen.h"
@@ -116,10 +117,14 @@ struct Vertex {
 	// Previous vertex in shortest path
 	Vertex *path_prev;
 
+	// Index in the cached visibility graph, -1 if not part of it
+	int graphIndex;
+
 public:
 	Vertex(const Common::Point &p) : v(p) {
 		costG = HUGE_DISTANCE;
 		path_prev = nullptr;
+		graphIndex = -1;
 	}
 };
 
@@ -241,6 +246,66 @@ public:
 
 typedef Common::List<Polygon *> PolygonList;
 
+// Visibility graph of a polygon set, before the start and end points are merged into it
+struct VisibilityGraph {
+	// Polygon set the graph belongs to, see convert_polygon_set()
+	Common::Array<int16> key;
+	uint32 hash;
+
+	// For each vertex, the vertices visible from it in ascending order,
+	// only valid if computed is set
+	Common::Array<Common::Array<uint16> > visible;
+	Common::Array<bool> computed;
+
+	VisibilityGraph(const Common::Array<int16> &k, uint32 h, uint vertexCount) : key(k), hash(h) {
+		visible.resize(vertexCount);
+		computed.resize(vertexCount);
+		for (uint i = 0; i < vertexCount; i++)
+			computed[i] = false;
+	}
+};
+
+static uint32 hashPolygonKey(const Common::Array<int16> &key) {
+	// FNV-1a
+	uint32 hash = 2166136261u;
+	for (uint i = 0; i < key.size(); i++) {
+		hash = (hash ^ (uint16)key[i]) * 16777619u;
+	}
+	return hash;
+}
+
+PathfindingCache::~PathfindingCache() {
+	for (Common::List<VisibilityGraph *>::iterator it = _graphs.begin(); it != _graphs.end(); ++it)
+		delete *it;
+}
+
+VisibilityGraph *PathfindingCache::getGraph(const Common::Array<int16> &key, uint vertexCount, bool &created) {
+	const uint32 hash = hashPolygonKey(key);
+
+	for (Common::List<VisibilityGraph *>::iterator it = _graphs.begin(); it != _graphs.end(); ++it) {
+		VisibilityGraph *graph = *it;
+		if (graph->hash == hash && graph->key == key) {
+			// Move it to the front, so that the least recently used one gets dropped first
+			if (it != _graphs.begin()) {
+				_graphs.erase(it);
+				_graphs.push_front(graph);
+			}
+			created = false;
+			return graph;
+		}
+	}
+
+	if (_graphs.size() >= kMaxGraphs) {
+		delete _graphs.back();
+		_graphs.pop_back();
+	}
+
+	VisibilityGraph *graph = new VisibilityGraph(key, hash, vertexCount);
+	_graphs.push_front(graph);
+	created = true;
+	return graph;
+}
+
 // Pathfinding state
 struct PathfindingState {
 	// List of all polygons
@@ -255,6 +320,15 @@ struct PathfindingState {
 	// Total number of vertices
 	int vertices;
 
+	// Cached visibility graph of the polygon set, or NULL if it can't be used.
+	// The vertices that are not part of it come first in vertex_index.
+	VisibilityGraph *graph;
+	int extraVertices;
+	bool graphReused;
+
+	// Number of vertex pairs tested for visibility
+	uint32 visibilityTests;
+
 	// Point to prepend and append to final path
 	Common::Point *_prependPoint;
 	Common::Point *_appendPoint;
@@ -269,6 +343,10 @@ struct PathfindingState {
 		_prependPoint = nullptr;
 		_appendPoint = nullptr;
 		vertices = 0;
+		graph = nullptr;
+		extraVertices = 0;
+		graphReused = false;
+		visibilityTests = 0;
 	}
 
 	~PathfindingState() {
@@ -698,6 +776,41 @@ static int inside(const Common::Point &p, Vertex *vertex) {
 	return 0;
 }
 
+/**
+ * Determines whether a vertex is visible from another one.
+ * @param s				the pathfinding state
+ * @param vertex_cur	the vertex to look from
+ * @param vertex		the vertex to check
+ * @return true if vertex is visible from vertex_cur
+ */
+static bool isVisible(PathfindingState *s, Vertex *vertex_cur, Vertex *vertex) {
+	// Make sure we don't intersect a polygon locally at the vertices
+	if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
+		return false;
+
+	s->visibilityTests++;
+
+	// Check for intersecting edges
+	for (int j = 0; j < s->vertices; j++) {
+		Vertex *edge = s->vertex_index[j];
+		if (VERTEX_HAS_EDGES(edge)) {
+			if (between(vertex_cur->v, vertex->v, edge->v)) {
+				// If we hit a vertex, make sure we can pass through it without intersecting its polygon
+				if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
+					return false;
+
+				// This edge won't properly intersect, so we continue
+				continue;
+			}
+
+			if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
+				return false;
+		}
+	}
+
+	return true;
+}
+
 /**
  * Returns a list of all vertices that are visible from a particular vertex.
  * @param s				the pathfinding state
@@ -707,36 +820,41 @@ static int inside(const Common::Point &p, Vertex *vertex) {
 static VertexList *visible_vertices(PathfindingState *s, Vertex *vertex_cur) {
 	VertexList *visVerts = new VertexList();
 
-	for (int i = 0; i < s->vertices; i++) {
-		Vertex *vertex = s->vertex_index[i];
+	if (!s->graph || vertex_cur->graphIndex < 0) {
+		for (int i = 0; i < s->vertices; i++) {
+			Vertex *vertex = s->vertex_index[i];
 
-		// Make sure we don't intersect a polygon locally at the vertices
-		if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
-			continue;
-
-		// Check for intersecting edges
-		int j;
-		for (j = 0; j < s->vertices; j++) {
-			Vertex *edge = s->vertex_index[j];
-			if (VERTEX_HAS_EDGES(edge)) {
-				if (between(vertex_cur->v, vertex->v, edge->v)) {
-					// If we hit a vertex, make sure we can pass through it without intersecting its polygon
-					if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
-						break;
+			if (isVisible(s, vertex_cur, vertex))
+				visVerts->push_front(vertex);
+		}
 
-					// This edge won't properly intersect, so we continue
-					continue;
-				}
+		return visVerts;
+	}
 
-				if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
-					break;
-			}
-		}
+	// The vertices of the start and end points are never part of the graph.
+	// They have no edges, so they can't change the visibility between the
+	// other vertices. The list is built in the same order as above.
+	for (int i = 0; i < s->extraVertices; i++) {
+		Vertex *vertex = s->vertex_index[i];
 
-		if (j == s->vertices)
+		if (isVisible(s, vertex_cur, vertex))
 			visVerts->push_front(vertex);
 	}
 
+	const uint index = vertex_cur->graphIndex;
+	Common::Array<uint16> &visible = s->graph->visible[index];
+
+	if (!s->graph->computed[index]) {
+		for (int i = s->extraVertices; i < s->vertices; i++) {
+			if (isVisible(s, vertex_cur, s->vertex_index[i]))
+				visible.push_back(i - s->extraVertices);
+		}
+		s->graph->computed[index] = true;
+	}
+
+	for (uint i = 0; i < visible.size(); i++)
+		visVerts->push_front(s->vertex_index[s->extraVertices + visible[i]]);
+
 	return visVerts;
 }
 
@@ -1326,6 +1444,27 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 		}
 	}
 
+	// Look up the visibility graph of the remaining polygons. The polygons
+	// are identified by their vertices, as their types don't matter here.
+	Common::Array<int16> key;
+	uint graphVertices = 0;
+
+	for (PolygonList::iterator it = pf_s->polygons.begin(); it != pf_s->polygons.end(); ++it) {
+		polygon = *it;
+		Vertex *vertex;
+
+		key.push_back(polygon->vertices.size());
+		CLIST_FOREACH(vertex, &polygon->vertices) {
+			key.push_back(vertex->v.x);
+			key.push_back(vertex->v.y);
+			graphVertices++;
+		}
+	}
+
+	bool created = false;
+	VisibilityGraph *graph = s->_pathfindingCache ? s->_pathfindingCache->getGraph(key, graphVertices, created) : nullptr;
+	const uint polygonCount = pf_s->polygons.size();
+
 	// Merge start and end points into polygon set
 	pf_s->vertex_start = merge_point(pf_s, *new_start);
 	pf_s->vertex_end = merge_point(pf_s, *new_end);
@@ -1349,6 +1488,18 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 
 	pf_s->vertices = count;
 
+	// Merged points that are not on an edge were added as single-vertex
+	// polygons in front of the others. If a point split an edge instead,
+	// the polygons differ from the cached ones and the graph can't be used.
+	const int extraVertices = pf_s->polygons.size() - polygonCount;
+	if (graph && count == (int)graphVertices + extraVertices) {
+		for (int i = extraVertices; i < count; i++)
+			pf_s->vertex_index[i]->graphIndex = i - extraVertices;
+		pf_s->graph = graph;
+		pf_s->extraVertices = extraVertices;
+		pf_s->graphReused = !created;
+	}
+
 	return pf_s;
 }
 
@@ -1611,6 +1762,10 @@ reg_t kAvoidPath(EngineState *s, int argc, reg_t *argv) {
 			}
 		}
 
+		if (!s->_pathfindingCache)
+			s->_pathfindingCache = new PathfindingCache();
+
+		const uint32 startTime = g_system->getMillis();
 		PathfindingState *p = convert_polygon_set(s, poly_list, start, end, width, height, opt);
 
 		if (!p) {
@@ -1632,6 +1787,16 @@ reg_t kAvoidPath(EngineState *s, int argc, reg_t *argv) {
 		AStar(p);
 
 		output = output_path(p, s);
+
+		const uint32 elapsed = g_system->getMillis() - startTime;
+		PathfindingCache::RoomStats &stats = s->_pathfindingCache->getRoomStats(s->currentRoomNumber());
+		stats.queries++;
+		if (p->graphReused)
+			stats.cachedQueries++;
+		stats.visibilityTests += p->visibilityTests;
+		stats.totalTime += elapsed;
+		stats.maxTime = MAX(stats.maxTime, elapsed);
+
 		delete p;
 
 		// Memory is freed by explicit calls to Memory
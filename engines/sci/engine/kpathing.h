@@ -0,0 +1,83 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SCI_ENGINE_KPATHING_H
+#define SCI_ENGINE_KPATHING_H
+
+#include "common/array.h"
+#include "common/hashmap.h"
+#include "common/list.h"
+
+namespace Sci {
+
+struct VisibilityGraph;
+
+/**
+ * Keeps the visibility graphs of the polygon sets recently used by
+ * kAvoidPath, so that rooms whose obstacles don't change don't need to
+ * compute them again for every path. Also collects pathfinding statistics
+ * per room for the debugger.
+ */
+class PathfindingCache {
+public:
+	struct RoomStats {
+		uint32 queries;
+		uint32 cachedQueries;     ///< Queries that used an existing visibility graph
+		uint32 visibilityTests;   ///< Number of vertex pairs tested for visibility
+		uint32 totalTime;         ///< In milliseconds
+		uint32 maxTime;           ///< In milliseconds
+
+		RoomStats() : queries(0), cachedQueries(0), visibilityTests(0), totalTime(0), maxTime(0) {}
+	};
+
+	typedef Common::HashMap<uint16, RoomStats> RoomStatsMap;
+
+	PathfindingCache() {}
+	~PathfindingCache();
+
+	/**
+	 * Return the visibility graph of the polygon set described by the key,
+	 * creating an empty one if it is not cached.
+	 *
+	 * @param key          The types and vertices of all the polygons.
+	 * @param vertexCount  The total number of vertices of the polygons.
+	 * @param created      Set to whether the graph was created.
+	 */
+	VisibilityGraph *getGraph(const Common::Array<int16> &key, uint vertexCount, bool &created);
+
+	RoomStats &getRoomStats(uint16 roomNumber) { return _roomStats[roomNumber]; }
+	const RoomStatsMap &getAllRoomStats() const { return _roomStats; }
+	void resetRoomStats() { _roomStats.clear(); }
+
+private:
+	enum {
+		kMaxGraphs = 8
+	};
+
+	/** The cached graphs, most recently used first. */
+	Common::List<VisibilityGraph *> _graphs;
+
+	RoomStatsMap _roomStats;
+};
+
+} // End of namespace Sci
+
+#endif // SCI_ENGINE_KPATHING_H
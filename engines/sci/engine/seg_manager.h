@@ -437,6 +437,12 @@ public:
 	void setClassOffset(int index, reg_t offset) { _classTable[index].reg = offset;	}
 	void resizeClassTable(uint32 size) { _classTable.resize(size); }
 
+	/**
+	 * Cache for lookupSelector(). It is cleared whenever a script gets
+	 * instantiated or freed.
+	 */
+	SelectorLookupCache &getSelectorLookupCache() { return _selectorLookupCache; }
+
 	reg_t getSaveDirPtr() const { return _saveDirPtr; }
 	reg_t getParserPtr() const { return _parserPtr; }
 
@@ -469,6 +475,8 @@ private:
 	ResourceManager *_resMan;
 	ScriptPatcher *_scriptPatcher;
 
+	SelectorLookupCache _selectorLookupCache;
+
 	SegmentId _clonesSegId; ///< ID of the (a) clones segment
 	SegmentId _listsSegId; ///< ID of the (a) list segment
 	SegmentId _nodesSegId; ///< ID of the (a) node segment
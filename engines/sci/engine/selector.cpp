@@ -336,31 +336,52 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector sel
 		error("lookupSelector: Attempt to send to non-object or invalid script. Address %04x:%04x", PRINT_REG(obj_location));
 	}
 
-	int index = obj->locateVarSelector(segMan, selectorId);
+	const reg_t pos = obj->getPos();
+	const reg_t superClass = obj->getSuperClassSelector();
+	SelectorLookupCache &cache = segMan->getSelectorLookupCache();
+	SelectorLookupCache::Entry &entry = cache.getEntry(pos, superClass, selectorId);
 
-	if (index >= 0) {
-		// Found it as a variable
-		if (varp) {
-			varp->obj = obj_location;
-			varp->varindex = index;
-		}
-		return kSelectorVariable;
+	if (SelectorLookupCache::matches(entry, pos, superClass, selectorId)) {
+		cache._hits++;
 	} else {
-		// Check if it's a method, with recursive lookup in superclasses
-		while (obj) {
-			index = obj->funcSelectorPosition(selectorId);
-			if (index >= 0) {
-				if (fptr)
-					*fptr = obj->getFunction(index);
-
-				return kSelectorMethod;
-			} else {
-				obj = segMan->getObject(obj->getSuperClassSelector());
+		cache._misses++;
+		entry.pos = pos;
+		entry.superClass = superClass;
+		entry.selector = selectorId;
+		entry.type = kSelectorNone;
+
+		int index = obj->locateVarSelector(segMan, selectorId);
+
+		if (index >= 0) {
+			// Found it as a variable
+			entry.type = kSelectorVariable;
+			entry.varIndex = index;
+		} else {
+			// Check if it's a method, with recursive lookup in superclasses
+			while (obj) {
+				index = obj->funcSelectorPosition(selectorId);
+				if (index >= 0) {
+					entry.type = kSelectorMethod;
+					entry.func = obj->getFunction(index);
+					break;
+				} else {
+					obj = segMan->getObject(obj->getSuperClassSelector());
+				}
 			}
 		}
+	}
 
-		return kSelectorNone;
+	if (entry.type == kSelectorVariable) {
+		if (varp) {
+			varp->obj = obj_location;
+			varp->varindex = entry.varIndex;
+		}
+	} else if (entry.type == kSelectorMethod) {
+		if (fptr)
+			*fptr = entry.func;
 	}
+
+	return entry.type;
 }
 
 } // End of namespace Sci
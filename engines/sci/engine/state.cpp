@@ -24,8 +24,10 @@
 #include "sci/debug.h"	// for g_debug_sleeptime_factor
 #include "sci/engine/features.h"
 #include "sci/engine/file.h"
+#include "sci/engine/gc.h"
 #include "sci/engine/guest_additions.h"
 #include "sci/engine/kernel.h"
+#include "sci/engine/kpathing.h"
 #include "sci/engine/state.h"
 #include "sci/engine/selector.h"
 #include "sci/engine/vm.h"
@@ -68,7 +70,9 @@ static const uint16 s_halfWidthSJISMap[256] = {
 
 EngineState::EngineState(SegManager *segMan) :
 	_segMan(segMan),
+	_gcState(nullptr),
 	_msgState(nullptr),
+	_pathfindingCache(nullptr),
 	_dirseeker() {
 
 	reset(false);
@@ -76,6 +80,8 @@ EngineState::EngineState(SegManager *segMan) :
 
 EngineState::~EngineState() {
 	delete _msgState;
+	delete _pathfindingCache;
+	delete _gcState;
 }
 
 void EngineState::reset(bool isRestoring) {
@@ -45,7 +45,9 @@ namespace Sci {
 class FileHandle;
 class DirSeeker;
 class EventManager;
+struct GCState;
 class MessageState;
+class PathfindingCache;
 class SoundCommandParser;
 class VirtualIndexFile;
 
@@ -188,10 +190,13 @@ struct EngineState : public Common::Serializable {
 	void shrinkStackToBase();
 
 	int gcCountDown; /**< Number of kernel calls until next gc */
+	GCState *_gcState; /**< Reused gc data and statistics, created on first gc */
 
 	MessageState *_msgState;
 	void initMessageState();
 
+	PathfindingCache *_pathfindingCache; /**< Visibility graphs used by kAvoidPath, created on first use */
+
 	// MemorySegment provides access to a 256-byte block of memory that remains
 	// intact across restarts and restores
 	enum {
@@ -398,6 +398,56 @@ void run_vm(EngineState *s);
 SelectorType lookupSelector(SegManager *segMan, reg_t obj, Selector selectorid,
 		ObjVarRef *varp, reg_t *fptr);
 
+/**
+ * Cache for the results of lookupSelector(). Objects at the same script
+ * position with the same superclass resolve every selector the same way.
+ * This includes clones, which keep the position of the object they were
+ * cloned from. The cache is direct-mapped, so each lookup only needs a
+ * single comparison. It must be cleared whenever scripts get loaded, patched
+ * or freed.
+ */
+class SelectorLookupCache {
+public:
+	struct Entry {
+		reg_t pos;
+		reg_t superClass;
+		Selector selector;
+		SelectorType type;
+		int varIndex;   ///< Variable index, for kSelectorVariable
+		reg_t func;     ///< Method address, for kSelectorMethod
+	};
+
+	SelectorLookupCache() : _hits(0), _misses(0), _flushes(0) { clear(); }
+
+	/** Return the entry slot for the given lookup, which may hold another one. */
+	Entry &getEntry(reg_t pos, reg_t superClass, Selector selector) {
+		const uint32 hash = (pos.getSegment() * 0x9E3779B1) ^ (pos.getOffset() * 0x85EBCA6B) ^
+			(superClass.getOffset() * 0xC2B2AE35) ^ selector;
+		return _entries[(hash ^ (hash >> 15)) & (kEntryCount - 1)];
+	}
+
+	static bool matches(const Entry &entry, reg_t pos, reg_t superClass, Selector selector) {
+		return entry.selector == selector && entry.pos == pos && entry.superClass == superClass;
+	}
+
+	void clear() {
+		for (uint i = 0; i < kEntryCount; ++i)
+			_entries[i].selector = -1;
+		++_flushes;
+	}
+
+	uint32 _hits;
+	uint32 _misses;
+	uint32 _flushes;
+
+private:
+	enum {
+		kEntryCount = 1024
+	};
+
+	Entry _entries[kEntryCount];
+};
+
 /**
  * Read a PMachine instruction from a memory buffer and return its length.
  *
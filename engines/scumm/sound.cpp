@@ -33,6 +33,7 @@
 #include "scumm/sound.h"
 
 #include "audio/audiostream.h"
+#include "audio/decodedcache.h"
 #include "audio/decoders/flac.h"
 #include "audio/mididrv.h"
 #include "audio/mixer.h"
@@ -473,6 +474,25 @@ static Audio::AudioStream *checkForBrokenIndy4Sample(Common::SeekableReadStream
 	);
 }
 
+#if defined(USE_FLAC) || defined(USE_VORBIS) || defined(USE_MAD)
+typedef Audio::SeekableAudioStream *(*CompressedStreamFactory)(Common::SeekableReadStream *, DisposeAfterUse::Flag);
+
+// Speech and sound effects in compressed MONSTER.SOU files are short and often
+// repeated, so they are decoded once and then played from the decoded cache
+static Audio::AudioStream *makeCachedTalkStream(const Common::String &filename, Common::SeekableReadStream *file,
+												uint32 offset, uint32 size, uint32 codec, CompressedStreamFactory factory) {
+	const Audio::DecodedAudioCache::Key key(Common::Path(filename), offset, size, codec);
+
+	Audio::SeekableAudioStream *input = DecodedAudioCacheMan.find(key);
+	if (input) {
+		delete file;
+		return input;
+	}
+
+	return DecodedAudioCacheMan.insert(key, factory(new Common::SeekableSubReadStream(file, offset, offset + size, DisposeAfterUse::YES), DisposeAfterUse::YES));
+}
+#endif
+
 void Sound::startTalkSound(uint32 offset, uint32 length, int mode, Audio::SoundHandle *handle) {
 	int num = 0, i;
 	int id = -1;
@@ -746,7 +766,7 @@ void Sound::startTalkSound(uint32 offset, uint32 length, int mode, Audio::SoundH
 #ifdef USE_MAD
 			{
 			assert(size > 0);
-			input = Audio::makeMP3Stream(new Common::SeekableSubReadStream(file.release(), offset, offset + size, DisposeAfterUse::YES), DisposeAfterUse::YES);
+			input = makeCachedTalkStream(_sfxFilename, file.release(), offset, size, MKTAG('M','P','3',' '), Audio::makeMP3Stream);
 			}
 #endif
 			break;
@@ -754,7 +774,7 @@ void Sound::startTalkSound(uint32 offset, uint32 length, int mode, Audio::SoundH
 #ifdef USE_VORBIS
 			{
 			assert(size > 0);
-			input = Audio::makeVorbisStream(new Common::SeekableSubReadStream(file.release(), offset, offset + size, DisposeAfterUse::YES), DisposeAfterUse::YES);
+			input = makeCachedTalkStream(_sfxFilename, file.release(), offset, size, MKTAG('O','G','G','V'), Audio::makeVorbisStream);
 			}
 #endif
 			break;
@@ -762,7 +782,7 @@ void Sound::startTalkSound(uint32 offset, uint32 length, int mode, Audio::SoundH
 #ifdef USE_FLAC
 			{
 			assert(size > 0);
-			input = Audio::makeFLACStream(new Common::SeekableSubReadStream(file.release(), offset, offset + size, DisposeAfterUse::YES), DisposeAfterUse::YES);
+			input = makeCachedTalkStream(_sfxFilename, file.release(), offset, size, MKTAG('f','L','a','C'), Audio::makeFLACStream);
 			}
 #endif
 			break;
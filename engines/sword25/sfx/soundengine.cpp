@@ -36,6 +36,7 @@
 #include "sword25/kernel/outputpersistenceblock.h"
 
 #include "audio/audiostream.h"
+#include "audio/readahead.h"
 #include "audio/decoders/vorbis.h"
 
 #include "common/system.h"
@@ -244,6 +245,11 @@ uint SoundEngine::playSoundEx(const Common::String &fileName, SOUND_TYPES type,
 
 	Audio::SeekableAudioStream *stream = Audio::makeVorbisStream(in, DisposeAfterUse::YES);
 
+	// Decode ahead, so that the mixer never waits for the Vorbis decoder.
+	// The package files are unpacked into memory by getStream() above, so
+	// the read-ahead timer only reads from memory, never from the packages.
+	stream = Audio::makeReadAheadStream(stream);
+
 	if (loop) {
 		Audio::AudioStream *audio = new Audio::LoopingAudioStream(stream, 0, DisposeAfterUse::YES);
 
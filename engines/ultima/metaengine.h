@@ -50,6 +50,13 @@ public:
 	 */
 	SaveStateDescriptor querySaveMetaInfos(const char *target, int slot) const override;
 
+	/**
+	 * Return meta information for listSaves(), through querySaveMetaInfos().
+	 */
+	SaveStateDescriptor queryIndexedSaveMetaInfos(const char *target, int slot, Common::SaveIndex &index) const override {
+		return querySaveMetaInfos(target, slot);
+	}
+
 	/**
 	 * Initialize keymaps
 	 */
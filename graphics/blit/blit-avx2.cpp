@@ -22,6 +22,7 @@
 #include "common/scummsys.h"
 
 #include "graphics/blit/blit-alpha.h"
+#include "graphics/blit/blit-simd.h"
 #include "graphics/pixelformat.h"
 
 #include <immintrin.h>
@@ -321,6 +322,140 @@ void BlendBlit::blitAVX2(Args &args, const TSpriteBlendMode &blendMode, const Al
 	blitT<BlendBlitImpl_AVX2>(args, blendMode, alphaType);
 }
 
+namespace {
+
+/** The channel parameters of CrossBlitSIMD as shift counts and masks. */
+struct CrossBlitVectors_AVX2 {
+	__m128i srcShift[CrossBlitSIMD::kChannels];
+	__m256i srcMask[CrossBlitSIMD::kChannels];
+	__m128i expandLeft[CrossBlitSIMD::kChannels];
+	__m128i expandRight[CrossBlitSIMD::kChannels];
+	__m128i dstShift[CrossBlitSIMD::kChannels];
+	__m256i orMask;
+
+	CrossBlitVectors_AVX2(const CrossBlitSIMD::Params &params) {
+		for (int i = 0; i < CrossBlitSIMD::kChannels; i++) {
+			srcShift[i] = _mm_cvtsi32_si128(params.srcShift[i]);
+			srcMask[i] = _mm256_set1_epi32(params.srcMask[i]);
+			expandLeft[i] = _mm_cvtsi32_si128(params.expandLeft[i]);
+			expandRight[i] = _mm_cvtsi32_si128(params.expandRight[i]);
+			dstShift[i] = _mm_cvtsi32_si128(params.dstShift[i]);
+		}
+		orMask = _mm256_set1_epi32(params.orMask);
+	}
+
+	template<bool expand>
+	inline __m256i convert(__m256i color) const {
+		__m256i result = orMask;
+		for (int i = 0; i < CrossBlitSIMD::kChannels; i++) {
+			__m256i value = _mm256_and_si256(_mm256_srl_epi32(color, srcShift[i]), srcMask[i]);
+			if (expand)
+				value = _mm256_or_si256(_mm256_sll_epi32(value, expandLeft[i]), _mm256_srl_epi32(value, expandRight[i]));
+			result = _mm256_or_si256(result, _mm256_sll_epi32(value, dstShift[i]));
+		}
+		return result;
+	}
+};
+
+/** Pack the low halves of 16 32-bit values, in order. */
+static inline __m256i crossBlitPack16_AVX2(__m256i lo, __m256i hi) {
+	const __m256i mask = _mm256_set1_epi32(0xFFFF);
+	const __m256i packed = _mm256_packus_epi32(_mm256_and_si256(lo, mask), _mm256_and_si256(hi, mask));
+	return _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+static void crossBlitConvert16To32_AVX2(byte *dst, const byte *src, uint count, const CrossBlitSIMD::Params &params) {
+	const CrossBlitVectors_AVX2 vectors(params);
+
+	// Go backwards and load before storing, for in place conversions
+	uint i = count;
+	for (; i >= 16; i -= 16) {
+		const __m256i lo = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(src + (i - 16) * 2)));
+		const __m256i hi = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(src + (i - 8) * 2)));
+		_mm256_storeu_si256((__m256i *)(dst + (i - 8) * 4), vectors.convert<true>(hi));
+		_mm256_storeu_si256((__m256i *)(dst + (i - 16) * 4), vectors.convert<true>(lo));
+	}
+
+	for (; i > 0; --i)
+		((uint32 *)dst)[i - 1] = CrossBlitSIMD::convertPixel(((const uint16 *)src)[i - 1], params);
+}
+
+static void crossBlitConvert32To16_AVX2(byte *dst, const byte *src, uint count, const CrossBlitSIMD::Params &params) {
+	const CrossBlitVectors_AVX2 vectors(params);
+
+	uint i = 0;
+	for (; i + 16 <= count; i += 16) {
+		const __m256i lo = vectors.convert<false>(_mm256_loadu_si256((const __m256i *)(src + i * 4)));
+		const __m256i hi = vectors.convert<false>(_mm256_loadu_si256((const __m256i *)(src + i * 4 + 32)));
+		_mm256_storeu_si256((__m256i *)(dst + i * 2), crossBlitPack16_AVX2(lo, hi));
+	}
+
+	for (; i < count; ++i)
+		((uint16 *)dst)[i] = CrossBlitSIMD::convertPixel(((const uint32 *)src)[i], params);
+}
+
+static void crossBlitConvert32To32_AVX2(byte *dst, const byte *src, uint count, const CrossBlitSIMD::Params &params) {
+	// All the channels are bytes, so this is a byte shuffle. Destination
+	// bytes without a source channel are cleared.
+	byte control[16];
+	memset(control, 0x80, sizeof(control));
+	for (int i = 0; i < CrossBlitSIMD::kChannels; i++) {
+		for (int pixel = 0; pixel < 4; pixel++)
+			control[pixel * 4 + params.dstShift[i] / 8] = pixel * 4 + params.srcShift[i] / 8;
+	}
+	const __m256i shuffle = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)control));
+	const __m256i orMask = _mm256_set1_epi32(params.orMask);
+
+	uint i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m256i colors = _mm256_loadu_si256((const __m256i *)(src + i * 4));
+		_mm256_storeu_si256((__m256i *)(dst + i * 4), _mm256_or_si256(_mm256_shuffle_epi8(colors, shuffle), orMask));
+	}
+
+	for (; i < count; ++i)
+		((uint32 *)dst)[i] = CrossBlitSIMD::convertPixel(((const uint32 *)src)[i], params);
+}
+
+static void crossBlitMap8To16_AVX2(byte *dst, const byte *src, uint count, const uint32 *map) {
+	// Go backwards and load before storing, for in place conversions
+	uint i = count;
+	for (; i >= 16; i -= 16) {
+		const __m128i indices = _mm_loadu_si128((const __m128i *)(src + i - 16));
+		const __m256i lo = _mm256_i32gather_epi32((const int *)map, _mm256_cvtepu8_epi32(indices), 4);
+		const __m256i hi = _mm256_i32gather_epi32((const int *)map, _mm256_cvtepu8_epi32(_mm_srli_si128(indices, 8)), 4);
+		_mm256_storeu_si256((__m256i *)(dst + (i - 16) * 2), crossBlitPack16_AVX2(lo, hi));
+	}
+
+	for (; i > 0; --i)
+		((uint16 *)dst)[i - 1] = map[src[i - 1]];
+}
+
+static void crossBlitMap8To32_AVX2(byte *dst, const byte *src, uint count, const uint32 *map) {
+	// Go backwards and load before storing, for in place conversions
+	uint i = count;
+	for (; i >= 16; i -= 16) {
+		const __m128i indices = _mm_loadu_si128((const __m128i *)(src + i - 16));
+		const __m256i lo = _mm256_i32gather_epi32((const int *)map, _mm256_cvtepu8_epi32(indices), 4);
+		const __m256i hi = _mm256_i32gather_epi32((const int *)map, _mm256_cvtepu8_epi32(_mm_srli_si128(indices, 8)), 4);
+		_mm256_storeu_si256((__m256i *)(dst + (i - 8) * 4), hi);
+		_mm256_storeu_si256((__m256i *)(dst + (i - 16) * 4), lo);
+	}
+
+	for (; i > 0; --i)
+		((uint32 *)dst)[i - 1] = map[src[i - 1]];
+}
+
+} // End of anonymous namespace
+
+const CrossBlitSIMD::Kernels CrossBlitSIMD::kernelsAVX2 = {
+	"AVX2",
+	crossBlitConvert16To32_AVX2,
+	crossBlitConvert32To16_AVX2,
+	crossBlitConvert32To32_AVX2,
+	crossBlitMap8To16_AVX2,
+	crossBlitMap8To32_AVX2
+};
+
 } // End of namespace Graphics
 
 #if defined(__clang__)
@@ -20,6 +20,7 @@
  */
 
 #include "graphics/blit.h"
+#include "graphics/blit/blit-simd.h"
 #include "graphics/pixelformat.h"
 #include "common/endian.h"
 #include "common/system.h"
@@ -32,6 +33,11 @@ template<bool bswap, int rotate>
 static void swapBlit(byte *dst, const byte *src,
                      const uint dstPitch, const uint srcPitch,
                      const uint w, const uint h) {
+	CrossBlitSIMD::Params params;
+	CrossBlitSIMD::getSwapParams(bswap, rotate, params);
+	if (CrossBlitSIMD::crossBlit(dst, src, dstPitch, srcPitch, w, h, 4, 4, params))
+		return;
+
 	// Faster, but larger, to provide optimized handling for each case.
 	const uint srcDelta = (srcPitch - w * sizeof(uint32));
 	const uint dstDelta = (dstPitch - w * sizeof(uint32));
@@ -24,6 +24,7 @@
 #ifdef SCUMMVM_NEON
 
 #include "graphics/blit/blit-alpha.h"
+#include "graphics/blit/blit-simd.h"
 #include "graphics/pixelformat.h"
 
 #include <arm_neon.h>
@@ -376,6 +377,122 @@ void fastBlitNEON_XRGB1555_RGB565(byte *dst, const byte *src,
 	}
 }
 
+namespace {
+
+/**
+ * The channel parameters of CrossBlitSIMD as shift counts and masks. NEON
+ * shifts right with negative counts.
+ */
+struct CrossBlitVectors_NEON {
+	int32x4_t srcShift[CrossBlitSIMD::kChannels];
+	uint32x4_t srcMask[CrossBlitSIMD::kChannels];
+	int32x4_t expandLeft[CrossBlitSIMD::kChannels];
+	int32x4_t expandRight[CrossBlitSIMD::kChannels];
+	int32x4_t dstShift[CrossBlitSIMD::kChannels];
+	uint32x4_t orMask;
+
+	CrossBlitVectors_NEON(const CrossBlitSIMD::Params &params) {
+		for (int i = 0; i < CrossBlitSIMD::kChannels; i++) {
+			srcShift[i] = vdupq_n_s32(-(int32)params.srcShift[i]);
+			srcMask[i] = vdupq_n_u32(params.srcMask[i]);
+			expandLeft[i] = vdupq_n_s32(params.expandLeft[i]);
+			expandRight[i] = vdupq_n_s32(-(int32)params.expandRight[i]);
+			dstShift[i] = vdupq_n_s32(params.dstShift[i]);
+		}
+		orMask = vdupq_n_u32(params.orMask);
+	}
+
+	template<bool expand>
+	inline uint32x4_t convert(uint32x4_t color) const {
+		uint32x4_t result = orMask;
+		for (int i = 0; i < CrossBlitSIMD::kChannels; i++) {
+			uint32x4_t value = vandq_u32(vshlq_u32(color, srcShift[i]), srcMask[i]);
+			if (expand)
+				value = vorrq_u32(vshlq_u32(value, expandLeft[i]), vshlq_u32(value, expandRight[i]));
+			result = vorrq_u32(result, vshlq_u32(value, dstShift[i]));
+		}
+		return result;
+	}
+};
+
+static void crossBlitConvert16To32_NEON(byte *dst, const byte *src, uint count, const CrossBlitSIMD::Params &params) {
+	const CrossBlitVectors_NEON vectors(params);
+
+	// Go backwards and load before storing, for in place conversions
+	uint i = count;
+	for (; i >= 8; i -= 8) {
+		const uint16x8_t colors = vld1q_u16((const uint16 *)(src + (i - 8) * 2));
+		const uint32x4_t lo = vectors.convert<true>(vmovl_u16(vget_low_u16(colors)));
+		const uint32x4_t hi = vectors.convert<true>(vmovl_u16(vget_high_u16(colors)));
+		vst1q_u32((uint32 *)(dst + (i - 4) * 4), hi);
+		vst1q_u32((uint32 *)(dst + (i - 8) * 4), lo);
+	}
+
+	for (; i > 0; --i)
+		((uint32 *)dst)[i - 1] = CrossBlitSIMD::convertPixel(((const uint16 *)src)[i - 1], params);
+}
+
+static void crossBlitConvert32To16_NEON(byte *dst, const byte *src, uint count, const CrossBlitSIMD::Params &params) {
+	const CrossBlitVectors_NEON vectors(params);
+
+	uint i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const uint32x4_t lo = vectors.convert<false>(vld1q_u32((const uint32 *)(src + i * 4)));
+		const uint32x4_t hi = vectors.convert<false>(vld1q_u32((const uint32 *)(src + i * 4 + 16)));
+		vst1q_u16((uint16 *)(dst + i * 2), vcombine_u16(vmovn_u32(lo), vmovn_u32(hi)));
+	}
+
+	for (; i < count; ++i)
+		((uint16 *)dst)[i] = CrossBlitSIMD::convertPixel(((const uint32 *)src)[i], params);
+}
+
+static void crossBlitConvert32To32_NEON(byte *dst, const byte *src, uint count, const CrossBlitSIMD::Params &params) {
+	// All the channels are bytes, so this is a table lookup. Destination
+	// bytes without a source channel are out of range and get cleared.
+	byte control[16];
+	memset(control, 0xFF, sizeof(control));
+	for (int i = 0; i < CrossBlitSIMD::kChannels; i++) {
+		for (int pixel = 0; pixel < 4; pixel++)
+			control[pixel * 4 + params.dstShift[i] / 8] = pixel * 4 + params.srcShift[i] / 8;
+	}
+	const uint32x4_t orMask = vdupq_n_u32(params.orMask);
+
+	uint i = 0;
+#ifdef __aarch64__
+	const uint8x16_t table = vld1q_u8(control);
+	for (; i + 4 <= count; i += 4) {
+		const uint8x16_t colors = vld1q_u8(src + i * 4);
+		const uint32x4_t swizzled = vreinterpretq_u32_u8(vqtbl1q_u8(colors, table));
+		vst1q_u32((uint32 *)(dst + i * 4), vorrq_u32(swizzled, orMask));
+	}
+#else
+	const uint8x8_t tableLo = vld1_u8(control);
+	const uint8x8_t tableHi = vld1_u8(control + 8);
+	for (; i + 4 <= count; i += 4) {
+		const uint8x8x2_t colors = { { vld1_u8(src + i * 4), vld1_u8(src + i * 4 + 8) } };
+		const uint8x8_t lo = vtbl2_u8(colors, tableLo);
+		const uint8x8_t hi = vtbl2_u8(colors, tableHi);
+		const uint32x4_t swizzled = vreinterpretq_u32_u8(vcombine_u8(lo, hi));
+		vst1q_u32((uint32 *)(dst + i * 4), vorrq_u32(swizzled, orMask));
+	}
+#endif
+
+	for (; i < count; ++i)
+		((uint32 *)dst)[i] = CrossBlitSIMD::convertPixel(((const uint32 *)src)[i], params);
+}
+
+} // End of anonymous namespace
+
+// NEON has no gather instruction, so a vectorized map would not be any faster
+const CrossBlitSIMD::Kernels CrossBlitSIMD::kernelsNEON = {
+	"NEON",
+	crossBlitConvert16To32_NEON,
+	crossBlitConvert32To16_NEON,
+	crossBlitConvert32To32_NEON,
+	nullptr,
+	nullptr
+};
+
 } // end of namespace Graphics
 
 #if !defined(__aarch64__) && !defined(__ARM_NEON)
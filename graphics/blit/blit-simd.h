@@ -0,0 +1,149 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_BLIT_BLIT_SIMD_H
+#define GRAPHICS_BLIT_BLIT_SIMD_H
+
+#include "graphics/pixelformat.h"
+
+namespace Graphics {
+
+/**
+ * Vectorized conversions for crossBlit() and crossBlitMap().
+ *
+ * Every destination channel is computed from one source channel as
+ * ((v << expandLeft) | (v >> expandRight)) << dstShift, where
+ * v = (color >> srcShift) & srcMask. This covers the 16 <-> 32 bits per
+ * pixel conversions and any swizzle of 32 bits per pixel formats, giving
+ * the same results as PixelFormat::colorToARGB() and ARGBToColor().
+ */
+class CrossBlitSIMD {
+public:
+	enum {
+		kChannels = 4
+	};
+
+	struct Params {
+		uint32 srcShift[kChannels];
+		uint32 srcMask[kChannels];
+		uint32 expandLeft[kChannels];
+		uint32 expandRight[kChannels];
+		uint32 dstShift[kChannels];
+		uint32 orMask;          ///< Set for an alpha channel which the source lacks
+	};
+
+	/**
+	 * Convert @p count pixels. The 16 to 32 bits per pixel conversion goes
+	 * from the end of the row to the start, so that it works in place.
+	 */
+	typedef void (*ConvertFunc)(byte *dst, const byte *src, uint count, const Params &params);
+
+	/** Look up @p count CLUT8 pixels in @p map, from the end of the row. */
+	typedef void (*MapFunc)(byte *dst, const byte *src, uint count, const uint32 *map);
+
+	struct Kernels {
+		const char *name;
+		ConvertFunc convert16To32;
+		ConvertFunc convert32To16;
+		ConvertFunc convert32To32;  ///< nullptr without a byte shuffle instruction
+		MapFunc map8To16;           ///< nullptr without a gather instruction
+		MapFunc map8To32;           ///< nullptr without a gather instruction
+	};
+
+	/**
+	 * Return the kernels best suited for the host CPU, or nullptr if there
+	 * are none.
+	 */
+	static const Kernels *get();
+
+	/**
+	 * Override the kernels used by crossBlit() and crossBlitMap(). Passing
+	 * nullptr makes them use the generic code.
+	 */
+	static void set(const Kernels *kernels);
+
+#ifdef SCUMMVM_NEON
+	static const Kernels kernelsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	static const Kernels kernelsSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+	static const Kernels kernelsAVX2;
+#endif
+
+	/**
+	 * Fill in @p params for a conversion between two formats. Only 16 and
+	 * 32 bits per pixel formats with 8-bit channels in the 32-bit formats
+	 * and at least 4-bit channels in the 16-bit source formats are
+	 * supported.
+	 *
+	 * @return false if the formats are not supported
+	 */
+	static bool getParams(const PixelFormat &dstFmt, const PixelFormat &srcFmt, Params &params);
+
+	/** Fill in @p params for a byte swap followed by a right rotation. */
+	static void getSwapParams(bool bswap, int rotate, Params &params);
+
+	/**
+	 * Convert a rect with the vectorized kernels, in place if needed.
+	 *
+	 * @return false if there are no kernels for the formats
+	 */
+	static bool crossBlit(byte *dst, const byte *src,
+	                      const uint dstPitch, const uint srcPitch,
+	                      const uint w, const uint h,
+	                      const PixelFormat &dstFmt, const PixelFormat &srcFmt);
+
+	/** Same as crossBlit() but with precomputed parameters. */
+	static bool crossBlit(byte *dst, const byte *src,
+	                      const uint dstPitch, const uint srcPitch,
+	                      const uint w, const uint h,
+	                      const uint dstBpp, const uint srcBpp, const Params &params);
+
+	/**
+	 * Map a CLUT8 rect with the vectorized kernels, in place if needed.
+	 *
+	 * @return false if there are no kernels for the depth
+	 */
+	static bool crossBlitMap(byte *dst, const byte *src,
+	                         const uint dstPitch, const uint srcPitch,
+	                         const uint w, const uint h,
+	                         const uint bytesPerPixel, const uint32 *map);
+
+	/** Generic conversion used for the remainder of a row. */
+	static inline uint32 convertPixel(uint32 color, const Params &params) {
+		uint32 result = params.orMask;
+		for (int i = 0; i < kChannels; i++) {
+			const uint32 value = (color >> params.srcShift[i]) & params.srcMask[i];
+			result |= ((value << params.expandLeft[i]) | (value >> params.expandRight[i])) << params.dstShift[i];
+		}
+		return result;
+	}
+
+private:
+	static const Kernels *_kernels;
+	static bool _initialized;
+};
+
+} // End of namespace Graphics
+
+#endif
@@ -22,6 +22,7 @@
 #include "common/scummsys.h"
 
 #include "graphics/blit/blit-alpha.h"
+#include "graphics/blit/blit-simd.h"
 #include "graphics/pixelformat.h"
 
 #include <emmintrin.h>
@@ -326,6 +327,90 @@ void BlendBlit::blitSSE2(Args &args, const TSpriteBlendMode &blendMode, const Al
 	blitT<BlendBlitImpl_SSE2>(args, blendMode, alphaType);
 }
 
+namespace {
+
+/** The channel parameters of CrossBlitSIMD as shift counts and masks. */
+struct CrossBlitVectors_SSE2 {
+	__m128i srcShift[CrossBlitSIMD::kChannels];
+	__m128i srcMask[CrossBlitSIMD::kChannels];
+	__m128i expandLeft[CrossBlitSIMD::kChannels];
+	__m128i expandRight[CrossBlitSIMD::kChannels];
+	__m128i dstShift[CrossBlitSIMD::kChannels];
+	__m128i orMask;
+
+	CrossBlitVectors_SSE2(const CrossBlitSIMD::Params &params) {
+		for (int i = 0; i < CrossBlitSIMD::kChannels; i++) {
+			srcShift[i] = _mm_cvtsi32_si128(params.srcShift[i]);
+			srcMask[i] = _mm_set1_epi32(params.srcMask[i]);
+			expandLeft[i] = _mm_cvtsi32_si128(params.expandLeft[i]);
+			expandRight[i] = _mm_cvtsi32_si128(params.expandRight[i]);
+			dstShift[i] = _mm_cvtsi32_si128(params.dstShift[i]);
+		}
+		orMask = _mm_set1_epi32(params.orMask);
+	}
+
+	template<bool expand>
+	inline __m128i convert(__m128i color) const {
+		__m128i result = orMask;
+		for (int i = 0; i < CrossBlitSIMD::kChannels; i++) {
+			__m128i value = _mm_and_si128(_mm_srl_epi32(color, srcShift[i]), srcMask[i]);
+			if (expand)
+				value = _mm_or_si128(_mm_sll_epi32(value, expandLeft[i]), _mm_srl_epi32(value, expandRight[i]));
+			result = _mm_or_si128(result, _mm_sll_epi32(value, dstShift[i]));
+		}
+		return result;
+	}
+};
+
+static void crossBlitConvert16To32_SSE2(byte *dst, const byte *src, uint count, const CrossBlitSIMD::Params &params) {
+	const CrossBlitVectors_SSE2 vectors(params);
+	const __m128i zero = _mm_setzero_si128();
+
+	// Go backwards and load before storing, for in place conversions
+	uint i = count;
+	for (; i >= 8; i -= 8) {
+		const __m128i colors = _mm_loadu_si128((const __m128i *)(src + (i - 8) * 2));
+		const __m128i lo = vectors.convert<true>(_mm_unpacklo_epi16(colors, zero));
+		const __m128i hi = vectors.convert<true>(_mm_unpackhi_epi16(colors, zero));
+		_mm_storeu_si128((__m128i *)(dst + (i - 8) * 4), lo);
+		_mm_storeu_si128((__m128i *)(dst + (i - 4) * 4), hi);
+	}
+
+	for (; i > 0; --i)
+		((uint32 *)dst)[i - 1] = CrossBlitSIMD::convertPixel(((const uint16 *)src)[i - 1], params);
+}
+
+static void crossBlitConvert32To16_SSE2(byte *dst, const byte *src, uint count, const CrossBlitSIMD::Params &params) {
+	const CrossBlitVectors_SSE2 vectors(params);
+
+	uint i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m128i lo = vectors.convert<false>(_mm_loadu_si128((const __m128i *)(src + i * 4)));
+		__m128i hi = vectors.convert<false>(_mm_loadu_si128((const __m128i *)(src + i * 4 + 16)));
+
+		// Sign extend the low halves, so that the signed saturation keeps them
+		lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+		hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+		_mm_storeu_si128((__m128i *)(dst + i * 2), _mm_packs_epi32(lo, hi));
+	}
+
+	for (; i < count; ++i)
+		((uint16 *)dst)[i] = CrossBlitSIMD::convertPixel(((const uint32 *)src)[i], params);
+}
+
+} // End of anonymous namespace
+
+// SSE2 has neither a byte shuffle nor a gather instruction, and the scalar
+// swaps and lookups are faster than anything built from shifts
+const CrossBlitSIMD::Kernels CrossBlitSIMD::kernelsSSE2 = {
+	"SSE2",
+	crossBlitConvert16To32_SSE2,
+	crossBlitConvert32To16_SSE2,
+	nullptr,
+	nullptr,
+	nullptr
+};
+
 } // End of namespace Graphics
 
 #if !defined(__x86_64__)
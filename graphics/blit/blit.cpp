@@ -20,8 +20,10 @@
  */
 
 #include "graphics/blit.h"
+#include "graphics/blit/blit-simd.h"
 #include "graphics/pixelformat.h"
 #include "common/endian.h"
+#include "common/system.h"
 
 namespace Graphics {
 
@@ -179,6 +181,156 @@ bool maskBlit(byte *dst, const byte *src, const byte *mask,
 	return true;
 }
 
+const CrossBlitSIMD::Kernels *CrossBlitSIMD::_kernels = nullptr;
+bool CrossBlitSIMD::_initialized = false;
+
+const CrossBlitSIMD::Kernels *CrossBlitSIMD::get() {
+	if (!_initialized) {
+		_initialized = true;
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) _kernels = &kernelsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) _kernels = &kernelsSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) _kernels = &kernelsAVX2;
+#endif
+	}
+
+	return _kernels;
+}
+
+void CrossBlitSIMD::set(const Kernels *kernels) {
+	_initialized = true;
+	_kernels = kernels;
+}
+
+bool CrossBlitSIMD::getParams(const PixelFormat &dstFmt, const PixelFormat &srcFmt, Params &params) {
+	const uint srcBpp = srcFmt.bytesPerPixel;
+	const uint dstBpp = dstFmt.bytesPerPixel;
+	if ((srcBpp != 2 && srcBpp != 4) || (dstBpp != 2 && dstBpp != 4) || (srcBpp == 2 && dstBpp == 2))
+		return false;
+
+	// The 32 bits per pixel formats have to be made of bytes
+	if (srcBpp == 4 && (srcFmt.rLoss || srcFmt.gLoss || srcFmt.bLoss || (srcFmt.aLoss && srcFmt.aLoss != 8)))
+		return false;
+	if (dstBpp == 4 && (dstFmt.rLoss || dstFmt.gLoss || dstFmt.bLoss || (dstFmt.aLoss && dstFmt.aLoss != 8)))
+		return false;
+
+	const byte srcBits[] = { srcFmt.rBits(), srcFmt.gBits(), srcFmt.bBits(), srcFmt.aBits() };
+	const byte srcShift[] = { srcFmt.rShift, srcFmt.gShift, srcFmt.bShift, srcFmt.aShift };
+	const byte dstLoss[] = { dstFmt.rLoss, dstFmt.gLoss, dstFmt.bLoss, dstFmt.aLoss };
+	const byte dstShift[] = { dstFmt.rShift, dstFmt.gShift, dstFmt.bShift, dstFmt.aShift };
+
+	params.orMask = 0;
+	int channels = kChannels;
+	if (dstFmt.aBits() == 0) {
+		channels = 3;
+	} else if (srcFmt.aBits() == 0) {
+		// colorToARGB() gives an opaque alpha value
+		params.orMask = (0xFF >> dstFmt.aLoss) << dstFmt.aShift;
+		channels = 3;
+	}
+
+	for (int i = 0; i < channels; i++) {
+		// The expansion of 1 to 3-bit channels needs more than two terms
+		if (srcBits[i] < 4)
+			return false;
+
+		params.srcShift[i] = srcShift[i];
+		params.srcMask[i] = (1 << srcBits[i]) - 1;
+		params.expandLeft[i] = 8 - srcBits[i];
+		params.expandRight[i] = 2 * srcBits[i] - 8;
+		params.dstShift[i] = dstShift[i];
+
+		// A 32 bits per pixel source has 8-bit channels, which only need
+		// to be truncated for a 16 bits per pixel destination
+		if (dstLoss[i]) {
+			params.srcShift[i] += dstLoss[i];
+			params.srcMask[i] >>= dstLoss[i];
+		}
+	}
+
+	// Unused channels repeat the red one, which does not change the result
+	for (int i = channels; i < kChannels; i++) {
+		params.srcShift[i] = params.srcShift[0];
+		params.srcMask[i] = params.srcMask[0];
+		params.expandLeft[i] = params.expandLeft[0];
+		params.expandRight[i] = params.expandRight[0];
+		params.dstShift[i] = params.dstShift[0];
+	}
+
+	return true;
+}
+
+void CrossBlitSIMD::getSwapParams(bool bswap, int rotate, Params &params) {
+	params.orMask = 0;
+	for (int i = 0; i < kChannels; i++) {
+		params.srcShift[i] = i * 8;
+		params.srcMask[i] = 0xFF;
+		params.expandLeft[i] = 0;
+		params.expandRight[i] = 8;
+		params.dstShift[i] = ((bswap ? 24 - i * 8 : i * 8) - rotate) & 31;
+	}
+}
+
+bool CrossBlitSIMD::crossBlit(byte *dst, const byte *src,
+                              const uint dstPitch, const uint srcPitch,
+                              const uint w, const uint h,
+                              const PixelFormat &dstFmt, const PixelFormat &srcFmt) {
+	Params params;
+	if (!get() || !getParams(dstFmt, srcFmt, params))
+		return false;
+
+	return crossBlit(dst, src, dstPitch, srcPitch, w, h, dstFmt.bytesPerPixel, srcFmt.bytesPerPixel, params);
+}
+
+bool CrossBlitSIMD::crossBlit(byte *dst, const byte *src,
+                              const uint dstPitch, const uint srcPitch,
+                              const uint w, const uint h,
+                              const uint dstBpp, const uint srcBpp, const Params &params) {
+	const Kernels *kernels = get();
+	if (!kernels)
+		return false;
+
+	if (srcBpp == 2) {
+		// Convert from the bottom so that this works in place
+		for (uint y = h; y > 0; --y)
+			kernels->convert16To32(dst + (y - 1) * dstPitch, src + (y - 1) * srcPitch, w, params);
+		return true;
+	}
+
+	const ConvertFunc convert = (dstBpp == 2) ? kernels->convert32To16 : kernels->convert32To32;
+	if (!convert)
+		return false;
+
+	for (uint y = 0; y < h; ++y) {
+		convert(dst, src, w, params);
+		src += srcPitch;
+		dst += dstPitch;
+	}
+	return true;
+}
+
+bool CrossBlitSIMD::crossBlitMap(byte *dst, const byte *src,
+                                 const uint dstPitch, const uint srcPitch,
+                                 const uint w, const uint h,
+                                 const uint bytesPerPixel, const uint32 *map) {
+	const Kernels *kernels = get();
+	if (!kernels)
+		return false;
+
+	const MapFunc mapRow = (bytesPerPixel == 2) ? kernels->map8To16 : (bytesPerPixel == 4 ? kernels->map8To32 : nullptr);
+	if (!mapRow)
+		return false;
+
+	// Map from the bottom so that this works in place
+	for (uint y = h; y > 0; --y)
+		mapRow(dst + (y - 1) * dstPitch, src + (y - 1) * srcPitch, w, map);
+	return true;
+}
+
 namespace {
 
 template<typename SrcColor, int SrcSize, typename DstColor, int DstSize, bool backward, bool hasKey, bool hasMask>
@@ -322,6 +474,9 @@ bool crossBlit(byte *dst, const byte *src,
 	}
 
 	// Attempt to use a faster method if possible
+	if (CrossBlitSIMD::crossBlit(dst, src, dstPitch, srcPitch, w, h, dstFmt, srcFmt))
+		return true;
+
 	FastBlitFunc blitFunc = getFastBlitFunc(dstFmt, srcFmt);
 	if (blitFunc) {
 		blitFunc(dst, src, dstPitch, srcPitch, w, h);
@@ -471,6 +626,9 @@ bool crossBlitMap(byte *dst, const byte *src,
 	if (!bytesPerPixel)
 		return false;
 
+	if (CrossBlitSIMD::crossBlitMap(dst, src, dstPitch, srcPitch, w, h, bytesPerPixel, map))
+		return true;
+
 	return crossBlitMapHelperLogic<false, false>(dst, src, nullptr, w, h, bytesPerPixel, map, srcPitch, dstPitch, 0, 0);
 }
 
@@ -45,6 +45,90 @@ void DirtyRectList::merge() {
 	}
 }
 
+void DirtyRectList::addCoalesced(const Common::Rect &rect, uint maxWaste, uint maxRects) {
+	if (rect.isEmpty())
+		return;
+
+	Common::Rect r = rect;
+	for (;;) {
+		Common::List<Common::Rect>::iterator best = _dirtyRects.end();
+		uint bestWaste = 0;
+		uint count = 0;
+
+		for (Common::List<Common::Rect>::iterator i = _dirtyRects.begin(); i != _dirtyRects.end(); ++i, ++count) {
+			if (i->contains(r))
+				return;
+
+			// The pixels in the bounding box which neither rect covers
+			Common::Rect bounds = r;
+			bounds.extend(*i);
+			const Common::Rect overlap = r.findIntersectingRect(*i);
+			const uint covered = r.width() * r.height() + i->width() * i->height() - overlap.width() * overlap.height();
+			const uint waste = bounds.width() * bounds.height() - covered;
+
+			if (best == _dirtyRects.end() || waste < bestWaste) {
+				best = i;
+				bestWaste = waste;
+			}
+		}
+
+		if (best == _dirtyRects.end() || (bestWaste > maxWaste && count < maxRects)) {
+			_dirtyRects.push_back(r);
+			return;
+		}
+
+		// The merged rect may now be close to others, so try again
+		r.extend(*best);
+		_dirtyRects.erase(best);
+	}
+}
+
+uint DirtyRectList::addChangedBlocks(const byte *oldPixels, uint oldPitch, const byte *newPixels, uint newPitch,
+                                     int x, int y, int w, int h, uint bytesPerPixel, int blockSize) {
+	uint changedPixels = 0;
+
+	for (int top = 0; top < h; top += blockSize) {
+		const int bottom = MIN(top + blockSize, h);
+		int runStart = -1;
+
+		for (int left = 0; left < w || runStart >= 0; left += blockSize) {
+			bool changed = false;
+			if (left < w) {
+				const uint offset = left * bytesPerPixel;
+				const uint size = (MIN(left + blockSize, w) - left) * bytesPerPixel;
+				for (int row = top; row < bottom && !changed; ++row)
+					changed = memcmp(oldPixels + row * oldPitch + offset, newPixels + row * newPitch + offset, size) != 0;
+			}
+
+			if (changed) {
+				if (runStart < 0)
+					runStart = left;
+				continue;
+			}
+			if (runStart < 0)
+				continue;
+
+			// The run ended, grow a rect of the previous row or start a new one
+			const Common::Rect run(x + runStart, y + top, x + MIN(left, w), y + bottom);
+			changedPixels += run.width() * run.height();
+			runStart = -1;
+
+			Common::List<Common::Rect>::iterator i;
+			for (i = _dirtyRects.begin(); i != _dirtyRects.end(); ++i) {
+				if (i->left == run.left && i->right == run.right && i->bottom == run.top)
+					break;
+			}
+
+			if (i != _dirtyRects.end())
+				i->bottom = run.bottom;
+			else
+				_dirtyRects.push_back(run);
+		}
+	}
+
+	return changedPixels;
+}
+
 bool DirtyRectList::unionRectangle(Common::Rect &destRect, const Common::Rect &src1, const Common::Rect &src2) {
 	destRect = src1;
 	destRect.extend(src2);
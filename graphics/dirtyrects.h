@@ -91,6 +91,33 @@ public:
 	 */
 	void push_back(Common::Rect &&r) { _dirtyRects.push_back(Common::move(r)); }
 
+	/**
+	 * Adds a rectangle and merges it with the rectangles in the list for
+	 * which the bounding box covers at most @p maxWaste pixels which are
+	 * not dirty. Once the list holds @p maxRects rectangles, new ones are
+	 * always merged into the rectangle for which this wastes the fewest
+	 * pixels. Rectangles which are already covered are ignored.
+	 */
+	void addCoalesced(const Common::Rect &r, uint maxWaste, uint maxRects);
+
+	/**
+	 * Compares two versions of an image in square blocks and adds a
+	 * rectangle for every run of changed blocks. Runs covering the same
+	 * columns in consecutive rows of blocks are merged.
+	 *
+	 * @param oldPixels     The previous image data.
+	 * @param newPixels     The new image data.
+	 * @param x, y          The position of the images, used to offset the rectangles.
+	 * @param w, h          The size of the images in pixels.
+	 * @param blockSize     The width and height of the compared blocks.
+	 * @return The number of changed pixels, rounded up to whole blocks.
+	 */
+	uint addChangedBlocks(const byte *oldPixels, uint oldPitch, const byte *newPixels, uint newPitch,
+	                      int x, int y, int w, int h, uint bytesPerPixel, int blockSize);
+
+	/** Return the number of rectangles in the list. */
+	uint size() const { return _dirtyRects.size(); }
+
 	/** Return a const iterator to the start of the list.
 	 *  This can be used, for example, to iterate from the first element
 	 *  of the list to the last element of the list.
@@ -18,6 +18,9 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include "common/endian.h"
+#include "common/util.h"
+
 #include "graphics/palette.h"
 
 namespace Graphics {
@@ -197,11 +200,11 @@ void Palette::grab(Palette &p, uint start, uint num) const {
 	memcpy(p._data, _data + 3 * start, 3 * num);
 }
 
-PaletteLookup::PaletteLookup(): _palette(256) {
+PaletteLookup::PaletteLookup(): _palette(256), _cellMethod(kColorDistanceRedmean) {
 	_paletteSize = 0;
 }
 
-PaletteLookup::PaletteLookup(const byte *palette, uint len) : _palette(256) {
+PaletteLookup::PaletteLookup(const byte *palette, uint len) : _palette(256), _cellMethod(kColorDistanceRedmean) {
 	_paletteSize = len;
 
 	_palette.set(palette, 0, len);
@@ -215,6 +218,8 @@ bool PaletteLookup::setPalette(const byte *palette, uint len)  {
 	_paletteSize = len;
 	_palette.set(palette, 0, len);
 	_colorHash.clear();
+	_cells.clear();
+	_candidates.clear();
 
 	return true;
 }
@@ -230,7 +235,7 @@ byte PaletteLookup::findBestColor(byte cr, byte cg, byte cb, ColorDistanceMethod
 	if (_colorHash.contains(color))
 		return _colorHash[color];
 
-	uint bestColor = _palette.findBestColor(cr, cg, cb, method);
+	uint bestColor = findBestColorInCell(cr, cg, cb, method);
 	_colorHash[color] = bestColor;
 
 	return bestColor;
@@ -251,4 +256,208 @@ uint32 *PaletteLookup::createMap(const byte *srcPalette, uint len, ColorDistance
 	return map;
 }
 
+namespace {
+
+/**
+ * The distances used by Palette::findBestColor() for the component
+ * differences @p r, @p g and @p b. The redmean weights of the red and blue
+ * differences are passed separately, so that the same function gives the
+ * bounds of the distance to a whole cell.
+ */
+template<ColorDistanceMethod method>
+inline uint32 colorDistance(int r, int g, int b, int rmeanR, int rmeanB) {
+	switch (method) {
+	case kColorDistanceEuclidean:
+		return r * r + g * g + b * b;
+	case kColorDistanceNaive:
+		return 3 * r * r + 5 * g * g + 2 * b * b;
+	default:
+		return (((512 + rmeanR) * r * r) >> 8) + 4 * g * g + (((767 - rmeanB) * b * b) >> 8);
+	}
+}
+
+inline int minDifference(int p, int lo, int hi) {
+	return p < lo ? lo - p : (p > hi ? p - hi : 0);
+}
+
+inline int maxDifference(int p, int lo, int hi) {
+	return MAX(ABS(p - lo), ABS(p - hi));
+}
+
+template<ColorDistanceMethod method>
+void findCellCandidates(const byte *palette, uint size, byte lr, byte lg, byte lb, int cellSize, Common::Array<byte> &candidates) {
+	const int hr = lr + cellSize - 1, hg = lg + cellSize - 1, hb = lb + cellSize - 1;
+	uint32 minDist[256];
+
+	// No color of the cell is further away from its closest entry than
+	// the smallest upper bound, so the entries whose lower bound exceeds
+	// it can be skipped. Entries on the bound are kept for the ties.
+	uint32 bound = 0xFFFFFFFF;
+	for (uint i = 0; i < size; i++) {
+		const int pr = palette[3 * i + 0], pg = palette[3 * i + 1], pb = palette[3 * i + 2];
+
+		minDist[i] = colorDistance<method>(minDifference(pr, lr, hr), minDifference(pg, lg, hg), minDifference(pb, lb, hb),
+		                                   (pr + lr) / 2, (pr + hr) / 2);
+		const uint32 maxDist = colorDistance<method>(maxDifference(pr, lr, hr), maxDifference(pg, lg, hg), maxDifference(pb, lb, hb),
+		                                             (pr + hr) / 2, (pr + lr) / 2);
+		bound = MIN(bound, maxDist);
+	}
+
+	for (uint i = 0; i < size; i++) {
+		if (minDist[i] <= bound)
+			candidates.push_back(i);
+	}
+}
+
+template<ColorDistanceMethod method>
+byte findBestCandidate(const byte *palette, const byte *candidates, uint count, byte cr, byte cg, byte cb) {
+	uint bestColor = 0;
+	uint32 min = 0xFFFFFFFF;
+
+	// The candidates are in palette order, so this picks the same entry
+	// as Palette::findBestColor() on ties
+	for (uint i = 0; i < count; i++) {
+		const byte *entry = &palette[3 * candidates[i]];
+		const uint32 dist = colorDistance<method>(entry[0] - cr, entry[1] - cg, entry[2] - cb,
+		                                          (entry[0] + cr) / 2, (entry[0] + cr) / 2);
+		if (dist < min) {
+			bestColor = candidates[i];
+			min = dist;
+			if (dist == 0)
+				break;
+		}
+	}
+
+	return bestColor;
+}
+
+} // End of anonymous namespace
+
+uint32 PaletteLookup::buildCell(uint cell, ColorDistanceMethod method) {
+	const byte lr = ((cell >> (2 * kCellBits)) << kCellShift);
+	const byte lg = (((cell >> kCellBits) & ((1 << kCellBits) - 1)) << kCellShift);
+	const byte lb = ((cell & ((1 << kCellBits) - 1)) << kCellShift);
+	const uint offset = _candidates.size();
+
+	// Like Palette::findBestColor() this looks at the whole palette and
+	// not only the entries set by setPalette()
+	switch (method) {
+	case kColorDistanceEuclidean:
+		findCellCandidates<kColorDistanceEuclidean>(_palette.data(), _palette.size(), lr, lg, lb, 1 << kCellShift, _candidates);
+		break;
+	case kColorDistanceNaive:
+		findCellCandidates<kColorDistanceNaive>(_palette.data(), _palette.size(), lr, lg, lb, 1 << kCellShift, _candidates);
+		break;
+	default:
+		findCellCandidates<kColorDistanceRedmean>(_palette.data(), _palette.size(), lr, lg, lb, 1 << kCellShift, _candidates);
+		break;
+	}
+
+	_cells[cell] = (offset << kCellCountShift) | (_candidates.size() - offset);
+	return _cells[cell];
+}
+
+byte PaletteLookup::findBestColorInCell(byte cr, byte cg, byte cb, ColorDistanceMethod method) {
+	if (method != _cellMethod || _cells.empty()) {
+		_cells.resize(kCellCount);
+		for (uint i = 0; i < kCellCount; i++)
+			_cells[i] = kCellUnset;
+		_candidates.clear();
+		_cellMethod = method;
+	}
+
+	const uint cell = ((cr >> kCellShift) << (2 * kCellBits)) | ((cg >> kCellShift) << kCellBits) | (cb >> kCellShift);
+	uint32 entry = _cells[cell];
+	if (entry == kCellUnset)
+		entry = buildCell(cell, method);
+
+	const byte *candidates = &_candidates[entry >> kCellCountShift];
+	const uint count = entry & ((1 << kCellCountShift) - 1);
+
+	switch (method) {
+	case kColorDistanceEuclidean:
+		return findBestCandidate<kColorDistanceEuclidean>(_palette.data(), candidates, count, cr, cg, cb);
+	case kColorDistanceNaive:
+		return findBestCandidate<kColorDistanceNaive>(_palette.data(), candidates, count, cr, cg, cb);
+	default:
+		return findBestCandidate<kColorDistanceRedmean>(_palette.data(), candidates, count, cr, cg, cb);
+	}
+}
+
+void PaletteLookup::mapPixels(byte *dst, int dstPitch, const void *src, int srcPitch, int w, int h, const PixelFormat &format,
+                              ColorDistanceMethod method, bool dither) {
+	assert(format.bytesPerPixel >= 2 && format.bytesPerPixel <= 4);
+
+	if (_paletteSize == 0) {
+		warning("PaletteLookup::mapPixels(): Palette was not set");
+		return;
+	}
+
+	// The errors of the current and of the next row, with a margin of one
+	// pixel on both sides
+	Common::Array<int> errors;
+	if (dither) {
+		errors.resize((w + 2) * 3 * 2);
+		memset(errors.data(), 0, errors.size() * sizeof(int));
+	}
+
+	const byte *palette = _palette.data();
+
+	for (int y = 0; y < h; y++) {
+		const byte *srcRow = (const byte *)src + y * srcPitch;
+		byte *dstRow = dst + y * dstPitch;
+		uint32 lastColor = 0xFFFFFFFF;
+		byte lastIndex = 0;
+
+		int *curErrors = nullptr, *nextErrors = nullptr;
+		if (dither) {
+			curErrors = &errors[((y & 1) * (w + 2) + 1) * 3];
+			nextErrors = &errors[((~y & 1) * (w + 2) + 1) * 3];
+			memset(nextErrors - 3, 0, (w + 2) * 3 * sizeof(int));
+		}
+
+		for (int x = 0; x < w; x++) {
+			uint32 pixel;
+			if (format.bytesPerPixel == 2)
+				pixel = READ_UINT16(srcRow);
+			else if (format.bytesPerPixel == 3)
+				pixel = READ_UINT24(srcRow);
+			else
+				pixel = READ_UINT32(srcRow);
+			srcRow += format.bytesPerPixel;
+
+			byte r, g, b;
+			format.colorToRGB(pixel, r, g, b);
+
+			if (dither) {
+				int *e = &curErrors[x * 3];
+				r = CLIP(r + e[0] / 16, 0, 255);
+				g = CLIP(g + e[1] / 16, 0, 255);
+				b = CLIP(b + e[2] / 16, 0, 255);
+			}
+
+			// Neighboring pixels often have the same color
+			const uint32 color = r << 16 | g << 8 | b;
+			if (color != lastColor) {
+				lastIndex = findBestColorInCell(r, g, b, method);
+				lastColor = color;
+			}
+			dstRow[x] = lastIndex;
+
+			if (dither) {
+				const int qr = r - palette[lastIndex * 3 + 0];
+				const int qg = g - palette[lastIndex * 3 + 1];
+				const int qb = b - palette[lastIndex * 3 + 2];
+				int *right = &curErrors[(x + 1) * 3];
+				int *below = &nextErrors[x * 3];
+
+				right[0] += qr * 7; right[1] += qg * 7; right[2] += qb * 7;
+				below[-3] += qr * 3; below[-2] += qg * 3; below[-1] += qb * 3;
+				below[0] += qr * 5; below[1] += qg * 5; below[2] += qb * 5;
+				below[3] += qr; below[4] += qg; below[5] += qb;
+			}
+		}
+	}
+}
+
 } // end of namespace Graphics
@@ -22,9 +22,12 @@
 #ifndef GRAPHICS_PALETTE_H
 #define GRAPHICS_PALETTE_H
 
+#include "common/array.h"
 #include "common/hashmap.h"
 #include "common/types.h"
 
+#include "graphics/pixelformat.h"
+
 #define PALETTE_6BIT_TO_8BIT(x) ((x) * 255 / 63)
 #define PALETTE_8BIT_TO_6BIT(x) ((x) * 63 / 255)
 
@@ -236,10 +239,49 @@ public:
 	 */
 	uint32 *createMap(const byte *srcPalette, uint len, ColorDistanceMethod method = kColorDistanceRedmean);
 
+	/**
+	 * @brief This method maps a block of true color pixels to the palette.
+	 *        The results are the same as with findBestColor(), but the
+	 *        colors are not added to its cache.
+	 *
+	 * @param dst       the palette indices, one byte per pixel
+	 * @param dstPitch  the number of bytes between two rows of @p dst
+	 * @param src       the source pixels
+	 * @param srcPitch  the number of bytes between two rows of @p src
+	 * @param w         the width of the block
+	 * @param h         the height of the block
+	 * @param format    the format of the source pixels, 2 to 4 bytes per pixel
+	 * @param method    the method used to determine the closest color
+	 * @param dither    diffuse the error to the neighboring pixels with
+	 *                  the Floyd-Steinberg matrix
+	 */
+	void mapPixels(byte *dst, int dstPitch, const void *src, int srcPitch, int w, int h, const PixelFormat &format,
+	               ColorDistanceMethod method = kColorDistanceRedmean, bool dither = false);
+
 private:
+	enum {
+		kCellBits = 4,                          ///< Bits per component used to pick a cell
+		kCellShift = 8 - kCellBits,
+		kCellCount = 1 << (3 * kCellBits),
+		kCellCountShift = 9,                    ///< Candidate count is stored in the low bits
+		kCellUnset = 0xFFFFFFFF
+	};
+
+	byte findBestColorInCell(byte cr, byte cg, byte cb, ColorDistanceMethod method);
+	uint32 buildCell(uint cell, ColorDistanceMethod method);
+
 	Palette _palette;
 	uint _paletteSize;
 	Common::HashMap<int, byte> _colorHash;
+
+	/**
+	 * The color cube is split into cells and each cell holds the palette
+	 * entries which can be the closest color of one of its colors. Both are
+	 * built lazily and only a few entries have to be compared per color.
+	 */
+	Common::Array<uint32> _cells;           ///< Candidate offset and count, or kCellUnset
+	Common::Array<byte> _candidates;
+	ColorDistanceMethod _cellMethod;
 };
 
 } //  // end of namespace Graphics
@@ -37,6 +37,9 @@ protected:
 						   const uint8 *oldSrcPtr, uint32 oldSrcPitch,
 						   int width, int height, const uint8 *buffer, uint32 bufferPitch) override;
 
+	// The edge detection keeps its state for the current pixel in members
+	bool canScaleInBands() const override { return false; }
+
 private:
 
 	/**
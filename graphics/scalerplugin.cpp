@@ -42,6 +42,36 @@ void Normal1x(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr, uint32 dstPit
 }
 } // End of anonymous namespace
 
+ScalerWorkerPool *Scaler::_workerPool = nullptr;
+
+namespace {
+enum {
+	// Splitting smaller rects costs more in synchronisation than it saves
+	kMinBandHeight = 16,
+	kMinBandPixels = 4096
+};
+} // End of anonymous namespace
+
+struct Scaler::BandJob {
+	Scaler *scaler;
+	const uint8 *srcPtr;
+	uint32 srcPitch;
+	uint8 *dstPtr;
+	uint32 dstPitch;
+	int width, height, x, y;
+	uint bands;
+};
+
+void Scaler::scaleBand(void *data, uint index) {
+	const BandJob &job = *(const BandJob *)data;
+	const int top = job.height * index / job.bands;
+	const int bottom = job.height * (index + 1) / job.bands;
+
+	job.scaler->scaleIntern(job.srcPtr + top * job.srcPitch, job.srcPitch,
+	                        job.dstPtr + top * job.scaler->_factor * job.dstPitch, job.dstPitch,
+	                        job.width, bottom - top, job.x, job.y + top);
+}
+
 void Scaler::scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	                           uint32 dstPitch, int width, int height, int x, int y) {
 	if (_factor == 1) {
@@ -52,9 +82,23 @@ void Scaler::scale(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 		} else {
 			Normal1x<uint32>(srcPtr, srcPitch, dstPtr, dstPitch, width, height);
 		}
+		return;
+	}
+
+	uint bands = 1;
+	if (_workerPool && canScaleInBands()) {
+		bands = MIN<uint>(_workerPool->getConcurrency(), height / kMinBandHeight);
+		bands = MIN<uint>(bands, width * height / kMinBandPixels);
+	}
+
+	if (bands > 1) {
+		BandJob job = { this, srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y, bands };
+		_workerPool->run(&scaleBand, &job, bands);
 	} else {
 		scaleIntern(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
 	}
+
+	finishScale(srcPtr, srcPitch, dstPtr, dstPitch, width, height, x, y);
 }
 
 SourceScaler::SourceScaler(const Graphics::PixelFormat &format) : Scaler(format), _width(0), _height(0), _oldSrc(NULL), _enable(false) {
@@ -111,6 +155,14 @@ void SourceScaler::scaleIntern(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstP
 	            _oldSrc + offset, srcPitch,
 	            width, height,
 	            (uint8 *)_bufferedOutput.getBasePtr(x * _factor, y * _factor), _bufferedOutput.pitch);
+}
+
+void SourceScaler::finishScale(const uint8 *srcPtr, uint32 srcPitch, const uint8 *dstPtr,
+						 uint32 dstPitch, int width, int height, int x, int y) {
+	// The neighbouring bands may still read the old data while scaling, so
+	// it is only updated once the whole rect is done
+	if (!_enable)
+		return;
 
 	// Update the destination buffer
 	byte *buffer = (byte *)_bufferedOutput.getBasePtr(x * _factor, y * _factor);
@@ -121,11 +173,10 @@ void SourceScaler::scaleIntern(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstP
 	}
 
 	// Update old src
-	byte *oldSrc = _oldSrc + offset;
+	byte *oldSrc = _oldSrc + (_padding + x) * _format.bytesPerPixel + (_padding + y) * srcPitch;
 	while (height--) {
 		memcpy(oldSrc, srcPtr, width * _format.bytesPerPixel);
 		oldSrc += srcPitch;
 		srcPtr += srcPitch;
 	}
 }
-
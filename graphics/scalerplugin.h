@@ -25,11 +25,45 @@
 #include "graphics/pixelformat.h"
 #include "graphics/surface.h"
 
+/**
+ * Runs jobs on several threads at the same time.
+ *
+ * OSystem has no threading API, so ScummVM cannot provide one itself.
+ * Backends which are able to run work on several cores can install a pool
+ * with Scaler::setWorkerPool to have large rects scaled in parallel bands.
+ */
+class ScalerWorkerPool {
+public:
+	virtual ~ScalerWorkerPool() {}
+
+	typedef void (*JobFunc)(void *data, uint index);
+
+	/**
+	 * Return the number of jobs which can run at the same time, including
+	 * the one run by the calling thread.
+	 */
+	virtual uint getConcurrency() const = 0;
+
+	/**
+	 * Call @p job with every index below @p count, in any order and on any
+	 * thread. Only return once all the calls have finished.
+	 */
+	virtual void run(JobFunc job, void *data, uint count) = 0;
+};
+
 class Scaler {
 public:
 	Scaler(const Graphics::PixelFormat &format) : _format(format) {}
 	virtual ~Scaler() {}
 
+	/**
+	 * Set the pool used to scale large rects in several bands of rows at
+	 * the same time. Passing nullptr scales every rect in one go.
+	 * The pool is not owned by the scalers.
+	 */
+	static void setWorkerPool(ScalerWorkerPool *pool) { _workerPool = pool; }
+	static ScalerWorkerPool *getWorkerPool() { return _workerPool; }
+
 	/**
 	 * Scale a rect.
 	 *
@@ -97,12 +131,36 @@ public:
 protected:
 	/**
 	 * @see scale
+	 *
+	 * Large rects may be split into bands of rows, which are passed to
+	 * scaleIntern from different threads at the same time. The source
+	 * around each band is still readable, so the result is the same as
+	 * when scaling the whole rect.
 	 */
 	virtual void scaleIntern(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	                         uint32 dstPitch, int width, int height, int x, int y) = 0;
 
+	/**
+	 * Called once all of a rect has been passed to scaleIntern.
+	 */
+	virtual void finishScale(const uint8 *srcPtr, uint32 srcPitch, const uint8 *dstPtr,
+	                         uint32 dstPitch, int width, int height, int x, int y) {}
+
+	/**
+	 * Return whether scaleIntern can be called for several bands at the
+	 * same time. Scalers which keep scratch data in members while scaling
+	 * must return false.
+	 */
+	virtual bool canScaleInBands() const { return true; }
+
 	uint _factor;
 	Graphics::PixelFormat _format;
+
+private:
+	struct BandJob;
+	static void scaleBand(void *data, uint index);
+
+	static ScalerWorkerPool *_workerPool;
 };
 
 /**
@@ -127,6 +185,9 @@ protected:
 	virtual void scaleIntern(const uint8 *srcPtr, uint32 srcPitch, uint8 *dstPtr,
 	                         uint32 dstPitch, int width, int height, int x, int y) final;
 
+	virtual void finishScale(const uint8 *srcPtr, uint32 srcPitch, const uint8 *dstPtr,
+	                         uint32 dstPitch, int width, int height, int x, int y) final;
+
 	/**
 	 * Scalers must implement this function. It will be called by oldSrcScale.
 	 * If by comparing the src and oldsrc images it is discovered that no change
@@ -82,8 +82,10 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#include "common/system.h"
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_intern.h"
 
 namespace Common {
 DECLARE_SINGLETON(Graphics::YUVToRGBManager);
@@ -181,6 +183,63 @@ YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::Lu
 	}
 }
 
+const YUVToRGBSIMD::Kernels *YUVToRGBSIMD::_kernels = nullptr;
+bool YUVToRGBSIMD::_initialized = false;
+
+const YUVToRGBSIMD::Kernels *YUVToRGBSIMD::get() {
+	if (!_initialized) {
+		_initialized = true;
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) _kernels = &kernelsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) _kernels = &kernelsSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) _kernels = &kernelsAVX2;
+#endif
+	}
+
+	return _kernels;
+}
+
+void YUVToRGBSIMD::set(const Kernels *kernels) {
+	_initialized = true;
+	_kernels = kernels;
+}
+
+/**
+ * Convert an image with the SIMD kernels. The chroma planes are subsampled by
+ * 1 << xShift horizontally and 1 << yShift vertically.
+ */
+static void convertYUVToRGBSIMD(const YUVToRGBSIMD::Kernels *kernels, Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yHeight, int yPitch, int uvPitch, int xShift, int yShift) {
+	const Graphics::PixelFormat &format = dst->format;
+	YUVToRGBSIMD::Params params;
+	params.itu = (scale == YUVToRGBManager::kScaleITU);
+	params.chromaShift = xShift;
+	params.rLoss = format.rLoss;
+	params.gLoss = format.gLoss;
+	params.bLoss = format.bLoss;
+	params.aLoss = format.aLoss;
+	params.rShift = format.rShift;
+	params.gShift = format.gShift;
+	params.bShift = format.bShift;
+	params.aShift = format.aShift;
+
+	const YUVToRGBSIMD::RowFunc convertRow = (format.bytesPerPixel == 2) ? kernels->convertRow16 : kernels->convertRow32;
+
+	byte *dstPtr = (byte *)dst->getPixels();
+	for (int h = 0; h < yHeight; h++) {
+		const int uvOffset = (h >> yShift) * uvPitch;
+		convertRow(dstPtr, ySrc, uSrc + uvOffset, vSrc + uvOffset, aSrc, yWidth, params);
+
+		dstPtr += dst->pitch;
+		ySrc += yPitch;
+		if (aSrc)
+			aSrc += yPitch;
+	}
+}
+
 YUVToRGBManager::YUVToRGBManager() {
 	_lookup = 0;
 }
@@ -244,6 +303,12 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert(dst->format.bytesPerPixel == 2 || dst->format.bytesPerPixel == 4);
 	assert(ySrc && uSrc && vSrc);
 
+	const YUVToRGBSIMD::Kernels *kernels = YUVToRGBSIMD::get();
+	if (kernels) {
+		convertYUVToRGBSIMD(kernels, dst, scale, ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch, 0, 0);
+		return;
+	}
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
@@ -301,6 +366,12 @@ void YUVToRGBManager::convert422(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert(ySrc && uSrc && vSrc);
 	assert((yWidth & 1) == 0);
 
+	const YUVToRGBSIMD::Kernels *kernels = YUVToRGBSIMD::get();
+	if (kernels) {
+		convertYUVToRGBSIMD(kernels, dst, scale, ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch, 1, 0);
+		return;
+	}
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
@@ -347,7 +418,7 @@ void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 			dstPtr += sizeof(PixelInt);
 		}
 
-		dstPtr += dstPitch;
+		dstPtr += (dstPitch << 1) - yWidth * sizeof(PixelInt);
 		ySrc += (yPitch << 1) - yWidth;
 		uSrc += uvPitch - halfWidth;
 		vSrc += uvPitch - halfWidth;
@@ -362,6 +433,12 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yWidth & 1) == 0);
 	assert((yHeight & 1) == 0);
 
+	const YUVToRGBSIMD::Kernels *kernels = YUVToRGBSIMD::get();
+	if (kernels) {
+		convertYUVToRGBSIMD(kernels, dst, scale, ySrc, uSrc, vSrc, nullptr, yWidth, yHeight, yPitch, uvPitch, 1, 1);
+		return;
+	}
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
@@ -415,7 +492,7 @@ void convertYUVA420ToRGBA(byte *dstPtr, int dstPitch, const YUVToRGBLookup *look
 			dstPtr += sizeof(PixelInt);
 		}
 
-		dstPtr += dstPitch;
+		dstPtr += (dstPitch << 1) - yWidth * sizeof(PixelInt);
 		ySrc += (yPitch << 1) - yWidth;
 		aSrc += (yPitch << 1) - yWidth;
 		uSrc += uvPitch - halfWidth;
@@ -431,6 +508,12 @@ void YUVToRGBManager::convert420Alpha(Graphics::Surface *dst, YUVToRGBManager::L
 	assert((yWidth & 1) == 0);
 	assert((yHeight & 1) == 0);
 
+	const YUVToRGBSIMD::Kernels *kernels = YUVToRGBSIMD::get();
+	if (kernels) {
+		convertYUVToRGBSIMD(kernels, dst, scale, ySrc, uSrc, vSrc, aSrc, yWidth, yHeight, yPitch, uvPitch, 1, 1);
+		return;
+	}
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
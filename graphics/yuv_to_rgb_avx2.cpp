@@ -0,0 +1,161 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Graphics {
+
+namespace {
+
+struct AVX2Params {
+	AVX2Params(const YUVToRGBSIMD::Params &params) :
+		itu(params.itu), chromaShift(params.chromaShift),
+		lo(_mm256_set1_epi16(params.itu ? 16 : 0)),
+		hi(_mm256_set1_epi16(params.itu ? 235 : 255)),
+		rLoss(_mm_cvtsi32_si128(params.rLoss)), gLoss(_mm_cvtsi32_si128(params.gLoss)),
+		bLoss(_mm_cvtsi32_si128(params.bLoss)), aLoss(_mm_cvtsi32_si128(params.aLoss)),
+		rShift(_mm_cvtsi32_si128(params.rShift)), gShift(_mm_cvtsi32_si128(params.gShift)),
+		bShift(_mm_cvtsi32_si128(params.bShift)), aShift(_mm_cvtsi32_si128(params.aShift)) {
+	}
+
+	bool itu;
+	byte chromaShift;
+	__m256i lo, hi;
+	__m128i rLoss, gLoss, bLoss, aLoss;
+	__m128i rShift, gShift, bShift, aShift;
+};
+
+} // End of anonymous namespace
+
+// Loads the chroma of sixteen pixels as 16-bit values
+static FORCEINLINE __m256i avx2_loadChroma(const byte *src, const AVX2Params &p) {
+	__m128i c;
+	if (p.chromaShift) {
+		c = _mm_loadl_epi64((const __m128i *)src);
+		c = _mm_unpacklo_epi8(c, c);
+	} else {
+		c = _mm_loadu_si128((const __m128i *)src);
+	}
+	return _mm256_cvtepu8_epi16(c);
+}
+
+// Computes the chroma contribution like the lookup tables do
+static FORCEINLINE __m256i avx2_chroma(__m256i c, uint16 mul) {
+	c = _mm256_sub_epi16(c, _mm256_set1_epi16(128));
+	const __m256i sign = _mm256_srai_epi16(c, 15);
+	const __m256i magnitude = _mm256_sub_epi16(_mm256_xor_si256(c, sign), sign);
+	const __m256i result = _mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_slli_epi16(magnitude, 8), _mm256_set1_epi16(mul)), YUVToRGBSIMD::kChromaShift - 8);
+	return _mm256_sub_epi16(_mm256_xor_si256(result, sign), sign);
+}
+
+// Clips sixteen colour components like the lookup tables do
+static FORCEINLINE __m256i avx2_clip(__m256i value, const AVX2Params &p, __m128i loss) {
+	value = _mm256_sub_epi16(_mm256_min_epi16(_mm256_max_epi16(value, p.lo), p.hi), p.lo);
+	if (p.itu) {
+		// (value * 255) / 219
+		value = _mm256_sub_epi16(_mm256_slli_epi16(value, 8), value);
+		value = _mm256_srli_epi16(_mm256_mulhi_epu16(value, _mm256_set1_epi16(YUVToRGBSIMD::kITUScaleMul)), YUVToRGBSIMD::kITUScaleShift);
+	}
+	return _mm256_srl_epi16(value, loss);
+}
+
+// Computes the components of sixteen pixels, as 16-bit values
+static FORCEINLINE void avx2_components(__m256i &r, __m256i &g, __m256i &b, __m256i &a, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, const AVX2Params &p) {
+	const __m256i y = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)ySrc));
+	const __m256i u = avx2_loadChroma(uSrc, p);
+	const __m256i v = avx2_loadChroma(vSrc, p);
+
+	const __m256i gOff = _mm256_add_epi16(avx2_chroma(v, YUVToRGBSIMD::kCrGMul), avx2_chroma(u, YUVToRGBSIMD::kCbGMul));
+	r = avx2_clip(_mm256_add_epi16(y, avx2_chroma(v, YUVToRGBSIMD::kCrRMul)), p, p.rLoss);
+	g = avx2_clip(_mm256_sub_epi16(y, gOff), p, p.gLoss);
+	b = avx2_clip(_mm256_add_epi16(y, avx2_chroma(u, YUVToRGBSIMD::kCbBMul)), p, p.bLoss);
+
+	if (aSrc)
+		a = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)aSrc));
+	else
+		a = _mm256_set1_epi16(0xFF);
+	a = _mm256_srl_epi16(a, p.aLoss);
+}
+
+static FORCEINLINE __m256i avx2_pack32(__m128i r, __m128i g, __m128i b, __m128i a, const AVX2Params &p) {
+	return _mm256_or_si256(_mm256_or_si256(_mm256_sll_epi32(_mm256_cvtepu16_epi32(r), p.rShift), _mm256_sll_epi32(_mm256_cvtepu16_epi32(g), p.gShift)),
+	                       _mm256_or_si256(_mm256_sll_epi32(_mm256_cvtepu16_epi32(b), p.bShift), _mm256_sll_epi32(_mm256_cvtepu16_epi32(a), p.aShift)));
+}
+
+static void convertRow16AVX2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int width, const YUVToRGBSIMD::Params &params) {
+	const AVX2Params p(params);
+
+	int i = 0;
+	for (; i + 16 <= width; i += 16) {
+		__m256i r, g, b, a;
+		avx2_components(r, g, b, a, ySrc + i, uSrc + (i >> p.chromaShift), vSrc + (i >> p.chromaShift), aSrc ? aSrc + i : nullptr, p);
+
+		const __m256i pixels = _mm256_or_si256(_mm256_or_si256(_mm256_sll_epi16(r, p.rShift), _mm256_sll_epi16(g, p.gShift)),
+		                                       _mm256_or_si256(_mm256_sll_epi16(b, p.bShift), _mm256_sll_epi16(a, p.aShift)));
+		_mm256_storeu_si256((__m256i *)(dst + i * 2), pixels);
+	}
+
+	YUVToRGBSIMD::convertPixels<uint16>(dst, ySrc, uSrc, vSrc, aSrc, i, width, params);
+}
+
+static void convertRow32AVX2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int width, const YUVToRGBSIMD::Params &params) {
+	const AVX2Params p(params);
+
+	int i = 0;
+	for (; i + 16 <= width; i += 16) {
+		__m256i r, g, b, a;
+		avx2_components(r, g, b, a, ySrc + i, uSrc + (i >> p.chromaShift), vSrc + (i >> p.chromaShift), aSrc ? aSrc + i : nullptr, p);
+
+		const __m256i lo = avx2_pack32(_mm256_castsi256_si128(r), _mm256_castsi256_si128(g),
+		                               _mm256_castsi256_si128(b), _mm256_castsi256_si128(a), p);
+		const __m256i hi = avx2_pack32(_mm256_extracti128_si256(r, 1), _mm256_extracti128_si256(g, 1),
+		                               _mm256_extracti128_si256(b, 1), _mm256_extracti128_si256(a, 1), p);
+		_mm256_storeu_si256((__m256i *)(dst + i * 4), lo);
+		_mm256_storeu_si256((__m256i *)(dst + i * 4 + 32), hi);
+	}
+
+	YUVToRGBSIMD::convertPixels<uint32>(dst, ySrc, uSrc, vSrc, aSrc, i, width, params);
+}
+
+const YUVToRGBSIMD::Kernels YUVToRGBSIMD::kernelsAVX2 = {
+	"AVX2",
+	convertRow16AVX2,
+	convertRow32AVX2
+};
+
+} // End of namespace Graphics
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,137 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef GRAPHICS_YUV_TO_RGB_INTERN_H
+#define GRAPHICS_YUV_TO_RGB_INTERN_H
+
+#include "common/scummsys.h"
+#include "common/util.h"
+
+namespace Graphics {
+
+/**
+ * Vectorized row conversion for YUVToRGBManager. Instead of the lookup
+ * tables in yuv_to_rgb.cpp, the kernels compute the chroma contribution and
+ * the clipping with integer arithmetic which gives bit-identical results.
+ */
+class YUVToRGBSIMD {
+public:
+	/** Destination format and source layout of a conversion. */
+	struct Params {
+		bool itu;               ///< Luminance values range from [16, 235]
+		byte chromaShift;       ///< 1 when the chroma is horizontally subsampled
+		byte rLoss, gLoss, bLoss, aLoss;
+		byte rShift, gShift, bShift, aShift;
+	};
+
+	/**
+	 * Convert @p width pixels of a row. @p aSrc may be nullptr for opaque
+	 * pixels.
+	 */
+	typedef void (*RowFunc)(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int width, const Params &params);
+
+	struct Kernels {
+		const char *name;
+		RowFunc convertRow16;   ///< 16-bit destination
+		RowFunc convertRow32;   ///< 32-bit destination
+	};
+
+	/**
+	 * Return the kernels best suited for the host CPU, or nullptr if there
+	 * are none.
+	 */
+	static const Kernels *get();
+
+	/**
+	 * Override the kernels used by YUVToRGBManager. Passing nullptr makes
+	 * it use the lookup tables.
+	 */
+	static void set(const Kernels *kernels);
+
+#ifdef SCUMMVM_NEON
+	static const Kernels kernelsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	static const Kernels kernelsSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+	static const Kernels kernelsAVX2;
+#endif
+
+	enum {
+		/**
+		 * The lookup tables hold (int16)(k * (c - 128)) for each chroma
+		 * coefficient k. For |c - 128| <= 128 this is equal to
+		 * (|c - 128| * mul) >> kChromaShift with the sign of c - 128.
+		 */
+		kChromaShift = 15,
+		kCrRMul = 45901,        ///< 0.419 / 0.299
+		kCrGMul = 23386,        ///< 0.299 / 0.419, subtracted
+		kCbGMul = 11283,        ///< 0.114 / 0.331, subtracted
+		kCbBMul = 58110,        ///< 0.587 / 0.331
+
+		/**
+		 * The ITU luminance scale (x * 255) / 219 for x in [0, 219] is
+		 * equal to ((x * 255) * kITUScaleMul) >> (16 + kITUScaleShift).
+		 */
+		kITUScaleMul = 19153,
+		kITUScaleShift = 6
+	};
+
+	/**
+	 * Generic helpers used for the remainder which does not fill a whole
+	 * vector.
+	 */
+	static inline int chroma(byte c, uint mul) {
+		const int value = c - 128;
+		const int magnitude = (ABS(value) * mul) >> kChromaShift;
+		return value < 0 ? -magnitude : magnitude;
+	}
+
+	static inline uint clip(int value, bool itu) {
+		if (!itu)
+			return CLIP(value, 0, 255);
+		return (CLIP(value, 16, 235) - 16) * 255 / 219;
+	}
+
+	template<typename PixelInt>
+	static inline void convertPixels(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int first, int width, const Params &params) {
+		PixelInt *out = (PixelInt *)dst;
+		for (int i = first; i < width; i++) {
+			const byte u = uSrc[i >> params.chromaShift];
+			const byte v = vSrc[i >> params.chromaShift];
+			const int y = ySrc[i];
+			const uint a = aSrc ? aSrc[i] : 0xFF;
+			out[i] = ((clip(y + chroma(v, kCrRMul), params.itu) >> params.rLoss) << params.rShift) |
+			         ((clip(y - chroma(v, kCrGMul) - chroma(u, kCbGMul), params.itu) >> params.gLoss) << params.gShift) |
+			         ((clip(y + chroma(u, kCbBMul), params.itu) >> params.bLoss) << params.bShift) |
+			         ((a >> params.aLoss) << params.aShift);
+		}
+	}
+
+private:
+	static const Kernels *_kernels;
+	static bool _initialized;
+};
+
+} // End of namespace Graphics
+
+#endif
@@ -0,0 +1,153 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "common/endian.h"
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+namespace Graphics {
+
+// Loads the chroma of eight pixels as 16-bit values
+static FORCEINLINE int16x8_t neon_loadChroma(const byte *src, const YUVToRGBSIMD::Params &params) {
+	uint8x8_t c;
+	if (params.chromaShift) {
+		c = vcreate_u8(READ_LE_UINT32(src));
+		c = vzip_u8(c, c).val[0];
+	} else {
+		c = vld1_u8(src);
+	}
+	return vreinterpretq_s16_u16(vmovl_u8(c));
+}
+
+// Computes the chroma contribution like the lookup tables do
+static FORCEINLINE int16x8_t neon_chroma(int16x8_t c, uint16 mul) {
+	c = vsubq_s16(c, vdupq_n_s16(128));
+	const uint16x8_t magnitude = vreinterpretq_u16_s16(vabsq_s16(c));
+	const uint16x4_t mul4 = vdup_n_u16(mul);
+	const uint32x4_t resultLo = vmull_u16(vget_low_u16(magnitude), mul4);
+	const uint32x4_t resultHi = vmull_u16(vget_high_u16(magnitude), mul4);
+	const int16x8_t result = vreinterpretq_s16_u16(vcombine_u16(vshrn_n_u32(resultLo, YUVToRGBSIMD::kChromaShift), vshrn_n_u32(resultHi, YUVToRGBSIMD::kChromaShift)));
+	return vbslq_s16(vcltq_s16(c, vdupq_n_s16(0)), vnegq_s16(result), result);
+}
+
+// Clips eight colour components like the lookup tables do
+static FORCEINLINE uint16x8_t neon_clip(int16x8_t value, const YUVToRGBSIMD::Params &params, byte loss) {
+	const int16x8_t lo = vdupq_n_s16(params.itu ? 16 : 0);
+	const int16x8_t hi = vdupq_n_s16(params.itu ? 235 : 255);
+	uint16x8_t result = vreinterpretq_u16_s16(vsubq_s16(vminq_s16(vmaxq_s16(value, lo), hi), lo));
+	if (params.itu) {
+		// (value * 255) / 219
+		result = vsubq_u16(vshlq_n_u16(result, 8), result);
+		const uint16x4_t mul = vdup_n_u16(YUVToRGBSIMD::kITUScaleMul);
+		const uint32x4_t resultLo = vmull_u16(vget_low_u16(result), mul);
+		const uint32x4_t resultHi = vmull_u16(vget_high_u16(result), mul);
+		result = vcombine_u16(vshrn_n_u32(resultLo, 16), vshrn_n_u32(resultHi, 16));
+		result = vshrq_n_u16(result, YUVToRGBSIMD::kITUScaleShift);
+	}
+	return vshlq_u16(result, vdupq_n_s16(-loss));
+}
+
+// Computes the components of eight pixels, as 16-bit values
+static FORCEINLINE void neon_components(uint16x8_t &r, uint16x8_t &g, uint16x8_t &b, uint16x8_t &a, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, const YUVToRGBSIMD::Params &params) {
+	const int16x8_t y = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(ySrc)));
+	const int16x8_t u = neon_loadChroma(uSrc, params);
+	const int16x8_t v = neon_loadChroma(vSrc, params);
+
+	const int16x8_t gOff = vaddq_s16(neon_chroma(v, YUVToRGBSIMD::kCrGMul), neon_chroma(u, YUVToRGBSIMD::kCbGMul));
+	r = neon_clip(vaddq_s16(y, neon_chroma(v, YUVToRGBSIMD::kCrRMul)), params, params.rLoss);
+	g = neon_clip(vsubq_s16(y, gOff), params, params.gLoss);
+	b = neon_clip(vaddq_s16(y, neon_chroma(u, YUVToRGBSIMD::kCbBMul)), params, params.bLoss);
+
+	if (aSrc)
+		a = vmovl_u8(vld1_u8(aSrc));
+	else
+		a = vdupq_n_u16(0xFF);
+	a = vshlq_u16(a, vdupq_n_s16(-params.aLoss));
+}
+
+static FORCEINLINE uint32x4_t neon_pack32(uint16x4_t r, uint16x4_t g, uint16x4_t b, uint16x4_t a, const YUVToRGBSIMD::Params &params) {
+	return vorrq_u32(vorrq_u32(vshlq_u32(vmovl_u16(r), vdupq_n_s32(params.rShift)), vshlq_u32(vmovl_u16(g), vdupq_n_s32(params.gShift))),
+	                 vorrq_u32(vshlq_u32(vmovl_u16(b), vdupq_n_s32(params.bShift)), vshlq_u32(vmovl_u16(a), vdupq_n_s32(params.aShift))));
+}
+
+static void convertRow16NEON(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int width, const YUVToRGBSIMD::Params &params) {
+	int i = 0;
+	for (; i + 8 <= width; i += 8) {
+		uint16x8_t r, g, b, a;
+		neon_components(r, g, b, a, ySrc + i, uSrc + (i >> params.chromaShift), vSrc + (i >> params.chromaShift), aSrc ? aSrc + i : nullptr, params);
+
+		const uint16x8_t pixels = vorrq_u16(vorrq_u16(vshlq_u16(r, vdupq_n_s16(params.rShift)), vshlq_u16(g, vdupq_n_s16(params.gShift))),
+		                                    vorrq_u16(vshlq_u16(b, vdupq_n_s16(params.bShift)), vshlq_u16(a, vdupq_n_s16(params.aShift))));
+		vst1q_u16((uint16 *)(dst + i * 2), pixels);
+	}
+
+	YUVToRGBSIMD::convertPixels<uint16>(dst, ySrc, uSrc, vSrc, aSrc, i, width, params);
+}
+
+static void convertRow32NEON(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int width, const YUVToRGBSIMD::Params &params) {
+	int i = 0;
+	for (; i + 8 <= width; i += 8) {
+		uint16x8_t r, g, b, a;
+		neon_components(r, g, b, a, ySrc + i, uSrc + (i >> params.chromaShift), vSrc + (i >> params.chromaShift), aSrc ? aSrc + i : nullptr, params);
+
+		vst1q_u32((uint32 *)(dst + i * 4), neon_pack32(vget_low_u16(r), vget_low_u16(g), vget_low_u16(b), vget_low_u16(a), params));
+		vst1q_u32((uint32 *)(dst + i * 4 + 16), neon_pack32(vget_high_u16(r), vget_high_u16(g), vget_high_u16(b), vget_high_u16(a), params));
+	}
+
+	YUVToRGBSIMD::convertPixels<uint32>(dst, ySrc, uSrc, vSrc, aSrc, i, width, params);
+}
+
+const YUVToRGBSIMD::Kernels YUVToRGBSIMD::kernelsNEON = {
+	"NEON",
+	convertRow16NEON,
+	convertRow32NEON
+};
+
+} // End of namespace Graphics
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#endif // SCUMMVM_NEON
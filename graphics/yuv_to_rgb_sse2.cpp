@@ -0,0 +1,172 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+#include "common/endian.h"
+
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace Graphics {
+
+namespace {
+
+struct SSE2Params {
+	SSE2Params(const YUVToRGBSIMD::Params &params) :
+		itu(params.itu), chromaShift(params.chromaShift),
+		lo(_mm_set1_epi16(params.itu ? 16 : 0)),
+		hi(_mm_set1_epi16(params.itu ? 235 : 255)),
+		rLoss(_mm_cvtsi32_si128(params.rLoss)), gLoss(_mm_cvtsi32_si128(params.gLoss)),
+		bLoss(_mm_cvtsi32_si128(params.bLoss)), aLoss(_mm_cvtsi32_si128(params.aLoss)),
+		rShift(_mm_cvtsi32_si128(params.rShift)), gShift(_mm_cvtsi32_si128(params.gShift)),
+		bShift(_mm_cvtsi32_si128(params.bShift)), aShift(_mm_cvtsi32_si128(params.aShift)) {
+	}
+
+	bool itu;
+	byte chromaShift;
+	__m128i lo, hi;
+	__m128i rLoss, gLoss, bLoss, aLoss;
+	__m128i rShift, gShift, bShift, aShift;
+};
+
+} // End of anonymous namespace
+
+// Loads the chroma of eight pixels as 16-bit values
+static FORCEINLINE __m128i sse2_loadChroma(const byte *src, const SSE2Params &p) {
+	__m128i c;
+	if (p.chromaShift) {
+		c = _mm_cvtsi32_si128(READ_LE_UINT32(src));
+		c = _mm_unpacklo_epi8(c, c);
+	} else {
+		c = _mm_loadl_epi64((const __m128i *)src);
+	}
+	return _mm_unpacklo_epi8(c, _mm_setzero_si128());
+}
+
+// Computes the chroma contribution like the lookup tables do
+static FORCEINLINE __m128i sse2_chroma(__m128i c, uint16 mul) {
+	c = _mm_sub_epi16(c, _mm_set1_epi16(128));
+	const __m128i sign = _mm_srai_epi16(c, 15);
+	const __m128i magnitude = _mm_sub_epi16(_mm_xor_si128(c, sign), sign);
+	const __m128i result = _mm_srli_epi16(_mm_mulhi_epu16(_mm_slli_epi16(magnitude, 8), _mm_set1_epi16(mul)), YUVToRGBSIMD::kChromaShift - 8);
+	return _mm_sub_epi16(_mm_xor_si128(result, sign), sign);
+}
+
+// Clips eight colour components like the lookup tables do
+static FORCEINLINE __m128i sse2_clip(__m128i value, const SSE2Params &p, __m128i loss) {
+	value = _mm_sub_epi16(_mm_min_epi16(_mm_max_epi16(value, p.lo), p.hi), p.lo);
+	if (p.itu) {
+		// (value * 255) / 219
+		value = _mm_sub_epi16(_mm_slli_epi16(value, 8), value);
+		value = _mm_srli_epi16(_mm_mulhi_epu16(value, _mm_set1_epi16(YUVToRGBSIMD::kITUScaleMul)), YUVToRGBSIMD::kITUScaleShift);
+	}
+	return _mm_srl_epi16(value, loss);
+}
+
+// Computes the components of eight pixels, as 16-bit values
+static FORCEINLINE void sse2_components(__m128i &r, __m128i &g, __m128i &b, __m128i &a, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, const SSE2Params &p) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)ySrc), zero);
+	const __m128i u = sse2_loadChroma(uSrc, p);
+	const __m128i v = sse2_loadChroma(vSrc, p);
+
+	const __m128i gOff = _mm_add_epi16(sse2_chroma(v, YUVToRGBSIMD::kCrGMul), sse2_chroma(u, YUVToRGBSIMD::kCbGMul));
+	r = sse2_clip(_mm_add_epi16(y, sse2_chroma(v, YUVToRGBSIMD::kCrRMul)), p, p.rLoss);
+	g = sse2_clip(_mm_sub_epi16(y, gOff), p, p.gLoss);
+	b = sse2_clip(_mm_add_epi16(y, sse2_chroma(u, YUVToRGBSIMD::kCbBMul)), p, p.bLoss);
+
+	if (aSrc)
+		a = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)aSrc), zero);
+	else
+		a = _mm_set1_epi16(0xFF);
+	a = _mm_srl_epi16(a, p.aLoss);
+}
+
+static FORCEINLINE __m128i sse2_pack32(__m128i r, __m128i g, __m128i b, __m128i a, const SSE2Params &p) {
+	return _mm_or_si128(_mm_or_si128(_mm_sll_epi32(r, p.rShift), _mm_sll_epi32(g, p.gShift)),
+	                    _mm_or_si128(_mm_sll_epi32(b, p.bShift), _mm_sll_epi32(a, p.aShift)));
+}
+
+static void convertRow16SSE2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int width, const YUVToRGBSIMD::Params &params) {
+	const SSE2Params p(params);
+
+	int i = 0;
+	for (; i + 8 <= width; i += 8) {
+		__m128i r, g, b, a;
+		sse2_components(r, g, b, a, ySrc + i, uSrc + (i >> p.chromaShift), vSrc + (i >> p.chromaShift), aSrc ? aSrc + i : nullptr, p);
+
+		const __m128i pixels = _mm_or_si128(_mm_or_si128(_mm_sll_epi16(r, p.rShift), _mm_sll_epi16(g, p.gShift)),
+		                                    _mm_or_si128(_mm_sll_epi16(b, p.bShift), _mm_sll_epi16(a, p.aShift)));
+		_mm_storeu_si128((__m128i *)(dst + i * 2), pixels);
+	}
+
+	YUVToRGBSIMD::convertPixels<uint16>(dst, ySrc, uSrc, vSrc, aSrc, i, width, params);
+}
+
+static void convertRow32SSE2(byte *dst, const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int width, const YUVToRGBSIMD::Params &params) {
+	const SSE2Params p(params);
+	const __m128i zero = _mm_setzero_si128();
+
+	int i = 0;
+	for (; i + 8 <= width; i += 8) {
+		__m128i r, g, b, a;
+		sse2_components(r, g, b, a, ySrc + i, uSrc + (i >> p.chromaShift), vSrc + (i >> p.chromaShift), aSrc ? aSrc + i : nullptr, p);
+
+		const __m128i lo = sse2_pack32(_mm_unpacklo_epi16(r, zero), _mm_unpacklo_epi16(g, zero),
+		                               _mm_unpacklo_epi16(b, zero), _mm_unpacklo_epi16(a, zero), p);
+		const __m128i hi = sse2_pack32(_mm_unpackhi_epi16(r, zero), _mm_unpackhi_epi16(g, zero),
+		                               _mm_unpackhi_epi16(b, zero), _mm_unpackhi_epi16(a, zero), p);
+		_mm_storeu_si128((__m128i *)(dst + i * 4), lo);
+		_mm_storeu_si128((__m128i *)(dst + i * 4 + 16), hi);
+	}
+
+	YUVToRGBSIMD::convertPixels<uint32>(dst, ySrc, uSrc, vSrc, aSrc, i, width, params);
+}
+
+const YUVToRGBSIMD::Kernels YUVToRGBSIMD::kernelsSSE2 = {
+	"SSE2",
+	convertRow16SSE2,
+	convertRow32SSE2
+};
+
+} // End of namespace Graphics
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
@@ -0,0 +1,168 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/decodedcache.h"
+
+#include "helper.h"
+#include "../system/null_osystem.h"
+
+class DecodedAudioCacheTestSuite : public CxxTest::TestSuite
+{
+private:
+	// Silent clip of a given length, which may stop early like a damaged file
+	class CountingStream : public Audio::SeekableAudioStream {
+	public:
+		CountingStream(uint32 frames, uint32 readableFrames, bool knownLength = true)
+			: reads(0), _frames(frames), _readable(readableFrames), _pos(0), _knownLength(knownLength) {}
+
+		int readBuffer(int16 *buffer, const int numSamples) override {
+			reads++;
+			const int samples = MIN<uint32>(numSamples, _readable - MIN(_pos, _readable));
+			memset(buffer, 0, samples * sizeof(int16));
+			_pos += samples;
+			return samples;
+		}
+		bool isStereo() const override { return false; }
+		int getRate() const override { return 11025; }
+		bool endOfData() const override { return _pos >= _frames; }
+		bool seek(const Audio::Timestamp &where) override { _pos = where.totalNumberOfFrames(); return true; }
+		Audio::Timestamp getLength() const override { return Audio::Timestamp(0, _knownLength ? _frames : 0, 11025); }
+
+		int reads;
+
+	private:
+		uint32 _frames, _readable, _pos;
+		bool _knownLength;
+	};
+
+	static Audio::DecodedAudioCache::Key makeKey(uint32 offset) {
+		return Audio::DecodedAudioCache::Key(Common::Path("monster.sou"), offset, 1000, MKTAG('T','E','S','T'));
+	}
+
+public:
+	void setUp() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+#endif
+	}
+
+	void tearDown() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Audio::DecodedAudioCache::destroy();
+		Common::uninstall_null_g_system();
+#endif
+	}
+
+	void test_cached_clip_matches_source() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		const int time = 1;
+		int16 *sine = nullptr;
+		Audio::SeekableAudioStream *stream = createSineStream<int16>(11025, time, &sine, false, true);
+		const int numSamples = 11025 * time * 2;
+
+		TS_ASSERT(!DecodedAudioCacheMan.find(makeKey(0)));
+		Audio::SeekableAudioStream *first = DecodedAudioCacheMan.insert(makeKey(0), stream);
+		TS_ASSERT_EQUALS(DecodedAudioCacheMan.getSize(), (uint32)(numSamples * sizeof(int16)));
+
+		Audio::SeekableAudioStream *second = DecodedAudioCacheMan.find(makeKey(0));
+		TS_ASSERT(second);
+		TS_ASSERT(!DecodedAudioCacheMan.find(makeKey(1)));
+		TS_ASSERT(second->isStereo());
+		TS_ASSERT_EQUALS(second->getRate(), 11025);
+		TS_ASSERT_EQUALS(second->getLength().totalNumberOfFrames(), 11025 * time);
+
+		int16 *buffer = new int16[numSamples];
+		TS_ASSERT_EQUALS(first->readBuffer(buffer, numSamples + 10), numSamples);
+		TS_ASSERT(first->endOfData());
+		TS_ASSERT_EQUALS(memcmp(buffer, sine, numSamples * sizeof(int16)), 0);
+
+		TS_ASSERT(second->seek(Audio::Timestamp(0, 5000, 11025)));
+		TS_ASSERT_EQUALS(second->readBuffer(buffer, numSamples), numSamples - 10000);
+		TS_ASSERT_EQUALS(memcmp(buffer, sine + 10000, (numSamples - 10000) * sizeof(int16)), 0);
+
+		delete[] buffer;
+		delete[] sine;
+		delete first;
+		delete second;
+#endif
+	}
+
+	void test_lru_eviction() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		// Each clip is 11025 samples long
+		DecodedAudioCacheMan.setMaxSize(3 * 11025 * sizeof(int16));
+
+		for (uint32 i = 0; i < 3; ++i)
+			delete DecodedAudioCacheMan.insert(makeKey(i), createSineStream<int16>(11025, 1, nullptr, false, false));
+
+		// Touching the first clip makes the second one the oldest
+		Audio::SeekableAudioStream *playing = DecodedAudioCacheMan.find(makeKey(0));
+		delete DecodedAudioCacheMan.insert(makeKey(3), createSineStream<int16>(11025, 1, nullptr, false, false));
+
+		Audio::SeekableAudioStream *s = DecodedAudioCacheMan.find(makeKey(1));
+		TS_ASSERT(!s);
+		for (uint32 i = 2; i < 4; ++i) {
+			s = DecodedAudioCacheMan.find(makeKey(i));
+			TS_ASSERT(s);
+			delete s;
+		}
+
+		// Streams keep playing after their clip has been evicted
+		DecodedAudioCacheMan.clear();
+		TS_ASSERT_EQUALS(DecodedAudioCacheMan.getSize(), 0u);
+		TS_ASSERT(!DecodedAudioCacheMan.find(makeKey(0)));
+		int16 buffer[256];
+		TS_ASSERT_EQUALS(playing->readBuffer(buffer, 256), 256);
+		delete playing;
+#endif
+	}
+
+	void test_large_clip_is_not_decoded() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		DecodedAudioCacheMan.setMaxEntrySize(1000);
+
+		CountingStream *stream = new CountingStream(11025, 11025);
+		TS_ASSERT_EQUALS(DecodedAudioCacheMan.insert(makeKey(0), stream), stream);
+		TS_ASSERT_EQUALS(stream->reads, 0);
+		delete stream;
+
+		// Clips of unknown length are remembered once they turn out too large
+		CountingStream *unknown = new CountingStream(2000, 2000, false);
+		TS_ASSERT_EQUALS(DecodedAudioCacheMan.insert(makeKey(1), unknown), unknown);
+		TS_ASSERT_LESS_THAN(0, unknown->reads);
+		delete unknown;
+
+		CountingStream *again = new CountingStream(2000, 2000, false);
+		TS_ASSERT_EQUALS(DecodedAudioCacheMan.insert(makeKey(1), again), again);
+		TS_ASSERT_EQUALS(again->reads, 0);
+		delete again;
+#endif
+	}
+
+	void test_truncated_clip_is_not_cached() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		CountingStream *stream = new CountingStream(1000, 600);
+		TS_ASSERT_EQUALS(DecodedAudioCacheMan.insert(makeKey(0), stream), stream);
+		TS_ASSERT(!DecodedAudioCacheMan.find(makeKey(0)));
+		TS_ASSERT_EQUALS(DecodedAudioCacheMan.getSize(), 0u);
+		delete stream;
+#endif
+	}
+
+	void test_large_clip_is_not_cached() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		DecodedAudioCacheMan.setMaxEntrySize(1000);
+
+		Audio::SeekableAudioStream *stream = createSineStream<int16>(11025, 1, nullptr, false, false);
+		TS_ASSERT_EQUALS(DecodedAudioCacheMan.insert(makeKey(0), stream), stream);
+		TS_ASSERT(!DecodedAudioCacheMan.find(makeKey(0)));
+		TS_ASSERT_EQUALS(DecodedAudioCacheMan.getSize(), 0u);
+
+		// The stream has been rewound for playback
+		int16 buffer[16];
+		TS_ASSERT_EQUALS(stream->readBuffer(buffer, 16), 16);
+		TS_ASSERT_EQUALS(stream->getLength().totalNumberOfFrames(), 11025);
+		delete stream;
+#endif
+	}
+};
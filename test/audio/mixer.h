@@ -0,0 +1,289 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/mixer_intern.h"
+#include "audio/rate_intern.h"
+#include "audio/decoders/raw.h"
+
+#include "common/memstream.h"
+
+#include "../system/null_osystem.h"
+
+#if defined(POSIX) && !defined(NO_CXX11_ATOMIC)
+#include <atomic>
+#include <pthread.h>
+#endif
+
+class MixerTestSuite : public CxxTest::TestSuite
+{
+private:
+	// Stream owned by the test, which must not be read once it was stopped
+	class OwnedStream : public Audio::AudioStream {
+	public:
+		OwnedStream() : released(false), reads(0) {}
+
+		int readBuffer(int16 *buffer, const int numSamples) override {
+			TS_ASSERT(!released);
+			reads++;
+			memset(buffer, 0, numSamples * sizeof(int16));
+			return numSamples;
+		}
+		bool isStereo() const override { return false; }
+		int getRate() const override { return 22050; }
+		bool endOfData() const override { return false; }
+
+		bool released;
+		int reads;
+	};
+
+#if defined(POSIX) && !defined(NO_CXX11_ATOMIC)
+	// Like OwnedStream, but read on the mixing thread
+	class ThreadedStream : public Audio::AudioStream {
+	public:
+		ThreadedStream() : released(false), readAfterRelease(false) {}
+
+		int readBuffer(int16 *buffer, const int numSamples) override {
+			if (released.load())
+				readAfterRelease.store(true);
+			memset(buffer, 0, numSamples * sizeof(int16));
+			return numSamples;
+		}
+		bool isStereo() const override { return false; }
+		int getRate() const override { return 22050; }
+		bool endOfData() const override { return false; }
+
+		std::atomic<bool> released;
+		std::atomic<bool> readAfterRelease;
+	};
+
+	struct MixThread {
+		Audio::MixerImpl *impl;
+		std::atomic<bool> quit;
+		std::atomic<int> callbacks;
+	};
+
+	static void *mixThreadProc(void *data) {
+		MixThread *thread = (MixThread *)data;
+		int16 out[256 * 2];
+		while (!thread->quit.load()) {
+			thread->impl->mixCallback((byte *)out, sizeof(out));
+			thread->callbacks++;
+		}
+		return nullptr;
+	}
+#endif
+
+	static Audio::SeekableAudioStream *createConstantStream(int16 value, int frames) {
+		int16 *data = (int16 *)malloc(frames * sizeof(int16));
+		for (int i = 0; i < frames; ++i)
+			WRITE_LE_UINT16(&data[i], value);
+
+		Common::SeekableReadStream *s = new Common::MemoryReadStream((const byte *)data, frames * sizeof(int16), DisposeAfterUse::YES);
+		return Audio::makeRawStream(s, 22050, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN, DisposeAfterUse::YES);
+	}
+
+	static void mixSequence(bool queued, int16 *out, int frames) {
+		Audio::MixerImpl impl(22050, true, frames);
+		impl.enableCommandQueue(queued);
+		impl.setReady(true);
+		Audio::Mixer &mixer = impl;
+
+		Audio::SoundHandle handle1, handle2;
+		mixer.playStream(Audio::Mixer::kSFXSoundType, &handle1, createConstantStream(1000, frames * 4), -1, 200, -50);
+		mixer.playStream(Audio::Mixer::kMusicSoundType, &handle2, createConstantStream(-3000, frames * 4), 7, 255, 0);
+		impl.mixCallback((byte *)out, frames * 4);
+
+		mixer.setChannelVolume(handle1, 100);
+		mixer.setVolumeForSoundType(Audio::Mixer::kMusicSoundType, 128);
+		impl.mixCallback((byte *)(out + frames * 2), frames * 4);
+
+		mixer.stopID(7);
+		impl.mixCallback((byte *)(out + frames * 4), frames * 4);
+	}
+
+	static void mixLoudSounds(bool mixBus, bool limiter, int16 *out, int frames) {
+		Audio::MixerImpl impl(22050, true, frames);
+		impl.enableMixBus(mixBus);
+		impl.setLimiter(limiter, 16000);
+		impl.setReady(true);
+		Audio::Mixer &mixer = impl;
+
+		mixer.playStream(Audio::Mixer::kPlainSoundType, nullptr, createConstantStream(30000, frames));
+		mixer.playStream(Audio::Mixer::kPlainSoundType, nullptr, createConstantStream(30000, frames));
+		mixer.playStream(Audio::Mixer::kPlainSoundType, nullptr, createConstantStream(-30000, frames));
+		impl.mixCallback((byte *)out, frames * 4);
+	}
+
+public:
+	void setUp() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+#endif
+		// The null backend cannot report CPU features, so pick the generic
+		// rate conversion code up front
+		Audio::RateConverterSIMD::set(nullptr);
+	}
+
+	void tearDown() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::uninstall_null_g_system();
+#endif
+	}
+
+	void test_command_queue_matches_locked_mixing() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		const int frames = 256;
+		int16 locked[frames * 6], queued[frames * 6];
+
+		mixSequence(false, locked, frames);
+		mixSequence(true, queued, frames);
+
+		TS_ASSERT_DIFFERS(locked[0], 0);
+		TS_ASSERT_EQUALS(memcmp(locked, queued, sizeof(locked)), 0);
+#endif
+	}
+
+	void test_command_queue_handle_state() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		const int frames = 256;
+		int16 out[frames * 2];
+
+		Audio::MixerImpl impl(22050, true, frames);
+		if (!impl.enableCommandQueue(true))
+			return;
+		impl.setReady(true);
+		Audio::Mixer &mixer = impl;
+
+		// Handles are usable before the mixing thread has seen the sound
+		Audio::SoundHandle handle;
+		mixer.playStream(Audio::Mixer::kSpeechSoundType, &handle, createConstantStream(500, frames), 3, 64, 10);
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+		TS_ASSERT(mixer.isSoundIDActive(3));
+		TS_ASSERT(mixer.hasActiveChannelOfType(Audio::Mixer::kSpeechSoundType));
+		TS_ASSERT_EQUALS(mixer.getSoundID(handle), 3);
+		TS_ASSERT_EQUALS(mixer.getChannelVolume(handle), 64);
+		TS_ASSERT_EQUALS(mixer.getChannelBalance(handle), 10);
+		TS_ASSERT_EQUALS(mixer.getChannelRate(handle), 22050u);
+		TS_ASSERT_EQUALS(mixer.getElapsedTime(handle).totalNumberOfFrames(), 0);
+
+		mixer.setChannelRate(handle, 11025);
+		TS_ASSERT_EQUALS(mixer.getChannelRate(handle), 11025u);
+		mixer.resetChannelRate(handle);
+		TS_ASSERT_EQUALS(mixer.getChannelRate(handle), 22050u);
+
+		// Sounds which run out are released by the mixing thread
+		impl.mixCallback((byte *)out, sizeof(out));
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+		impl.mixCallback((byte *)out, sizeof(out));
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+		TS_ASSERT(!mixer.isSoundIDActive(3));
+
+		// Stopped sounds are inactive right away
+		mixer.playStream(Audio::Mixer::kPlainSoundType, &handle, createConstantStream(500, frames * 8));
+		impl.mixCallback((byte *)out, sizeof(out));
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+		mixer.stopHandle(handle);
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+		impl.mixCallback((byte *)out, sizeof(out));
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+#endif
+	}
+
+	void test_command_queue_stop_releases_stream() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		const int frames = 256;
+		int16 out[frames * 2];
+
+		Audio::MixerImpl impl(22050, true, frames);
+		if (!impl.enableCommandQueue(true))
+			return;
+		impl.setReady(true);
+		Audio::Mixer &mixer = impl;
+
+		// Callers which keep ownership of a stream may delete it as soon as
+		// stopping it has returned
+		OwnedStream stream;
+		Audio::SoundHandle handle;
+		mixer.playStream(Audio::Mixer::kPlainSoundType, &handle, &stream, -1, 255, 0, DisposeAfterUse::NO);
+		impl.mixCallback((byte *)out, sizeof(out));
+		TS_ASSERT_LESS_THAN(0, stream.reads);
+
+		mixer.stopHandle(handle);
+		stream.released = true;
+		impl.mixCallback((byte *)out, sizeof(out));
+
+		stream.released = false;
+		mixer.playStream(Audio::Mixer::kPlainSoundType, &handle, &stream, 5, 255, 0, DisposeAfterUse::NO);
+		impl.mixCallback((byte *)out, sizeof(out));
+		mixer.stopID(5);
+		stream.released = true;
+		impl.mixCallback((byte *)out, sizeof(out));
+#endif
+	}
+
+	void test_command_queue_stop_under_mutex() {
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(POSIX) && !defined(NO_CXX11_ATOMIC)
+		Audio::MixerImpl impl(22050, true, 256);
+		if (!impl.enableCommandQueue(true))
+			return;
+		impl.setReady(true);
+		Audio::Mixer &mixer = impl;
+
+		ThreadedStream stream;
+		Audio::SoundHandle handle;
+		mixer.playStream(Audio::Mixer::kPlainSoundType, &handle, &stream, -1, 255, 0, DisposeAfterUse::NO);
+
+		MixThread thread;
+		thread.impl = &impl;
+		thread.quit.store(false);
+		thread.callbacks.store(0);
+		pthread_t pthread;
+		TS_ASSERT_EQUALS(pthread_create(&pthread, nullptr, &mixThreadProc, &thread), 0);
+
+		// Players stop their sounds with the mixer mutex held, while the
+		// mixing thread waits for it
+		while (thread.callbacks.load() < 2)
+			g_system->delayMillis(1);
+		{
+			Common::StackLock lock(mixer.mutex());
+			g_system->delayMillis(5);
+
+			const uint32 start = g_system->getMillis();
+			mixer.stopHandle(handle);
+			TS_ASSERT_LESS_THAN(g_system->getMillis() - start, 500u);
+			stream.released.store(true);
+		}
+
+		const int callbacks = thread.callbacks.load();
+		while (thread.callbacks.load() < callbacks + 2)
+			g_system->delayMillis(1);
+
+		thread.quit.store(true);
+		pthread_join(pthread, nullptr);
+		TS_ASSERT(!stream.readAfterRelease.load());
+#endif
+	}
+
+	void test_mix_bus() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		const int frames = 256;
+		int16 out[frames * 2];
+
+		// Clamping after every channel loses the headroom...
+		mixLoudSounds(false, false, out, frames);
+		TS_ASSERT_EQUALS(out[0], 32767 - 30000);
+
+		// ...which the bus keeps until the end
+		mixLoudSounds(true, false, out, frames);
+		for (int i = 0; i < frames * 2; ++i)
+			TS_ASSERT_EQUALS(out[i], 30000);
+
+		// The limiter pulls the whole mix below its threshold
+		mixLoudSounds(true, true, out, frames);
+		for (int i = 0; i < frames * 2; ++i) {
+			TS_ASSERT_LESS_THAN_EQUALS(out[i], 16000);
+			TS_ASSERT_LESS_THAN(15900, out[i]);
+		}
+#endif
+	}
+};
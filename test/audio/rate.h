@@ -0,0 +1,117 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#include "audio/rate.h"
+#include "audio/rate_intern.h"
+#include "audio/audiostream.h"
+#include "audio/decoders/raw.h"
+
+#include "common/memstream.h"
+
+#include "helper.h"
+#include "../system/null_osystem.h"
+
+class RateConverterTestSuite : public CxxTest::TestSuite
+{
+private:
+	// Converts a sine wave in chunks of varying size into a buffer which
+	// already holds loud audio, so that both mixing and clamping are covered
+	template<typename T>
+	static void convert(const Audio::RateConverterSIMD::Kernels *kernels, T *out, int outFrames,
+	                    int inRate, int outRate, bool inStereo, bool reverseStereo, int volL, int volR, bool clamp) {
+		Audio::RateConverterSIMD::set(kernels);
+
+		Audio::SeekableAudioStream *stream = createSineStream<int16>(inRate, 1, nullptr, true, inStereo);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, inStereo, true, reverseStereo);
+
+		for (int i = 0; i < outFrames * 2; ++i)
+			out[i] = (T)((i * 7919) % 50000 - 25000);
+
+		// The chunks are multiples of four frames, since upsampling produces
+		// no output for requests smaller than the rate ratio
+		int pos = 0, chunk = 1;
+		while (pos < outFrames) {
+			const int len = MIN(chunk * 4, outFrames - pos);
+			converter->convert(*stream, (byte *)(out + pos * 2), sizeof(T), len, volL, volR, clamp ? Audio::MIX_CLAMPED_ADD : Audio::MIX_ADD);
+			pos += len;
+			chunk = chunk * 3 % 257;
+		}
+
+		delete converter;
+		delete stream;
+	}
+
+	// Compares the kernels against the generic code for 16-bit output and for
+	// the 32-bit mix bus
+	template<typename T>
+	static void compareKernels(const Audio::RateConverterSIMD::Kernels *kernels) {
+		static const int rates[][2] = {
+			{ 22050, 22050 }, { 11025, 44100 }, { 22050, 48000 }, { 44100, 22050 }, { 44100, 48000 }, { 48000, 44100 }, { 8000, 11025 }
+		};
+		static const int volumes[][2] = {
+			{ 256, 256 }, { 255, 37 }, { 0, 128 }, { 256, 0 }
+		};
+		const int outFrames = 8000;
+		T *expected = new T[outFrames * 2];
+		T *actual = new T[outFrames * 2];
+
+		for (int r = 0; r < ARRAYSIZE(rates); ++r) {
+			for (int v = 0; v < ARRAYSIZE(volumes); ++v) {
+				for (int flags = 0; flags < 8; ++flags) {
+					const bool inStereo = flags & 1;
+					const bool reverseStereo = inStereo && (flags & 2);
+					const bool clamp = flags & 4;
+
+					convert(nullptr, expected, outFrames, rates[r][0], rates[r][1], inStereo, reverseStereo, volumes[v][0], volumes[v][1], clamp);
+					convert(kernels, actual, outFrames, rates[r][0], rates[r][1], inStereo, reverseStereo, volumes[v][0], volumes[v][1], clamp);
+					TSM_ASSERT_EQUALS(kernels->name, memcmp(expected, actual, outFrames * 2 * sizeof(T)), 0);
+				}
+			}
+		}
+
+		delete[] expected;
+		delete[] actual;
+		Audio::RateConverterSIMD::set(nullptr);
+	}
+
+public:
+	void setUp() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+#endif
+	}
+
+	void tearDown() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::uninstall_null_g_system();
+#endif
+	}
+
+	void test_simd_kernels_match_generic() {
+#ifdef SCUMMVM_NEON
+		compareKernels<int16>(&Audio::RateConverterSIMD::kernelsNEON);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			compareKernels<int16>(&Audio::RateConverterSIMD::kernelsSSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			compareKernels<int16>(&Audio::RateConverterSIMD::kernelsAVX2);
+#endif
+	}
+
+	void test_simd_kernels_match_generic_32bit() {
+#ifdef SCUMMVM_NEON
+		compareKernels<int32>(&Audio::RateConverterSIMD::kernelsNEON);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			compareKernels<int32>(&Audio::RateConverterSIMD::kernelsSSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			compareKernels<int32>(&Audio::RateConverterSIMD::kernelsAVX2);
+#endif
+	}
+};
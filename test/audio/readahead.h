@@ -0,0 +1,89 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/readahead.h"
+
+#include "helper.h"
+#include "../system/null_osystem.h"
+
+class ReadAheadAudioStreamTestSuite : public CxxTest::TestSuite
+{
+public:
+	void setUp() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+#endif
+	}
+
+	void tearDown() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Audio::purgeReadAheadStreams();
+		Common::uninstall_null_g_system();
+#endif
+	}
+
+	void test_read_ahead_matches_source() {
+#if NULL_OSYSTEM_IS_AVAILABLE && !defined(NO_CXX11_ATOMIC)
+		const int numSamples = 11025 * 2;
+		int16 *sine = nullptr;
+		Audio::ReadAheadAudioStream *stream = new Audio::ReadAheadAudioStream(createSineStream<int16>(11025, 1, &sine, false, true), 100);
+		TS_ASSERT(stream->isStereo());
+		TS_ASSERT_EQUALS(stream->getRate(), 11025);
+		TS_ASSERT_EQUALS(stream->getLength().totalNumberOfFrames(), 11025);
+
+		// Nothing is decoded while reading, so the stream runs dry...
+		int16 *buffer = new int16[numSamples];
+		const int buffered = stream->readBuffer(buffer, numSamples);
+		TS_ASSERT_LESS_THAN(0, buffered);
+		TS_ASSERT_LESS_THAN(buffered, numSamples);
+		TS_ASSERT(!stream->endOfData());
+		TS_ASSERT_EQUALS(stream->readBuffer(buffer + buffered, 512), 0);
+
+		// ...until its buffer is filled again
+		int pos = buffered;
+		while (!stream->endOfData()) {
+			stream->fill();
+			pos += stream->readBuffer(buffer + pos, MIN(1000, numSamples - pos));
+		}
+		TS_ASSERT_EQUALS(pos, numSamples);
+		TS_ASSERT_EQUALS(memcmp(buffer, sine, numSamples * sizeof(int16)), 0);
+
+		// Seeking discards the decoded samples, and the stream plays
+		// silence until the seek has been carried out
+		TS_ASSERT(stream->seek(Audio::Timestamp(0, 5000, 11025)));
+		TS_ASSERT(!stream->endOfData());
+		TS_ASSERT_EQUALS(stream->readBuffer(buffer, 100), 0);
+		pos = 0;
+		while (!stream->endOfData()) {
+			stream->fill();
+			pos += stream->readBuffer(buffer + pos, 998);
+		}
+		TS_ASSERT_EQUALS(pos, numSamples - 10000);
+		TS_ASSERT_EQUALS(memcmp(buffer, sine + 10000, pos * sizeof(int16)), 0);
+
+		TS_ASSERT(!stream->seek(Audio::Timestamp(0, 20000, 11025)));
+
+		// Filling can be limited, like the timer callback does
+		TS_ASSERT(stream->rewind());
+		stream->fill(256);
+		TS_ASSERT_EQUALS(stream->readBuffer(buffer, 1000), 256);
+		stream->fill(256);
+		TS_ASSERT_EQUALS(stream->readBuffer(buffer + 256, 1000), 256);
+		TS_ASSERT_EQUALS(memcmp(buffer, sine, 512 * sizeof(int16)), 0);
+
+		// A seek requested while samples are still buffered
+		TS_ASSERT(stream->seek(Audio::Timestamp(0, 1000, 11025)));
+		stream->fill();
+		TS_ASSERT_EQUALS(stream->readBuffer(buffer, 100), 100);
+		TS_ASSERT_EQUALS(memcmp(buffer, sine + 2000, 100 * sizeof(int16)), 0);
+		TS_ASSERT(stream->rewind());
+		TS_ASSERT_EQUALS(stream->readBuffer(buffer, 100), 0);
+		stream->fill();
+		TS_ASSERT_EQUALS(stream->readBuffer(buffer, 100), 100);
+		TS_ASSERT_EQUALS(memcmp(buffer, sine, 100 * sizeof(int16)), 0);
+
+		delete stream;
+		delete[] buffer;
+		delete[] sine;
+#endif
+	}
+};
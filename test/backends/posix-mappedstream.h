@@ -0,0 +1,87 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/fs.h"
+#include "common/stream.h"
+
+#include "../system/null_osystem.h"
+
+#if defined(POSIX) && defined(HAS_MMAP)
+#include "backends/fs/posix/posix-mappedstream.h"
+#endif
+
+class PosixMappedReadStreamTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+#endif
+	}
+
+	void tearDown() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::uninstall_null_g_system();
+#endif
+	}
+
+#if NULL_OSYSTEM_IS_AVAILABLE && defined(POSIX) && defined(HAS_MMAP)
+	static byte pattern(uint32 i) {
+		return (byte)((i * 7) ^ (i >> 9));
+	}
+
+	static bool writeFile(const char *path, uint32 size) {
+		Common::SeekableWriteStream *out = Common::FSNode(path).createWriteStream();
+		if (!out)
+			return false;
+
+		for (uint32 i = 0; i < size; i++)
+			out->writeByte(pattern(i));
+
+		out->finalize();
+		bool ok = !out->err();
+		delete out;
+		return ok;
+	}
+
+	void test_large_file_is_mapped() {
+		const uint32 size = PosixMappedReadStream::kMinMappedSize + 1234;
+		TS_ASSERT(writeFile("test/posix-mappedstream.bin", size));
+
+		PosixMappedReadStream *stream = PosixMappedReadStream::makeFromPath("test/posix-mappedstream.bin");
+		TS_ASSERT(stream);
+		if (!stream)
+			return;
+
+		TS_ASSERT_EQUALS(stream->size(), (int64)size);
+
+		bool same = true;
+		for (uint32 i = 0; i < size && same; i++)
+			same = stream->readByte() == pattern(i);
+		TS_ASSERT(same);
+		TS_ASSERT(!stream->eos());
+		stream->readByte();
+		TS_ASSERT(stream->eos());
+
+		TS_ASSERT(stream->seek(200000, SEEK_SET));
+		byte buf[16];
+		TS_ASSERT_EQUALS(stream->read(buf, sizeof(buf)), sizeof(buf));
+		for (uint32 i = 0; i < sizeof(buf); i++)
+			TS_ASSERT_EQUALS(buf[i], pattern(200000 + i));
+
+		TS_ASSERT(stream->seek(-4, SEEK_END));
+		TS_ASSERT_EQUALS(stream->read(buf, sizeof(buf)), 4u);
+		TS_ASSERT_EQUALS(buf[3], pattern(size - 1));
+
+		delete stream;
+	}
+
+	void test_small_file_is_not_mapped() {
+		TS_ASSERT(writeFile("test/posix-mappedstream-small.bin", 1024));
+		TS_ASSERT(!PosixMappedReadStream::makeFromPath("test/posix-mappedstream-small.bin"));
+	}
+
+	void test_non_regular_file_is_not_mapped() {
+		TS_ASSERT(!PosixMappedReadStream::makeFromPath("test"));
+		TS_ASSERT(!PosixMappedReadStream::makeFromPath("test/posix-mappedstream-missing.bin"));
+	}
+#endif
+};
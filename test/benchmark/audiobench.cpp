@@ -0,0 +1,660 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Offline audio benchmark.
+ *
+ * Renders a scripted set of audio streams through Audio::MixerImpl on the
+ * null backend, without any real-time clock, and reports the throughput of
+ * every decoder, of every rate converter path and of the mix callback as a
+ * whole. The mixed output is written to a WAV file and its CRC32 is printed,
+ * so that the same run doubles as a bit-exact regression check: for the
+ * built-in script at the default rate and length, the checksum is compared
+ * against the expected one, and a mismatch fails the run.
+ *
+ * Each line of the script describes one stream:
+ *
+ *   <codec> <file|synth> [rate=<hz>] [stereo=<0|1>] [volume=<0-255>]
+ *                        [balance=<-127-127>] [length=<seconds>]
+ *
+ * The codecs are raw8, raw16, ima-adpcm, ms-adpcm, vorbis, mp3, flac, mod
+ * (which also plays XM and S3M modules) and opl. The raw, ADPCM and OPL codecs can use "synth" instead of a file
+ * to play generated data, which is what the built-in script does.
+ */
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_printf
+#define FORBIDDEN_SYMBOL_EXCEPTION_fprintf
+#define FORBIDDEN_SYMBOL_EXCEPTION_stderr
+
+#include "common/scummsys.h"
+
+#include "audio/audiostream.h"
+#include "audio/fmopl.h"
+#include "audio/mixer_intern.h"
+#include "audio/rate.h"
+#include "audio/rate_intern.h"
+#include "audio/decoders/adpcm.h"
+#include "audio/decoders/flac.h"
+#include "audio/decoders/mp3.h"
+#include "audio/decoders/raw.h"
+#include "audio/decoders/vorbis.h"
+#include "audio/mods/mod_xm_s3m.h"
+
+#include "common/array.h"
+#include "common/crc.h"
+#include "common/file.h"
+#include "common/fs.h"
+#include "common/func.h"
+#include "common/memstream.h"
+#include "common/system.h"
+#include "common/tokenizer.h"
+
+#include "test/instrset_detect.h"
+#include "test/system/null_osystem.h"
+
+static const char *const kDefaultScript =
+	"raw16 synth rate=22050 stereo=1 length=20\n"
+	"raw8 synth rate=11025 volume=200 balance=-60 length=15\n"
+	"ima-adpcm synth rate=22050 volume=160 length=20\n"
+	"ms-adpcm synth rate=44100 stereo=1 volume=120 length=20\n"
+	"opl synth length=20\n";
+
+enum {
+	kMixFrames = 2048,
+	kMinBenchmarkMillis = 200,
+	kDefaultRate = 44100,
+	kDefaultLengthMillis = 60000
+};
+
+// Checksums of the built-in script at the default rate and length, for
+// mixing without the mix bus, with the mix bus and with the limiter. The
+// OPL part is rendered by the Nuked emulator, the others might differ.
+static const uint32 kDefaultScriptChecksums[3] = { 0x6db29a6e, 0x1b44df3d, 0xee66973c };
+
+struct ScriptEntry {
+	Common::String codec;
+	Common::String source;
+	int rate;
+	bool stereo;
+	byte volume;
+	int8 balance;
+	uint32 lengthMillis;
+	Common::Array<byte> data;
+};
+
+#pragma mark --- Sources ---
+
+static uint32 nextRandom(uint32 &seed) {
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+// Parabolic approximation of a sine wave with an amplitude of 24000, where
+// a full period is 2^32. Integer math keeps the checksum independent of libm.
+static int approximateSine(uint32 phase) {
+	const int32 x = (int32)((phase >> 16) & 0x7fff);
+	const int32 y = (int32)((int64)x * (0x8000 - x) * 24000 >> 28);
+	return (phase & 0x80000000) ? -y : y;
+}
+
+// A sine sweep with some noise on top, so that neither the decoders nor the
+// mixer see trivially predictable data
+static void synthesizeRaw(ScriptEntry &entry, bool is16Bits) {
+	const int channels = entry.stereo ? 2 : 1;
+	const uint32 frames = (uint32)((uint64)entry.rate * entry.lengthMillis / 1000);
+	entry.data.resize(frames * channels * (is16Bits ? 2 : 1));
+
+	uint32 seed = 1;
+	uint32 phase = 0;
+	for (uint32 i = 0; i < frames; ++i) {
+		// Sweep from 110 Hz to 990 Hz, the frequency is in 16.16 fixed point
+		const uint64 frequency = ((110 * (uint64)frames + 880 * (uint64)i) << 16) / frames;
+		phase += (uint32)((frequency << 16) / entry.rate);
+		for (int c = 0; c < channels; ++c) {
+			const int noise = (int)(nextRandom(seed) & 0x7ff) - 0x400;
+			// The right channel is a quarter period ahead
+			const int sample = CLIP<int>(approximateSine(phase + (c << 30)) + noise, -32768, 32767);
+			if (is16Bits)
+				WRITE_LE_INT16(&entry.data[(i * channels + c) * 2], sample);
+			else
+				entry.data[i * channels + c] = (byte)((sample >> 8) ^ 0x80);
+		}
+	}
+}
+
+// Random data is as expensive to decode as real ADPCM data
+static void synthesizeADPCM(ScriptEntry &entry) {
+	const int channels = entry.stereo ? 2 : 1;
+	entry.data.resize((uint32)((uint64)entry.rate * entry.lengthMillis / 1000) * channels / 2);
+
+	uint32 seed = 2;
+	for (uint32 i = 0; i < entry.data.size(); ++i)
+		entry.data[i] = (byte)nextRandom(seed);
+}
+
+static bool loadSource(ScriptEntry &entry) {
+	if (entry.source == "synth") {
+		if (entry.codec == "raw8" || entry.codec == "raw16") {
+			synthesizeRaw(entry, entry.codec == "raw16");
+		} else if (entry.codec == "ima-adpcm" || entry.codec == "ms-adpcm") {
+			synthesizeADPCM(entry);
+		} else if (entry.codec != "opl") {
+			fprintf(stderr, "Codec '%s' cannot be synthesized\n", entry.codec.c_str());
+			return false;
+		}
+		return true;
+	}
+
+	Common::FSNode node(Common::Path(entry.source, Common::Path::kNativeSeparator));
+	Common::SeekableReadStream *stream = node.createReadStream();
+	if (!stream) {
+		fprintf(stderr, "Could not open '%s'\n", entry.source.c_str());
+		return false;
+	}
+
+	entry.data.resize(stream->size());
+	stream->read(entry.data.data(), entry.data.size());
+	delete stream;
+	return true;
+}
+
+#pragma mark --- OPL ---
+
+/**
+ * Plays a fixed arpeggio on all nine voices of an emulated OPL2, as a
+ * stand-in for AdLib music.
+ */
+class OPLProgram {
+public:
+	OPLProgram() : _opl(nullptr), _tick(0) {}
+
+	~OPLProgram() {
+		stop();
+	}
+
+	bool start() {
+		// Nuked OPL is bit exact, so the checksum does not depend on the
+		// default emulator of the build
+		const OPL::Config::DriverId driver = OPL::Config::parse("nuked");
+		if (driver != -1)
+			_opl = OPL::Config::create(driver, OPL::Config::kOpl2);
+		else
+			_opl = OPL::Config::create(OPL::Config::kOpl2);
+		if (!_opl || !_opl->init()) {
+			delete _opl;
+			_opl = nullptr;
+			return false;
+		}
+
+		for (int voice = 0; voice < 9; ++voice) {
+			const int op = kOperators[voice];
+			_opl->writeReg(0x20 + op, 0x21);
+			_opl->writeReg(0x23 + op, 0x21);
+			_opl->writeReg(0x40 + op, 0x18);
+			_opl->writeReg(0x43 + op, 0x00);
+			_opl->writeReg(0x60 + op, 0xf4);
+			_opl->writeReg(0x63 + op, 0xf3);
+			_opl->writeReg(0x80 + op, 0x56);
+			_opl->writeReg(0x83 + op, 0x47);
+			_opl->writeReg(0xc0 + voice, 0x06);
+		}
+
+		_opl->start(new Common::Functor0Mem<void, OPLProgram>(this, &OPLProgram::onTimer));
+		return true;
+	}
+
+	void stop() {
+		if (_opl) {
+			_opl->stop();
+			delete _opl;
+			_opl = nullptr;
+		}
+	}
+
+	bool isPlaying() const { return _opl != nullptr; }
+
+private:
+	static const int kOperators[9];
+	static const int kNotes[7];
+
+	void onTimer() {
+		if (_tick++ % 20)
+			return;
+
+		const int step = _tick / 20;
+		const int voice = step % 9;
+		const int note = kNotes[(step * 5) % 7];
+		const int block = 3 + (step / 7) % 3;
+
+		_opl->writeReg(0xb0 + voice, 0);
+		_opl->writeReg(0xa0 + voice, note & 0xff);
+		_opl->writeReg(0xb0 + voice, 0x20 | (block << 2) | (note >> 8));
+	}
+
+	OPL::OPL *_opl;
+	uint32 _tick;
+};
+
+const int OPLProgram::kOperators[9] = { 0, 1, 2, 8, 9, 10, 16, 17, 18 };
+const int OPLProgram::kNotes[7] = { 0x158, 0x182, 0x1b0, 0x1ca, 0x202, 0x241, 0x287 };
+
+#pragma mark --- Streams ---
+
+static Audio::AudioStream *createStream(const ScriptEntry &entry) {
+	Common::SeekableReadStream *data = new Common::MemoryReadStream(entry.data.data(), entry.data.size());
+	const int channels = entry.stereo ? 2 : 1;
+	Audio::AudioStream *stream = nullptr;
+
+	if (entry.codec == "raw8") {
+		stream = Audio::makeRawStream(data, entry.rate, Audio::FLAG_UNSIGNED | (entry.stereo ? Audio::FLAG_STEREO : 0));
+	} else if (entry.codec == "raw16") {
+		stream = Audio::makeRawStream(data, entry.rate, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN | (entry.stereo ? Audio::FLAG_STEREO : 0));
+	} else if (entry.codec == "ima-adpcm") {
+		stream = Audio::makeADPCMStream(data, DisposeAfterUse::YES, 0, Audio::kADPCMDVI, entry.rate, channels);
+	} else if (entry.codec == "ms-adpcm") {
+		stream = Audio::makeADPCMStream(data, DisposeAfterUse::YES, 0, Audio::kADPCMMS, entry.rate, channels, 1024);
+#ifdef USE_VORBIS
+	} else if (entry.codec == "vorbis") {
+		stream = Audio::makeVorbisStream(data, DisposeAfterUse::YES);
+#endif
+#ifdef USE_MAD
+	} else if (entry.codec == "mp3") {
+		stream = Audio::makeMP3Stream(data, DisposeAfterUse::YES);
+#endif
+#ifdef USE_FLAC
+	} else if (entry.codec == "flac") {
+		stream = Audio::makeFLACStream(data, DisposeAfterUse::YES);
+#endif
+	} else if (entry.codec == "mod") {
+		stream = Audio::makeModXmS3mStream(data, DisposeAfterUse::YES);
+	} else {
+		delete data;
+	}
+
+	// Modules loop forever, so everything is cut to the requested length
+	if (stream)
+		stream = Audio::makeLimitingAudioStream(stream, Audio::Timestamp(entry.lengthMillis, stream->getRate()));
+	return stream;
+}
+
+#pragma mark --- Benchmarks ---
+
+static void printResult(const char *group, const char *name, uint64 frames, uint32 millis, uint rate) {
+	const double seconds = MAX<uint32>(millis, 1) / 1000.0;
+	printf("%-12s %-32s %10u frames %7u ms %12.0f frames/s %8.1fx realtime\n",
+	       group, name, (uint)frames, millis, frames / seconds, frames / seconds / rate);
+}
+
+static bool benchmarkDecoders(const Common::Array<ScriptEntry> &entries) {
+	int16 buffer[4096];
+
+	for (uint i = 0; i < entries.size(); ++i) {
+		const ScriptEntry &entry = entries[i];
+		if (entry.codec == "opl")
+			continue;
+
+		uint64 frames = 0;
+		uint rate = 0;
+		const uint32 start = g_system->getMillis();
+		uint32 elapsed;
+		do {
+			Audio::AudioStream *stream = createStream(entry);
+			if (!stream) {
+				fprintf(stderr, "Could not decode '%s' as %s\n", entry.source.c_str(), entry.codec.c_str());
+				return false;
+			}
+
+			rate = stream->getRate();
+			const int channels = stream->isStereo() ? 2 : 1;
+			int samples;
+			while ((samples = stream->readBuffer(buffer, ARRAYSIZE(buffer))) > 0)
+				frames += samples / channels;
+			delete stream;
+
+			elapsed = g_system->getMillis() - start;
+		} while (elapsed < kMinBenchmarkMillis);
+
+		printResult("decoder", (entry.codec + " " + entry.source).c_str(), frames, elapsed, rate);
+	}
+
+	return true;
+}
+
+static void benchmarkRateConverter(const char *kernelName, uint outRate) {
+	struct Path {
+		const char *name;
+		uint inRate;
+	} paths[] = {
+		{ "copy", outRate },
+		{ "upsample", (outRate % 2) ? 0 : outRate / 2 },
+		{ "downsample", outRate * 2 },
+		{ "interpolate", outRate * 2 / 3 }
+	};
+
+	int16 *out = new int16[outRate * 2];
+
+	for (int p = 0; p < ARRAYSIZE(paths); ++p) {
+		const uint inRate = paths[p].inRate;
+		if (!inRate)
+			continue;
+
+		for (int stereo = 0; stereo < 2; ++stereo) {
+			ScriptEntry entry;
+			entry.rate = inRate;
+			entry.stereo = stereo;
+			entry.lengthMillis = 1000;
+			synthesizeRaw(entry, true);
+
+			Audio::AudioStream *stream = Audio::makeLoopingAudioStream(
+				Audio::makeRawStream(entry.data.data(), entry.data.size(), inRate,
+				                     Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN | (stereo ? Audio::FLAG_STEREO : 0), DisposeAfterUse::NO), 0);
+			Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, stereo, true, false);
+
+			uint64 frames = 0;
+			const uint32 start = g_system->getMillis();
+			uint32 elapsed;
+			do {
+				memset(out, 0, outRate * 2 * sizeof(int16));
+				frames += converter->convert(*stream, (byte *)out, sizeof(int16), outRate, 200, 180, Audio::MIX_CLAMPED_ADD);
+				elapsed = g_system->getMillis() - start;
+			} while (elapsed < kMinBenchmarkMillis);
+
+			delete converter;
+			delete stream;
+
+			const Common::String name = Common::String::format("%s %s %u->%u", paths[p].name, stereo ? "stereo" : "mono", inRate, outRate);
+			printResult(kernelName, name.c_str(), frames, elapsed, outRate);
+		}
+	}
+
+	delete[] out;
+}
+
+static bool benchmarkMixer(Audio::MixerImpl *mixer, const Common::Array<ScriptEntry> &entries, uint32 limitMillis, Common::Array<int16> &output) {
+	const uint rate = mixer->getOutputRate();
+	Audio::Mixer &mixerBase = *mixer;
+	Common::Array<Audio::SoundHandle> handles;
+	OPLProgram opl;
+	uint32 oplFrames = 0;
+
+	for (uint i = 0; i < entries.size(); ++i) {
+		const ScriptEntry &entry = entries[i];
+		if (entry.codec == "opl") {
+			if (opl.isPlaying() || !opl.start()) {
+				fprintf(stderr, "Could not start the OPL emulator\n");
+				return false;
+			}
+			oplFrames = (uint32)((uint64)rate * entry.lengthMillis / 1000);
+			continue;
+		}
+
+		Audio::SoundHandle handle;
+		mixerBase.playStream(Audio::Mixer::kPlainSoundType, &handle, createStream(entry), -1, entry.volume, entry.balance);
+		handles.push_back(handle);
+	}
+
+	const uint32 limitFrames = (uint32)((uint64)rate * limitMillis / 1000);
+	output.resize(limitFrames * 2);
+
+	uint32 frames = 0;
+	const uint32 start = g_system->getMillis();
+	while (frames < limitFrames) {
+		if (opl.isPlaying() && frames >= oplFrames)
+			opl.stop();
+
+		bool active = opl.isPlaying();
+		for (uint i = 0; i < handles.size() && !active; ++i)
+			active = mixer->isSoundHandleActive(handles[i]);
+		if (!active)
+			break;
+
+		const uint32 count = MIN<uint32>(kMixFrames, limitFrames - frames);
+		mixer->mixCallback((byte *)&output[frames * 2], count * 4);
+		frames += count;
+	}
+	const uint32 elapsed = g_system->getMillis() - start;
+
+	opl.stop();
+	mixer->stopAll();
+	output.resize(frames * 2);
+
+	printResult("mixer", Common::String::format("%u streams", entries.size()).c_str(), frames, elapsed, rate);
+	return true;
+}
+
+static bool writeWave(const Common::String &filename, const Common::Array<int16> &samples, uint rate) {
+	Common::DumpFile file;
+	if (!file.open(Common::FSNode(Common::Path(filename, Common::Path::kNativeSeparator)))) {
+		fprintf(stderr, "Could not create '%s'\n", filename.c_str());
+		return false;
+	}
+
+	const uint32 dataSize = samples.size() * 2;
+	file.writeUint32BE(MKTAG('R', 'I', 'F', 'F'));
+	file.writeUint32LE(36 + dataSize);
+	file.writeUint32BE(MKTAG('W', 'A', 'V', 'E'));
+	file.writeUint32BE(MKTAG('f', 'm', 't', ' '));
+	file.writeUint32LE(16);
+	file.writeUint16LE(1);
+	file.writeUint16LE(2);
+	file.writeUint32LE(rate);
+	file.writeUint32LE(rate * 4);
+	file.writeUint16LE(4);
+	file.writeUint16LE(16);
+	file.writeUint32BE(MKTAG('d', 'a', 't', 'a'));
+	file.writeUint32LE(dataSize);
+	for (uint i = 0; i < samples.size(); ++i)
+		file.writeSint16LE(samples[i]);
+
+	return file.flush() && !file.err();
+}
+
+#pragma mark --- Main ---
+
+static bool parseScript(const Common::String &script, uint outRate, uint32 limitMillis, Common::Array<ScriptEntry> &entries) {
+	Common::StringTokenizer lines(script, "\r\n");
+	while (!lines.empty()) {
+		Common::String line = lines.nextToken();
+		line.trim();
+		if (line.empty() || line.hasPrefix("#"))
+			continue;
+
+		Common::StringTokenizer tokens(line, " \t");
+		ScriptEntry entry;
+		entry.codec = tokens.nextToken();
+		entry.source = tokens.nextToken();
+		entry.rate = outRate;
+		entry.stereo = false;
+		entry.volume = Audio::Mixer::kMaxChannelVolume;
+		entry.balance = 0;
+		entry.lengthMillis = limitMillis;
+
+		while (!tokens.empty()) {
+			const Common::String option = tokens.nextToken();
+			const size_t separator = option.findFirstOf('=');
+			const Common::String key = option.substr(0, separator);
+			const int value = separator == Common::String::npos ? 0 : atoi(option.c_str() + separator + 1);
+
+			if (key == "rate" && value > 0)
+				entry.rate = value;
+			else if (key == "stereo")
+				entry.stereo = value != 0;
+			else if (key == "volume")
+				entry.volume = CLIP(value, 0, 255);
+			else if (key == "balance")
+				entry.balance = CLIP(value, -127, 127);
+			else if (key == "length" && value > 0)
+				entry.lengthMillis = MIN<uint32>(value * 1000, limitMillis);
+			else {
+				fprintf(stderr, "Invalid option '%s' in line '%s'\n", option.c_str(), line.c_str());
+				return false;
+			}
+		}
+
+		if (entry.source.empty() || !loadSource(entry))
+			return false;
+		entries.push_back(entry);
+	}
+
+	return true;
+}
+
+static void usage() {
+	fprintf(stderr,
+	        "Usage: audiobench [options] [script]\n"
+	        "  -r <rate>     Output rate (default 44100)\n"
+	        "  -l <seconds>  Maximum length of the mix (default 60)\n"
+	        "  -o <file>     Write the mix to a WAV file\n"
+	        "  -g            Only benchmark the generic rate converter code\n"
+	        "  -q            Enable the mixer command queue\n"
+	        "  -b            Mix into the 32-bit mix bus\n"
+	        "  -L            Mix into the 32-bit mix bus with the master limiter\n");
+}
+
+int main(int argc, char *argv[]) {
+	uint outRate = kDefaultRate;
+	uint32 limitMillis = kDefaultLengthMillis;
+	Common::String scriptFile, outputFile;
+	bool genericOnly = false, commandQueue = false, mixBus = false, limiter = false;
+
+	for (int i = 1; i < argc; ++i) {
+		const Common::String arg = argv[i];
+		if (arg == "-r" && i + 1 < argc) {
+			outRate = atoi(argv[++i]);
+		} else if (arg == "-l" && i + 1 < argc) {
+			limitMillis = atoi(argv[++i]) * 1000;
+		} else if (arg == "-o" && i + 1 < argc) {
+			outputFile = argv[++i];
+		} else if (arg == "-g") {
+			genericOnly = true;
+		} else if (arg == "-q") {
+			commandQueue = true;
+		} else if (arg == "-b") {
+			mixBus = true;
+		} else if (arg == "-L") {
+			mixBus = limiter = true;
+		} else if (arg.hasPrefix("-") || !scriptFile.empty()) {
+			usage();
+			return 1;
+		} else {
+			scriptFile = arg;
+		}
+	}
+
+	if (outRate < 8000 || limitMillis == 0) {
+		usage();
+		return 1;
+	}
+
+	Common::install_null_g_system();
+	Audio::MixerImpl *mixer = Common::install_null_mixer(outRate);
+
+	// The mix bus settings cannot be changed once the command queue runs
+	mixer->enableMixBus(mixBus);
+	mixer->setLimiter(limiter);
+	if (mixer->isMixBusEnabled() != mixBus || mixer->isLimiterEnabled() != limiter) {
+		fprintf(stderr, "Could not set up the mix bus\n");
+		Common::uninstall_null_g_system();
+		return 1;
+	}
+	if (commandQueue && !mixer->enableCommandQueue(true)) {
+		fprintf(stderr, "The mixer command queue is not available in this build\n");
+		Common::uninstall_null_g_system();
+		return 1;
+	}
+
+	Common::String script = kDefaultScript;
+	if (!scriptFile.empty()) {
+		Common::FSNode node(Common::Path(scriptFile, Common::Path::kNativeSeparator));
+		Common::SeekableReadStream *stream = node.createReadStream();
+		if (!stream) {
+			fprintf(stderr, "Could not open '%s'\n", scriptFile.c_str());
+			Common::uninstall_null_g_system();
+			return 1;
+		}
+		script = stream->readString(0, stream->size());
+		delete stream;
+	}
+
+	Common::Array<ScriptEntry> entries;
+	bool success = parseScript(script, outRate, limitMillis, entries);
+
+	// The null backend cannot report CPU features, so the available kernels
+	// are detected here, the same way the unit tests do it
+	Common::Array<const Audio::RateConverterSIMD::Kernels *> kernels;
+	kernels.push_back(nullptr);
+	if (!genericOnly) {
+#ifdef SCUMMVM_NEON
+		kernels.push_back(&Audio::RateConverterSIMD::kernelsNEON);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			kernels.push_back(&Audio::RateConverterSIMD::kernelsSSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			kernels.push_back(&Audio::RateConverterSIMD::kernelsAVX2);
+#endif
+	}
+
+	if (success)
+		success = benchmarkDecoders(entries);
+
+	if (success) {
+		for (uint i = 0; i < kernels.size(); ++i) {
+			Audio::RateConverterSIMD::set(kernels[i]);
+			benchmarkRateConverter(kernels[i] ? kernels[i]->name : "generic", outRate);
+		}
+	}
+
+	// The kernels give identical results, so the fastest one is used for mixing
+	Audio::RateConverterSIMD::set(kernels.back());
+
+	Common::Array<int16> output;
+	if (success)
+		success = benchmarkMixer(mixer, entries, limitMillis, output);
+
+	if (success) {
+		// The checksum covers the little endian samples, like the WAV file
+		Common::CRC32 crc;
+		uint32 checksum = crc.getInitRemainder();
+		for (uint i = 0; i < output.size(); ++i) {
+			checksum = crc.processByte(output[i] & 0xff, checksum);
+			checksum = crc.processByte((output[i] >> 8) & 0xff, checksum);
+		}
+		checksum = crc.finalize(checksum);
+		printf("checksum     %08x (%u frames at %u Hz)\n", checksum, output.size() / 2, outRate);
+
+		if (scriptFile.empty() && outRate == kDefaultRate && limitMillis == kDefaultLengthMillis) {
+			const uint32 expected = kDefaultScriptChecksums[limiter ? 2 : mixBus ? 1 : 0];
+			if (checksum != expected) {
+				fprintf(stderr, "Checksum mismatch, expected %08x\n", expected);
+				success = false;
+			}
+		}
+
+		if (!outputFile.empty())
+			success = writeWave(outputFile, output, outRate);
+	}
+
+	Common::uninstall_null_g_system();
+	return success ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Hash map microbenchmark.
+ *
+ * Compares Common::HashMap with Common::FlatHashMap for integer keys and for
+ * case insensitive string keys, as used by the file system caches and the
+ * configuration manager. For each map size, it measures inserting all keys
+ * into an empty map, looking up present and missing keys, erasing and
+ * reinserting keys and iterating over the map. The results are given in
+ * nanoseconds per operation; each line also prints a checksum of the values
+ * seen, which has to be the same for both maps.
+ */
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_printf
+#define FORBIDDEN_SYMBOL_EXCEPTION_fprintf
+#define FORBIDDEN_SYMBOL_EXCEPTION_stderr
+
+#include "common/scummsys.h"
+
+#include "common/array.h"
+#include "common/flat-hashmap.h"
+#include "common/hash-str.h"
+#include "common/hashmap.h"
+#include "common/str.h"
+#include "common/system.h"
+
+#include "test/system/null_osystem.h"
+
+enum {
+	kMinBenchmarkMillis = 200
+};
+
+static void printResult(const char *map, const char *keys, uint size, const char *operation, uint64 ops, uint32 elapsed, uint32 checksum) {
+	const double nsPerOp = elapsed ? elapsed * 1000000.0 / ops : 0.0;
+	printf("%-12s %-7s %8u  %-8s %9.2f ns/op  checksum %08x\n", map, keys, size, operation, nsPerOp, checksum);
+}
+
+/**
+ * Run one operation on the map repeatedly for at least kMinBenchmarkMillis
+ * and print the time per key.
+ */
+template<class Map, class Key, class Op>
+static void measure(const char *mapName, const char *keyName, const char *operation, Map &map, const Common::Array<Key> &keys, Op op) {
+	uint64 ops = 0;
+	uint32 checksum = 0;
+	const uint32 start = g_system->getMillis();
+	uint32 elapsed;
+	do {
+		checksum = op(map, keys);
+		ops += keys.size();
+		elapsed = g_system->getMillis() - start;
+	} while (elapsed < kMinBenchmarkMillis);
+
+	printResult(mapName, keyName, keys.size(), operation, ops, elapsed, checksum);
+}
+
+template<class Map, class Key>
+static void benchmarkMap(const char *mapName, const char *keyName, const Common::Array<Key> &keys, const Common::Array<Key> &missing) {
+	Map map;
+
+	measure(mapName, keyName, "insert", map, keys, [](Map &m, const Common::Array<Key> &k) {
+		m.clear();
+		for (uint i = 0; i < k.size(); ++i)
+			m[k[i]] = i;
+		return (uint32)m.size();
+	});
+
+	measure(mapName, keyName, "hit", map, keys, [](Map &m, const Common::Array<Key> &k) {
+		uint32 sum = 0;
+		for (uint i = 0; i < k.size(); ++i)
+			sum += m.getVal(k[i]);
+		return sum;
+	});
+
+	measure(mapName, keyName, "miss", map, missing, [](Map &m, const Common::Array<Key> &k) {
+		uint32 sum = 0;
+		for (uint i = 0; i < k.size(); ++i)
+			sum += m.contains(k[i]);
+		return sum;
+	});
+
+	measure(mapName, keyName, "churn", map, keys, [](Map &m, const Common::Array<Key> &k) {
+		for (uint i = 0; i < k.size(); i += 2)
+			m.erase(k[i]);
+		for (uint i = 0; i < k.size(); i += 2)
+			m[k[i]] = i;
+		return (uint32)m.size();
+	});
+
+	measure(mapName, keyName, "iterate", map, keys, [](Map &m, const Common::Array<Key> &k) {
+		uint32 sum = 0;
+		for (typename Map::const_iterator i = m.begin(); i != m.end(); ++i)
+			sum += i->_value;
+		return sum;
+	});
+}
+
+static void benchmarkSize(uint size) {
+	// Integer keys with a stride, which is typical for resource ids and
+	// offsets, and strings similar to file names
+	Common::Array<uint> intKeys, intMissing;
+	Common::Array<Common::String> stringKeys, stringMissing;
+	for (uint i = 0; i < size; ++i) {
+		intKeys.push_back(i * 64);
+		intMissing.push_back(i * 64 + 1);
+		stringKeys.push_back(Common::String::format("RESOURCE.%03u/file%u.dat", i % 1000, i));
+		stringMissing.push_back(Common::String::format("resource.%03u/FILE%u.bak", i % 1000, i));
+	}
+
+	benchmarkMap<Common::HashMap<uint, uint>, uint>("HashMap", "int", intKeys, intMissing);
+	benchmarkMap<Common::FlatHashMap<uint, uint>, uint>("FlatHashMap", "int", intKeys, intMissing);
+
+	typedef Common::HashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> StringHashMap;
+	typedef Common::FlatHashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> StringFlatHashMap;
+	benchmarkMap<StringHashMap, Common::String>("HashMap", "string", stringKeys, stringMissing);
+	benchmarkMap<StringFlatHashMap, Common::String>("FlatHashMap", "string", stringKeys, stringMissing);
+}
+
+static void usage() {
+	fprintf(stderr,
+	        "Usage: hashmapbench [sizes...]\n"
+	        "  Benchmarks maps with the given numbers of keys (default 16 256 4096 65536)\n");
+}
+
+int main(int argc, char *argv[]) {
+	Common::Array<uint> sizes;
+	for (int i = 1; i < argc; ++i) {
+		const int size = atoi(argv[i]);
+		if (size <= 0) {
+			usage();
+			return 1;
+		}
+		sizes.push_back(size);
+	}
+
+	if (sizes.empty()) {
+		sizes.push_back(16);
+		sizes.push_back(256);
+		sizes.push_back(4096);
+		sizes.push_back(65536);
+	}
+
+	Common::install_null_g_system();
+
+	for (uint i = 0; i < sizes.size(); ++i)
+		benchmarkSize(sizes[i]);
+
+	Common::uninstall_null_g_system();
+	return 0;
+}
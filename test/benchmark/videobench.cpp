@@ -0,0 +1,354 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Offline video benchmark.
+ *
+ * Decodes video files on the null backend as fast as possible, through the
+ * Video::VideoDecoder subclass matching their extension, and reports the
+ * throughput of every file. Each frame is also hashed with CRC32, so that
+ * the same run doubles as a bit-exact regression check for the codecs in
+ * image/codecs/.
+ *
+ * The codecs follow from the container: AVI files carry Cinepak, Indeo 3/4/5,
+ * TrueMotion 1 or MSRLE video for instance, QuickTime files SVQ1, QTRLE, RPZA
+ * or SMC. Other formats have their own codec, like Smacker, Bink, Theora or
+ * MPEG-2.
+ */
+
+#define FORBIDDEN_SYMBOL_EXCEPTION_printf
+#define FORBIDDEN_SYMBOL_EXCEPTION_fprintf
+#define FORBIDDEN_SYMBOL_EXCEPTION_stderr
+
+#include "common/scummsys.h"
+
+#include "common/array.h"
+#include "common/crc.h"
+#include "common/fs.h"
+#include "common/system.h"
+
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb_intern.h"
+
+#include "video/avi_decoder.h"
+#include "video/bink_decoder.h"
+#include "video/dxa_decoder.h"
+#include "video/flic_decoder.h"
+#include "video/mkv_decoder.h"
+#include "video/mpegps_decoder.h"
+#include "video/mve_decoder.h"
+#include "video/psx_decoder.h"
+#include "video/qt_decoder.h"
+#include "video/smk_decoder.h"
+#include "video/theora_decoder.h"
+
+#include "test/instrset_detect.h"
+#include "test/system/null_osystem.h"
+
+enum {
+	kMinBenchmarkMillis = 200
+};
+
+#pragma mark --- Decoders ---
+
+template<class T>
+static Video::VideoDecoder *createDecoder() {
+	return new T();
+}
+
+static Video::VideoDecoder *createPSXDecoder() {
+	return new Video::PSXStreamDecoder(Video::PSXStreamDecoder::kCD2x);
+}
+
+static const struct DecoderType {
+	const char *extension;
+	const char *name;
+	Video::VideoDecoder *(*create)();
+} kDecoderTypes[] = {
+	{ "avi", "AVI", createDecoder<Video::AVIDecoder> },
+#ifdef USE_BINK
+	{ "bik", "Bink", createDecoder<Video::BinkDecoder> },
+#endif
+	{ "dxa", "DXA", createDecoder<Video::DXADecoder> },
+	{ "flc", "FLIC", createDecoder<Video::FlicDecoder> },
+	{ "fli", "FLIC", createDecoder<Video::FlicDecoder> },
+#ifdef USE_VPX
+	{ "mkv", "Matroska", createDecoder<Video::MKVDecoder> },
+	{ "webm", "Matroska", createDecoder<Video::MKVDecoder> },
+#endif
+	{ "mov", "QuickTime", createDecoder<Video::QuickTimeDecoder> },
+	{ "mpg", "MPEG-PS", createDecoder<Video::MPEGPSDecoder> },
+	{ "mve", "MVE", createDecoder<Video::MveDecoder> },
+#ifdef USE_THEORADEC
+	{ "ogg", "Theora", createDecoder<Video::TheoraDecoder> },
+	{ "ogv", "Theora", createDecoder<Video::TheoraDecoder> },
+#endif
+	{ "qt", "QuickTime", createDecoder<Video::QuickTimeDecoder> },
+	{ "smk", "Smacker", createDecoder<Video::SmackerDecoder> },
+	{ "str", "PSX", createPSXDecoder },
+	{ "vob", "MPEG-PS", createDecoder<Video::MPEGPSDecoder> }
+};
+
+static const DecoderType *findDecoderType(const Common::String &filename) {
+	const size_t dot = filename.findLastOf('.');
+	if (dot == Common::String::npos)
+		return nullptr;
+
+	const Common::String extension = filename.substr(dot + 1);
+	for (int i = 0; i < ARRAYSIZE(kDecoderTypes); ++i) {
+		if (extension.equalsIgnoreCase(kDecoderTypes[i].extension))
+			return &kDecoderTypes[i];
+	}
+
+	return nullptr;
+}
+
+static Video::VideoDecoder *openVideo(const DecoderType &type, const Common::String &filename, const Graphics::PixelFormat &format) {
+	Common::FSNode node(Common::Path(filename, Common::Path::kNativeSeparator));
+	Common::SeekableReadStream *stream = node.createReadStream();
+	if (!stream) {
+		fprintf(stderr, "Could not open '%s'\n", filename.c_str());
+		return nullptr;
+	}
+
+	Video::VideoDecoder *decoder = type.create();
+	if (!decoder->loadStream(stream)) {
+		fprintf(stderr, "Could not load '%s' as %s\n", filename.c_str(), type.name);
+		delete decoder;
+		return nullptr;
+	}
+
+	// Videos which are not converted from YUV keep their own format
+	decoder->setOutputPixelFormat(format);
+	return decoder;
+}
+
+#pragma mark --- Benchmarks ---
+
+static uint32 hashFrame(const Common::CRC32 &crc, const Graphics::Surface *frame, const byte *palette) {
+	uint32 checksum = crc.getInitRemainder();
+
+	if (frame) {
+		const int rowSize = frame->w * frame->format.bytesPerPixel;
+		for (int y = 0; y < frame->h; ++y) {
+			const byte *row = (const byte *)frame->getBasePtr(0, y);
+			for (int x = 0; x < rowSize; ++x)
+				checksum = crc.processByte(row[x], checksum);
+		}
+	}
+
+	if (palette) {
+		for (int i = 0; i < 256 * 3; ++i)
+			checksum = crc.processByte(palette[i], checksum);
+	}
+
+	return crc.finalize(checksum);
+}
+
+// Prints the CRC32 of every frame and returns a checksum over all of them
+static bool checksumVideo(const DecoderType &type, const Common::String &filename, const Graphics::PixelFormat &format,
+                          uint32 frameLimit, bool printFrames, uint32 &checksum, uint32 &frames) {
+	Video::VideoDecoder *decoder = openVideo(type, filename, format);
+	if (!decoder)
+		return false;
+
+	Common::CRC32 crc;
+	checksum = crc.getInitRemainder();
+	frames = 0;
+
+	while (!decoder->endOfVideo() && frames < frameLimit) {
+		const Graphics::Surface *frame = decoder->decodeNextFrame();
+		const byte *palette = decoder->hasDirtyPalette() ? decoder->getPalette() : nullptr;
+		const uint32 frameChecksum = hashFrame(crc, frame, palette);
+
+		if (printFrames)
+			printf("%s %u %08x%s\n", filename.c_str(), frames, frameChecksum, palette ? " palette" : "");
+
+		for (int i = 0; i < 4; ++i)
+			checksum = crc.processByte((frameChecksum >> (i * 8)) & 0xff, checksum);
+		frames++;
+	}
+
+	checksum = crc.finalize(checksum);
+	delete decoder;
+	return true;
+}
+
+static bool benchmarkVideo(const DecoderType &type, const Common::String &filename, const Graphics::PixelFormat &format,
+                           uint32 frameLimit, const char *kernelName, uint32 checksum, uint32 checksumFrames) {
+	uint64 frames = 0;
+	uint32 elapsed = 0;
+	Common::String info;
+
+	do {
+		Video::VideoDecoder *decoder = openVideo(type, filename, format);
+		if (!decoder)
+			return false;
+
+		info = Common::String::format("%ux%u %ubpp", decoder->getWidth(), decoder->getHeight(), decoder->getPixelFormat().bytesPerPixel * 8);
+
+		// Loading is not part of the measurement
+		const uint32 start = g_system->getMillis();
+		uint32 count = 0;
+		while (!decoder->endOfVideo() && count < frameLimit) {
+			decoder->decodeNextFrame();
+			count++;
+		}
+		elapsed += g_system->getMillis() - start;
+		frames += count;
+
+		delete decoder;
+	} while (elapsed < kMinBenchmarkMillis && frames != 0);
+
+	const double seconds = MAX<uint32>(elapsed, 1) / 1000.0;
+	printf("%-10s %-8s %-20s %6u frames %08x %7u ms %10.1f frames/s  %s\n",
+	       type.name, kernelName, info.c_str(), checksumFrames, checksum, elapsed, frames / seconds, filename.c_str());
+	return true;
+}
+
+#pragma mark --- Main ---
+
+static void usage() {
+	fprintf(stderr,
+	        "Usage: videobench [options] <file>...\n"
+	        "  -n <frames>   Only decode the first frames of each file\n"
+	        "  -c            Print the CRC32 of every frame\n"
+	        "  -f <bpp>      Output format for YUV based codecs, 16 or 32 (default 32)\n"
+	        "  -g            Only benchmark the generic code, not the SIMD kernels\n"
+	        "\n"
+	        "The decoder is chosen by the extension of the file:\n ");
+	for (int i = 0; i < ARRAYSIZE(kDecoderTypes); ++i)
+		fprintf(stderr, " %s", kDecoderTypes[i].extension);
+	fprintf(stderr, "\n");
+}
+
+int main(int argc, char *argv[]) {
+	uint32 frameLimit = 0xFFFFFFFF;
+	bool printFrames = false, genericOnly = false;
+	Graphics::PixelFormat format = Graphics::PixelFormat::createFormatRGBA32();
+	Common::Array<Common::String> files;
+
+	for (int i = 1; i < argc; ++i) {
+		const Common::String arg = argv[i];
+		if (arg == "-n" && i + 1 < argc) {
+			frameLimit = atoi(argv[++i]);
+		} else if (arg == "-c") {
+			printFrames = true;
+		} else if (arg == "-f" && i + 1 < argc) {
+			const int bpp = atoi(argv[++i]);
+			if (bpp == 16) {
+				format = Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0);
+			} else if (bpp != 32) {
+				usage();
+				return 1;
+			}
+		} else if (arg == "-g") {
+			genericOnly = true;
+		} else if (arg.hasPrefix("-")) {
+			usage();
+			return 1;
+		} else {
+			files.push_back(arg);
+		}
+	}
+
+	if (files.empty() || frameLimit == 0) {
+		usage();
+		return 1;
+	}
+
+	Common::install_null_g_system();
+
+	// The null backend cannot report CPU features, so the available kernels
+	// are detected here, the same way the unit tests do it
+	struct KernelSet {
+		const char *name;
+		const Graphics::YUVToRGBSIMD::Kernels *yuvToRGB;
+		const Video::BinkIDCTSIMD::Kernels *binkIDCT;
+	};
+
+	Common::Array<KernelSet> kernels;
+	KernelSet generic = { "generic", nullptr, nullptr };
+	kernels.push_back(generic);
+	if (!genericOnly) {
+#ifdef SCUMMVM_NEON
+		KernelSet neon = { "NEON", &Graphics::YUVToRGBSIMD::kernelsNEON, nullptr };
+#ifdef USE_BINK
+		neon.binkIDCT = &Video::BinkIDCTSIMD::kernelsNEON;
+#endif
+		kernels.push_back(neon);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2) {
+			KernelSet sse2 = { "SSE2", &Graphics::YUVToRGBSIMD::kernelsSSE2, nullptr };
+#ifdef USE_BINK
+			sse2.binkIDCT = &Video::BinkIDCTSIMD::kernelsSSE2;
+#endif
+			kernels.push_back(sse2);
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8) {
+			KernelSet avx2 = { "AVX2", &Graphics::YUVToRGBSIMD::kernelsAVX2, nullptr };
+#ifdef USE_BINK
+			avx2.binkIDCT = &Video::BinkIDCTSIMD::kernelsAVX2;
+#endif
+			kernels.push_back(avx2);
+		}
+#endif
+	}
+
+	bool success = true;
+	for (uint i = 0; i < files.size(); ++i) {
+		const DecoderType *type = findDecoderType(files[i]);
+		if (!type) {
+			fprintf(stderr, "No decoder for '%s'\n", files[i].c_str());
+			success = false;
+			continue;
+		}
+
+		// All kernels must give the checksum of the generic code
+		uint32 genericChecksum = 0;
+		for (uint k = 0; k < kernels.size(); ++k) {
+			Graphics::YUVToRGBSIMD::set(kernels[k].yuvToRGB);
+#ifdef USE_BINK
+			Video::BinkIDCTSIMD::set(kernels[k].binkIDCT);
+#endif
+
+			uint32 checksum, frames;
+			if (!checksumVideo(*type, files[i], format, frameLimit, printFrames && k == 0, checksum, frames) ||
+			    !benchmarkVideo(*type, files[i], format, frameLimit, kernels[k].name, checksum, frames)) {
+				success = false;
+				break;
+			}
+
+			if (k == 0) {
+				genericChecksum = checksum;
+			} else if (checksum != genericChecksum) {
+				fprintf(stderr, "The %s kernels do not decode '%s' like the generic code\n", kernels[k].name, files[i].c_str());
+				success = false;
+			}
+		}
+	}
+
+	Common::uninstall_null_g_system();
+	return success ? 0 : 1;
+}
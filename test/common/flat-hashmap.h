@@ -0,0 +1,110 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/flat-hashmap.h"
+#include "common/hash-str.h"
+
+class FlatHashMapTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_empty_clear() {
+		Common::FlatHashMap<int, int> container;
+		TS_ASSERT(container.empty());
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(!container.empty());
+		container.clear();
+		TS_ASSERT(container.empty());
+		TS_ASSERT(!container.contains(0));
+		TS_ASSERT(container.begin() == container.end());
+	}
+
+	void test_add_remove() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		TS_ASSERT(container.contains(1));
+		container.erase(1);
+		TS_ASSERT(!container.contains(1));
+		TS_ASSERT_EQUALS(container.size(), 2u);
+		container[1] = 42;
+		TS_ASSERT_EQUALS(container[1], 42);
+		container.erase(container.find(0));
+		container.erase(7);
+		TS_ASSERT_EQUALS(container.size(), 2u);
+		TS_ASSERT_EQUALS(container.getValOrDefault(0, -1), -1);
+		TS_ASSERT_EQUALS(container.getVal(2), 45);
+
+		int out = 0;
+		TS_ASSERT(container.tryGetVal(1, out));
+		TS_ASSERT_EQUALS(out, 42);
+		TS_ASSERT(!container.tryGetVal(0, out));
+	}
+
+	void test_string_keys() {
+		Common::FlatHashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> container;
+		container["foo"] = "bar";
+		container.setVal("Quux", "blub");
+		TS_ASSERT(container.contains("FOO"));
+		TS_ASSERT(container.contains("quux"));
+		TS_ASSERT(!container.contains("bar"));
+		TS_ASSERT_EQUALS(container["QUUX"], "blub");
+
+		const Common::FlatHashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> copy(container);
+		container["foo"] = "changed";
+		TS_ASSERT_EQUALS(copy["foo"], "bar");
+		TS_ASSERT_EQUALS(copy.size(), 2u);
+	}
+
+	void test_iterator() {
+		Common::FlatHashMap<int, int> container;
+		for (int i = 0; i < 100; ++i)
+			container[i * 37] = i;
+		container.erase(37);
+
+		int count = 0, sum = 0;
+		for (Common::FlatHashMap<int, int>::const_iterator i = container.begin(); i != container.end(); ++i) {
+			TS_ASSERT_EQUALS(i->_key, i->_value * 37);
+			sum += i->_value;
+			++count;
+		}
+		TS_ASSERT_EQUALS(count, 99);
+		TS_ASSERT_EQUALS(sum, 99 * 100 / 2 - 1);
+	}
+
+	void test_matches_hashmap() {
+		// Random inserts, lookups and erases with many collisions in the
+		// low bits of the keys, checked against HashMap
+		uint32 seed = 12345;
+		Common::HashMap<uint, Common::String> expected;
+		Common::FlatHashMap<uint, Common::String> actual;
+
+		for (int i = 0; i < 20000; ++i) {
+			seed = seed * 1103515245 + 12345;
+			const uint key = ((seed >> 8) % 3001) << 8;
+			switch (seed >> 30) {
+			case 0:
+			case 1:
+				expected[key] = Common::String::format("%u", i);
+				actual[key] = Common::String::format("%u", i);
+				break;
+			case 2:
+				expected.erase(key);
+				actual.erase(key);
+				break;
+			default:
+				TS_ASSERT_EQUALS(expected.contains(key), actual.contains(key));
+				break;
+			}
+		}
+
+		TS_ASSERT_EQUALS(expected.size(), actual.size());
+		for (Common::HashMap<uint, Common::String>::const_iterator i = expected.begin(); i != expected.end(); ++i)
+			TS_ASSERT_EQUALS(actual.getValOrDefault(i->_key), i->_value);
+
+		actual.clear(true);
+		TS_ASSERT(actual.empty());
+		actual[5] = "five";
+		TS_ASSERT_EQUALS(actual.size(), 1u);
+	}
+};
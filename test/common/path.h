@@ -605,4 +605,44 @@ class PathTestSuite : public CxxTest::TestSuite
 		p15.removeExtension(".dir");
 		TS_ASSERT_EQUALS(p15.toString(), "");
 	}
+
+	void test_cachedHashes() {
+		// Hashes are cached by the path and must follow every modification
+		Common::Path p("parent/dir");
+		uint hash = p.hashIgnoreCase();
+		uint macHash = p.hashIgnoreCaseAndMac();
+
+		Common::Path copy(p);
+		TS_ASSERT_EQUALS(copy.hashIgnoreCase(), hash);
+		TS_ASSERT_EQUALS(copy.hashIgnoreCaseAndMac(), macHash);
+
+		p.joinInPlace("file.txt");
+		TS_ASSERT_EQUALS(p.hashIgnoreCase(), Common::Path("parent/dir/file.txt").hashIgnoreCase());
+		TS_ASSERT_EQUALS(p.hashIgnoreCaseAndMac(), Common::Path("parent/dir/file.txt").hashIgnoreCaseAndMac());
+
+		p.removeExtension();
+		TS_ASSERT_EQUALS(p.hashIgnoreCase(), Common::Path("parent/dir/file").hashIgnoreCase());
+		TS_ASSERT_EQUALS(p.hashIgnoreCaseAndMac(), Common::Path("parent/dir/file").hashIgnoreCaseAndMac());
+
+		p.appendInPlace("/");
+		p.removeTrailingSeparators();
+		TS_ASSERT_EQUALS(p.hashIgnoreCaseAndMac(), Common::Path("parent/dir/file").hashIgnoreCaseAndMac());
+
+		Common::Path child = copy.appendComponent("File");
+		TS_ASSERT_EQUALS(child.hashIgnoreCase(), p.hashIgnoreCase());
+		TS_ASSERT_EQUALS(child.hashIgnoreCaseAndMac(), p.hashIgnoreCaseAndMac());
+
+		p.toUppercase();
+		TS_ASSERT_EQUALS(p.hashIgnoreCase(), child.hashIgnoreCase());
+
+		p = "other";
+		TS_ASSERT_EQUALS(p.hashIgnoreCase(), Common::Path("OTHER").hashIgnoreCase());
+		TS_ASSERT_EQUALS(p.hashIgnoreCaseAndMac(), Common::Path("OTHER").hashIgnoreCaseAndMac());
+
+		p = copy;
+		TS_ASSERT_EQUALS(p.hashIgnoreCaseAndMac(), macHash);
+
+		p.clear();
+		TS_ASSERT_EQUALS(p.hashIgnoreCase(), Common::Path().hashIgnoreCase());
+	}
 };
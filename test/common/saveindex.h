@@ -0,0 +1,95 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "common/saveindex.h"
+
+class SaveIndexTestSuite : public CxxTest::TestSuite {
+public:
+	void test_index_name() {
+		TS_ASSERT_EQUALS(Common::SaveIndex::getIndexName("monkey1.005"), "monkey1.idx");
+		TS_ASSERT_EQUALS(Common::SaveIndex::getIndexName("sq4.cd.s12"), "sq4.cd.idx");
+		TS_ASSERT(Common::SaveIndex::getIndexName("monkey1.idx").empty());
+		TS_ASSERT(Common::SaveIndex::getIndexName("savegame").empty());
+		TS_ASSERT(Common::SaveIndex::getIndexName(".005").empty());
+	}
+
+	void test_round_trip() {
+		Common::SaveIndex index;
+		TS_ASSERT(!index.isModified());
+
+		Common::SaveIndexEntry entry;
+		entry.size = 12345;
+		entry.modTime = 1700000000;
+		entry.saveDate = (17 << 24) | (10 << 16) | 2026;
+		entry.saveTime = (13 << 8) | 37;
+		entry.playTime = 3600000;
+		entry.isAutosave = true;
+		entry.description = "Before the bridge";
+		index.set("monkey1.000", entry);
+
+		entry.isAutosave = false;
+		entry.description = "";
+		index.set("monkey1.001", entry);
+		TS_ASSERT(index.isModified());
+
+		Common::MemoryWriteStreamDynamic out(DisposeAfterUse::YES);
+		index.saveToStream(out);
+
+		Common::SaveIndex loaded;
+		Common::MemoryReadStream in(out.getData(), out.size());
+		TS_ASSERT(loaded.loadFromStream(in));
+		TS_ASSERT_EQUALS(loaded.size(), 2u);
+
+		const Common::SaveIndexEntry *first = loaded.find("MONKEY1.000");
+		TS_ASSERT(first);
+		if (first) {
+			TS_ASSERT_EQUALS(first->size, 12345u);
+			TS_ASSERT_EQUALS(first->modTime, 1700000000u);
+			TS_ASSERT_EQUALS(first->saveDate, entry.saveDate);
+			TS_ASSERT_EQUALS(first->saveTime, entry.saveTime);
+			TS_ASSERT_EQUALS(first->playTime, 3600000u);
+			TS_ASSERT(first->isAutosave);
+			TS_ASSERT_EQUALS(first->description, "Before the bridge");
+		}
+		const Common::SaveIndexEntry *second = loaded.find("monkey1.001");
+		TS_ASSERT(second);
+		if (second)
+			TS_ASSERT(second->description.empty());
+
+		// Truncated data is rejected
+		Common::MemoryReadStream truncated(out.getData(), out.size() - 3);
+		TS_ASSERT(!loaded.loadFromStream(truncated));
+	}
+
+	void test_retain() {
+		Common::SaveIndex index;
+		index.set("qfg1.000", Common::SaveIndexEntry());
+		index.set("qfg1.001", Common::SaveIndexEntry());
+		index.set("qfg1.002", Common::SaveIndexEntry());
+
+		Common::SaveIndex loaded;
+		Common::MemoryWriteStreamDynamic out(DisposeAfterUse::YES);
+		index.saveToStream(out);
+		Common::MemoryReadStream in(out.getData(), out.size());
+		TS_ASSERT(loaded.loadFromStream(in));
+		TS_ASSERT(!loaded.isModified());
+
+		Common::StringArray files;
+		files.push_back("QFG1.000");
+		files.push_back("qfg1.002");
+		files.push_back("qfg1.003");
+		files.push_back("qfg1.001");
+		loaded.retain(files);
+		TS_ASSERT(!loaded.isModified());
+
+		files.pop_back();
+		loaded.retain(files);
+		TS_ASSERT(loaded.isModified());
+		TS_ASSERT_EQUALS(loaded.size(), 2u);
+		TS_ASSERT(!loaded.find("qfg1.001"));
+		TS_ASSERT(loaded.find("qfg1.002"));
+
+		TS_ASSERT(loaded.remove("qfg1.000"));
+		TS_ASSERT(!loaded.remove("qfg1.000"));
+	}
+};
@@ -0,0 +1,187 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/memstream.h"
+
+namespace {
+
+// A tiny archive whose members contain the archive name
+class NamedArchive : public Common::Archive {
+public:
+	NamedArchive(const char *name, const char *const *files) : _name(name), _lookups(0) {
+		for (; *files; ++files)
+			_files.push_back(Common::Path(*files));
+	}
+
+	bool hasFile(const Common::Path &path) const override {
+		_lookups++;
+		for (const Common::Path &file : _files) {
+			if (file.equalsIgnoreCase(path))
+				return true;
+		}
+		return false;
+	}
+
+	int listMembers(Common::ArchiveMemberList &list) const override {
+		for (const Common::Path &file : _files)
+			list.push_back(Common::ArchiveMemberPtr(new Common::GenericArchiveMember(file, *this)));
+		return _files.size();
+	}
+
+	const Common::ArchiveMemberPtr getMember(const Common::Path &path) const override {
+		if (!hasFile(path))
+			return Common::ArchiveMemberPtr();
+		return Common::ArchiveMemberPtr(new Common::GenericArchiveMember(path, *this));
+	}
+
+	Common::SeekableReadStream *createReadStreamForMember(const Common::Path &path) const override {
+		if (!hasFile(path))
+			return nullptr;
+		return new Common::MemoryReadStream((const byte *)_name, strlen(_name));
+	}
+
+	const char *_name;
+	Common::Array<Common::Path> _files;
+	mutable int _lookups;
+};
+
+// An archive which can open files it doesn't list, and which matches patterns
+// against the file names only, like FSDirectory in flat mode
+class FlatArchive : public NamedArchive {
+public:
+	FlatArchive(const char *name, const char *const *files) : NamedArchive(name, files) {}
+
+	bool hasFile(const Common::Path &path) const override {
+		return NamedArchive::hasFile(path) || path.baseName().equalsIgnoreCase("unlisted.txt");
+	}
+
+	int listMatchingMembers(Common::ArchiveMemberList &list, const Common::Path &pattern, bool matchPathComponents) const override {
+		int matches = 0;
+		for (const Common::Path &file : _files) {
+			if (file.baseName().matchString(pattern.toString(), true)) {
+				list.push_back(Common::ArchiveMemberPtr(new Common::GenericArchiveMember(file, *this)));
+				matches++;
+			}
+		}
+		return matches;
+	}
+};
+
+} // End of anonymous namespace
+
+class SearchSetTestSuite : public CxxTest::TestSuite {
+	static Common::String listNames(const Common::SearchSet &set, const char *pattern, bool matchPathComponents) {
+		Common::ArchiveMemberDetailsList list;
+		set.listMatchingMembers(list, Common::Path(pattern), matchPathComponents);
+
+		Common::String result;
+		for (const Common::ArchiveMemberDetails &details : list)
+			result += details.arcName + ":" + details.arcMember->getPathInArchive().toString() + " ";
+		return result;
+	}
+
+	static Common::String readMember(const Common::SearchSet &set, const char *path) {
+		Common::SeekableReadStream *stream = set.createReadStreamForMember(Common::Path(path));
+		if (!stream)
+			return Common::String();
+		Common::String result = stream->readString(0, stream->size());
+		delete stream;
+		return result;
+	}
+
+public:
+	void test_index_lookups() {
+		static const char *const lowFiles[] = { "a.txt", "b.txt", "dir/c.txt", nullptr };
+		static const char *const highFiles[] = { "B.TXT", "dir/d.txt", nullptr };
+		NamedArchive *low = new NamedArchive("low", lowFiles);
+		NamedArchive *high = new NamedArchive("high", highFiles);
+
+		Common::SearchSet set;
+		set.add("low", low, 0);
+		set.add("high", high, 10);
+
+		for (int pass = 0; pass < 2; ++pass) {
+			set.setUseIndex(pass == 1);
+
+			TS_ASSERT_EQUALS(readMember(set, "a.txt"), "low");
+			TS_ASSERT_EQUALS(readMember(set, "b.txt"), "high");
+			TS_ASSERT_EQUALS(readMember(set, "DIR/C.TXT"), "low");
+			TS_ASSERT_EQUALS(readMember(set, "dir/d.txt"), "high");
+			TS_ASSERT_EQUALS(readMember(set, "missing.txt"), "");
+			TS_ASSERT(set.hasFile("dir/c.txt"));
+			TS_ASSERT(!set.hasFile("dir"));
+
+			Common::Archive *container = nullptr;
+			TS_ASSERT(set.getMember("b.txt", &container));
+			TS_ASSERT_EQUALS(container, high);
+		}
+
+		// Hits only ask the archive holding the file
+		low->_lookups = high->_lookups = 0;
+		TS_ASSERT(set.hasFile("a.txt"));
+		TS_ASSERT_EQUALS(low->_lookups, 1);
+		TS_ASSERT_EQUALS(high->_lookups, 0);
+	}
+
+	void test_index_invalidation() {
+		static const char *const firstFiles[] = { "a.txt", nullptr };
+		static const char *const secondFiles[] = { "a.txt", "b.txt", nullptr };
+
+		Common::SearchSet set;
+		set.setUseIndex(true);
+		set.add("first", new NamedArchive("first", firstFiles), 0);
+		TS_ASSERT(!set.hasFile("b.txt"));
+
+		set.add("second", new NamedArchive("second", secondFiles), 0);
+		TS_ASSERT(set.hasFile("b.txt"));
+		TS_ASSERT_EQUALS(readMember(set, "a.txt"), "first");
+
+		set.setPriority("second", 5);
+		TS_ASSERT_EQUALS(readMember(set, "a.txt"), "second");
+
+		set.remove("second");
+		TS_ASSERT(!set.hasFile("b.txt"));
+		TS_ASSERT_EQUALS(readMember(set, "a.txt"), "first");
+
+		set.clear();
+		TS_ASSERT(!set.hasFile("a.txt"));
+	}
+
+	void test_index_matches_walk() {
+		static const char *const lowFiles[] = { "a.txt", "b.txt", "dir/c.txt", nullptr };
+		static const char *const highFiles[] = { "B.TXT", "dir/d.dat", nullptr };
+		static const char *const flatFiles[] = { "sub/e.txt", "sub/deeper/f.dat", nullptr };
+		static const char *const patterns[] = { "*", "*.txt", "*.dat", "dir/*", "*/*", "b.txt", "e.txt", nullptr };
+		static const char *const paths[] = { "a.txt", "B.txt", "dir/d.dat", "sub/e.txt", "unlisted.txt", "sub/unlisted.txt", "dir", "missing.txt", nullptr };
+
+		Common::SearchSet set;
+		set.add("low", new NamedArchive("low", lowFiles), 0);
+		set.add("high", new NamedArchive("high", highFiles), 10);
+		set.add("flat", new FlatArchive("flat", flatFiles), 5);
+
+		for (const char *const *pattern = patterns; *pattern; ++pattern) {
+			for (int matchPathComponents = 0; matchPathComponents < 2; ++matchPathComponents) {
+				set.setUseIndex(false);
+				const Common::String walked = listNames(set, *pattern, matchPathComponents);
+				set.setUseIndex(true);
+				TSM_ASSERT_EQUALS(*pattern, listNames(set, *pattern, matchPathComponents), walked);
+			}
+		}
+
+		for (const char *const *path = paths; *path; ++path) {
+			set.setUseIndex(false);
+			const bool walkedHasFile = set.hasFile(*path);
+			const Common::String walkedContents = readMember(set, *path);
+			set.setUseIndex(true);
+			TSM_ASSERT_EQUALS(*path, set.hasFile(*path), walkedHasFile);
+			TSM_ASSERT_EQUALS(*path, readMember(set, *path), walkedContents);
+		}
+
+		// Files the archives don't list are still found
+		TS_ASSERT(set.hasFile("sub/unlisted.txt"));
+		TS_ASSERT_EQUALS(readMember(set, "unlisted.txt"), "flat");
+
+		Common::ArchiveMemberList list;
+		TS_ASSERT_EQUALS(set.listMembers(list), 7);
+	}
+};
@@ -0,0 +1,154 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#include "graphics/blit.h"
+#include "graphics/blit/blit-simd.h"
+
+class CrossBlitTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kWidth = 37,            // Leaves a remainder after the vectorized loops
+		kHeight = 5,
+		kPitch = 45 * 4
+	};
+
+	static void fillBuffer(byte *buffer, int size, uint32 seed) {
+		for (int i = 0; i < size; ++i) {
+			seed = seed * 1103515245 + 12345;
+			buffer[i] = seed >> 16;
+		}
+	}
+
+	static void compareKernels(const Graphics::CrossBlitSIMD::Kernels *kernels) {
+		static const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 0, 5, 11, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 0, 10, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15),
+			Graphics::PixelFormat(2, 4, 4, 4, 4, 8, 4, 0, 12),
+			Graphics::PixelFormat(2, 4, 4, 4, 4, 12, 8, 4, 0),
+			Graphics::PixelFormat(3, 8, 8, 8, 0, 16, 8, 0, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 0, 8, 16, 24),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 8, 16, 24, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 0, 8, 16, 0)
+		};
+
+		byte src[kPitch * kHeight];
+		byte expected[kPitch * kHeight * 2], actual[kPitch * kHeight * 2];
+		fillBuffer(src, sizeof(src), 1);
+
+		for (int s = 0; s < ARRAYSIZE(formats); ++s) {
+			for (int d = 0; d < ARRAYSIZE(formats); ++d) {
+				if (s == d)
+					continue;
+
+				const Graphics::PixelFormat &srcFmt = formats[s];
+				const Graphics::PixelFormat &dstFmt = formats[d];
+				const uint dstPitch = kPitch * dstFmt.bytesPerPixel / srcFmt.bytesPerPixel;
+
+				Graphics::CrossBlitSIMD::set(nullptr);
+				memset(expected, 0x55, sizeof(expected));
+				Graphics::crossBlit(expected, src, dstPitch, kPitch, kWidth, kHeight, dstFmt, srcFmt);
+
+				Graphics::CrossBlitSIMD::set(kernels);
+				memset(actual, 0x55, sizeof(actual));
+				Graphics::crossBlit(actual, src, dstPitch, kPitch, kWidth, kHeight, dstFmt, srcFmt);
+				TSM_ASSERT_EQUALS(kernels->name, memcmp(expected, actual, sizeof(expected)), 0);
+
+				// In place, which only works when the pitch grows with the depth
+				memset(actual, 0x55, sizeof(actual));
+				memcpy(actual, src, sizeof(src));
+				Graphics::crossBlit(actual, actual, dstPitch, kPitch, kWidth, kHeight, dstFmt, srcFmt);
+				for (int y = 0; y < kHeight; ++y)
+					TSM_ASSERT_EQUALS(kernels->name, memcmp(expected + y * dstPitch, actual + y * dstPitch, kWidth * dstFmt.bytesPerPixel), 0);
+			}
+		}
+
+		Graphics::CrossBlitSIMD::set(nullptr);
+	}
+
+	static void compareMapKernels(const Graphics::CrossBlitSIMD::Kernels *kernels) {
+		uint32 map[256];
+		fillBuffer((byte *)map, sizeof(map), 2);
+
+		byte src[kPitch * kHeight];
+		byte expected[kPitch * kHeight * 4], actual[kPitch * kHeight * 4];
+		fillBuffer(src, sizeof(src), 3);
+
+		for (uint bpp = 1; bpp <= 4; ++bpp) {
+			Graphics::CrossBlitSIMD::set(nullptr);
+			memset(expected, 0x55, sizeof(expected));
+			Graphics::crossBlitMap(expected, src, kPitch * bpp, kPitch, kWidth, kHeight, bpp, map);
+
+			Graphics::CrossBlitSIMD::set(kernels);
+			memset(actual, 0x55, sizeof(actual));
+			Graphics::crossBlitMap(actual, src, kPitch * bpp, kPitch, kWidth, kHeight, bpp, map);
+			TSM_ASSERT_EQUALS(kernels->name, memcmp(expected, actual, sizeof(expected)), 0);
+
+			memset(actual, 0x55, sizeof(actual));
+			memcpy(actual, src, sizeof(src));
+			Graphics::crossBlitMap(actual, actual, kPitch * bpp, kPitch, kWidth, kHeight, bpp, map);
+			for (int y = 0; y < kHeight; ++y)
+				TSM_ASSERT_EQUALS(kernels->name, memcmp(expected + y * kPitch * bpp, actual + y * kPitch * bpp, kWidth * bpp), 0);
+		}
+
+		Graphics::CrossBlitSIMD::set(nullptr);
+	}
+
+	static void compareSwapKernels(const Graphics::CrossBlitSIMD::Kernels *kernels) {
+		const Graphics::PixelFormat rgba(4, 8, 8, 8, 8, 24, 16, 8, 0);
+		const Graphics::PixelFormat argb(4, 8, 8, 8, 8, 16, 8, 0, 24);
+		const Graphics::PixelFormat bgra(4, 8, 8, 8, 8, 8, 16, 24, 0);
+		const Graphics::PixelFormat abgr(4, 8, 8, 8, 8, 0, 8, 16, 24);
+		const Graphics::PixelFormat pairs[][2] = {
+			{ rgba, abgr }, { argb, bgra }, { rgba, argb }, { abgr, bgra }, { abgr, argb }, { rgba, bgra }
+		};
+
+		byte src[kPitch * kHeight];
+		byte expected[kPitch * kHeight], actual[kPitch * kHeight];
+		fillBuffer(src, sizeof(src), 4);
+
+		for (int i = 0; i < ARRAYSIZE(pairs); ++i) {
+			Graphics::FastBlitFunc func = Graphics::getFastBlitFunc(pairs[i][1], pairs[i][0]);
+			TS_ASSERT(func);
+			if (!func)
+				continue;
+
+			Graphics::CrossBlitSIMD::set(nullptr);
+			memset(expected, 0x55, sizeof(expected));
+			func(expected, src, kPitch, kPitch, kWidth, kHeight);
+
+			Graphics::CrossBlitSIMD::set(kernels);
+			memset(actual, 0x55, sizeof(actual));
+			func(actual, src, kPitch, kPitch, kWidth, kHeight);
+			TSM_ASSERT_EQUALS(kernels->name, memcmp(expected, actual, sizeof(expected)), 0);
+		}
+
+		Graphics::CrossBlitSIMD::set(nullptr);
+	}
+
+	static void compareAll(const Graphics::CrossBlitSIMD::Kernels *kernels) {
+		compareKernels(kernels);
+		compareMapKernels(kernels);
+		compareSwapKernels(kernels);
+	}
+
+public:
+	void test_simd_kernels_match_generic() {
+#ifdef SCUMMVM_NEON
+		compareAll(&Graphics::CrossBlitSIMD::kernelsNEON);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			compareAll(&Graphics::CrossBlitSIMD::kernelsSSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			compareAll(&Graphics::CrossBlitSIMD::kernelsAVX2);
+#endif
+	}
+};
@@ -0,0 +1,104 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/dirtyrects.h"
+
+class DirtyRectsTestSuite : public CxxTest::TestSuite {
+	enum {
+		kMaxWaste = 200,
+		kMaxRects = 4
+	};
+
+	static uint countPixels(const Graphics::DirtyRectList &list) {
+		uint pixels = 0;
+		for (Graphics::DirtyRectList::const_iterator i = list.begin(); i != list.end(); ++i)
+			pixels += i->width() * i->height();
+		return pixels;
+	}
+
+	static bool hasRect(const Graphics::DirtyRectList &list, const Common::Rect &rect) {
+		for (Graphics::DirtyRectList::const_iterator i = list.begin(); i != list.end(); ++i) {
+			if (*i == rect)
+				return true;
+		}
+		return false;
+	}
+
+public:
+	void test_far_rects_stay_apart() {
+		Graphics::DirtyRectList list;
+		list.addCoalesced(Common::Rect(0, 0, 10, 10), kMaxWaste, kMaxRects);
+		list.addCoalesced(Common::Rect(300, 200, 310, 210), kMaxWaste, kMaxRects);
+		TS_ASSERT_EQUALS(list.size(), 2u);
+		TS_ASSERT_EQUALS(countPixels(list), 200u);
+
+		// Empty and covered rects are dropped
+		list.addCoalesced(Common::Rect(), kMaxWaste, kMaxRects);
+		list.addCoalesced(Common::Rect(2, 2, 5, 5), kMaxWaste, kMaxRects);
+		TS_ASSERT_EQUALS(list.size(), 2u);
+	}
+
+	void test_close_rects_merge() {
+		Graphics::DirtyRectList list;
+		list.addCoalesced(Common::Rect(0, 0, 10, 10), kMaxWaste, kMaxRects);
+		list.addCoalesced(Common::Rect(20, 20, 30, 30), kMaxWaste, kMaxRects);
+		// Touching the first one
+		list.addCoalesced(Common::Rect(10, 0, 20, 10), kMaxWaste, kMaxRects);
+		TS_ASSERT_EQUALS(list.size(), 2u);
+		TS_ASSERT(hasRect(list, Common::Rect(0, 0, 20, 10)));
+
+		// Bridges the gap, which makes the bounding box of all of them cheap
+		list.addCoalesced(Common::Rect(0, 10, 30, 20), kMaxWaste, kMaxRects);
+		TS_ASSERT_EQUALS(list.size(), 1u);
+		TS_ASSERT(hasRect(list, Common::Rect(0, 0, 30, 30)));
+	}
+
+	void test_rect_limit() {
+		Graphics::DirtyRectList list;
+		for (int i = 0; i < 8; ++i)
+			list.addCoalesced(Common::Rect(i * 100, i * 50, i * 100 + 4, i * 50 + 4), kMaxWaste, kMaxRects);
+
+		TS_ASSERT_EQUALS(list.size(), (uint)kMaxRects);
+
+		// Everything is still covered
+		for (int i = 0; i < 8; ++i) {
+			bool covered = false;
+			for (Graphics::DirtyRectList::const_iterator r = list.begin(); r != list.end(); ++r)
+				covered |= r->contains(Common::Rect(i * 100, i * 50, i * 100 + 4, i * 50 + 4));
+			TS_ASSERT(covered);
+		}
+	}
+
+	void test_changed_blocks() {
+		enum {
+			kWidth = 70,    // Leaves a partial block
+			kHeight = 40,
+			kPitch = kWidth * 2
+		};
+		byte oldImage[kPitch * kHeight], newImage[kPitch * kHeight];
+		for (int i = 0; i < kPitch * kHeight; ++i)
+			oldImage[i] = newImage[i] = i * 7;
+
+		Graphics::DirtyRectList list;
+		TS_ASSERT_EQUALS(list.addChangedBlocks(oldImage, kPitch, newImage, kPitch, 10, 20, kWidth, kHeight, 2, 16), 0u);
+		TS_ASSERT(list.empty());
+
+		// Two full blocks and the last partial block
+		newImage[5 * kPitch + 17 * 2] ^= 1;
+		newImage[20 * kPitch + 40 * 2 + 1] ^= 1;
+		newImage[39 * kPitch + 69 * 2] ^= 1;
+		TS_ASSERT_EQUALS(list.addChangedBlocks(oldImage, kPitch, newImage, kPitch, 10, 20, kWidth, kHeight, 2, 16), 16u * 16 * 2 + 6 * 8);
+		TS_ASSERT_EQUALS(list.size(), 3u);
+		TS_ASSERT(hasRect(list, Common::Rect(26, 20, 42, 36)));
+		TS_ASSERT(hasRect(list, Common::Rect(42, 36, 58, 52)));
+		TS_ASSERT(hasRect(list, Common::Rect(74, 52, 80, 60)));
+
+		// A column of changed blocks
+		memcpy(newImage, oldImage, sizeof(newImage));
+		for (int y = 3; y < kHeight; y += 16)
+			newImage[y * kPitch + 3 * 2] ^= 0x80;
+		list.clear();
+		list.addChangedBlocks(oldImage, kPitch, newImage, kPitch, 10, 20, kWidth, kHeight, 2, 16);
+		TS_ASSERT_EQUALS(list.size(), 1u);
+		TS_ASSERT(hasRect(list, Common::Rect(10, 20, 26, 60)));
+	}
+};
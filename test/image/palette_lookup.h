@@ -0,0 +1,114 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/palette.h"
+
+class PaletteLookupTestSuite : public CxxTest::TestSuite
+{
+private:
+	static uint32 next(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	}
+
+	static void fillPalette(byte *palette, uint len, uint32 seed) {
+		for (uint i = 0; i < len * 3; i++)
+			palette[i] = next(seed);
+
+		// Duplicate entries have to give the lowest index
+		if (len > 8)
+			memcpy(palette + 6 * 3, palette + 2 * 3, 3);
+	}
+
+	static void compareColors(uint len, uint32 seed) {
+		byte palette[256 * 3];
+		fillPalette(palette, len, seed);
+
+		// PaletteLookup always searches 256 entries
+		Graphics::Palette reference(256);
+		reference.set(palette, 0, len);
+
+		const Graphics::PixelFormat format(4, 8, 8, 8, 0, 16, 8, 0, 0);
+		const int w = 64, h = 48;
+		uint32 pixels[w * h];
+		byte result[w * h];
+
+		for (int method = Graphics::kColorDistanceEuclidean; method <= Graphics::kColorDistanceRedmean; method++) {
+			Graphics::PaletteLookup lookup(palette, len);
+			for (int pass = 0; pass < 8; pass++) {
+				// Random colors and the palette entries with small offsets
+				for (int i = 0; i < w * h; i++) {
+					byte r = next(seed), g = next(seed), b = next(seed);
+					if (i & 1) {
+						const byte *entry = &palette[(next(seed) % len) * 3];
+						r = CLIP(entry[0] + (int)(next(seed) % 7) - 3, 0, 255);
+						g = CLIP(entry[1] + (int)(next(seed) % 7) - 3, 0, 255);
+						b = CLIP(entry[2] + (int)(next(seed) % 7) - 3, 0, 255);
+					}
+					pixels[i] = format.RGBToColor(r, g, b);
+				}
+
+				lookup.mapPixels(result, w, pixels, w * 4, w, h, format, (Graphics::ColorDistanceMethod)method);
+
+				for (int i = 0; i < w * h; i++) {
+					byte r, g, b;
+					format.colorToRGB(pixels[i], r, g, b);
+					const byte expected = reference.findBestColor(r, g, b, (Graphics::ColorDistanceMethod)method);
+					TS_ASSERT_EQUALS(result[i], expected);
+					if (result[i] != expected)
+						return;
+				}
+			}
+		}
+	}
+
+public:
+	void test_map_pixels_matches_find_best_color() {
+		compareColors(256, 1);
+		compareColors(64, 2);
+		compareColors(16, 3);
+		compareColors(3, 4);
+	}
+
+	void test_find_best_color_after_palette_change() {
+		byte palette[256 * 3];
+		fillPalette(palette, 256, 5);
+		Graphics::Palette reference(palette, 256);
+
+		Graphics::PaletteLookup lookup(palette, 256);
+		TS_ASSERT_EQUALS(lookup.findBestColor(10, 200, 30), reference.findBestColor(10, 200, 30));
+
+		fillPalette(palette, 256, 6);
+		reference.set(palette, 0, 256);
+		TS_ASSERT(lookup.setPalette(palette, 256));
+		for (int c = 0; c < 256; c += 5) {
+			TS_ASSERT_EQUALS(lookup.findBestColor(c, 255 - c, c / 2), reference.findBestColor(c, 255 - c, c / 2));
+			TS_ASSERT_EQUALS(lookup.findBestColor(c / 2, c, 255 - c, Graphics::kColorDistanceEuclidean),
+			                 reference.findBestColor(c / 2, c, 255 - c, Graphics::kColorDistanceEuclidean));
+		}
+	}
+
+	void test_map_pixels_dither() {
+		static const byte palette[] = { 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF };
+		Graphics::PaletteLookup lookup(palette, 2);
+
+		const Graphics::PixelFormat format(2, 5, 6, 5, 0, 11, 5, 0, 0);
+		const int w = 32, h = 32;
+		uint16 pixels[w * h];
+		byte result[w * h];
+		const uint16 gray = format.RGBToColor(0x40, 0x40, 0x40);
+		for (int i = 0; i < w * h; i++)
+			pixels[i] = gray;
+
+		lookup.mapPixels(result, w, pixels, w * 2, w, h, format);
+		for (int i = 0; i < w * h; i++)
+			TS_ASSERT_EQUALS(result[i], 0);
+
+		// A quarter of the pixels should end up white
+		lookup.mapPixels(result, w, pixels, w * 2, w, h, format, Graphics::kColorDistanceRedmean, true);
+		int white = 0;
+		for (int i = 0; i < w * h; i++)
+			white += result[i];
+		TS_ASSERT_LESS_THAN(w * h / 4 - 16, white);
+		TS_ASSERT_LESS_THAN(white, w * h / 4 + 16);
+	}
+};
@@ -0,0 +1,146 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/scalerplugin.h"
+#ifdef USE_SCALERS
+#include "graphics/scaler/dotmatrix.h"
+#include "graphics/scaler/pm.h"
+#include "graphics/scaler/sai.h"
+#include "graphics/scaler/scalebit.h"
+#include "graphics/scaler/tv.h"
+#ifdef USE_HQ_SCALERS
+#include "graphics/scaler/hq.h"
+#endif
+#endif
+
+namespace {
+
+// Runs the bands backwards to catch scalers depending on their order
+class ReversePool : public ScalerWorkerPool {
+public:
+	ReversePool() : _jobs(0) {}
+
+	uint getConcurrency() const override { return 4; }
+
+	void run(JobFunc job, void *data, uint count) override {
+		while (count--) {
+			job(data, count);
+			_jobs++;
+		}
+	}
+
+	uint _jobs;
+};
+
+// Looks at the old source of the row above, which belongs to the previous
+// band at the band edges
+class OldRowScaler : public SourceScaler {
+public:
+	OldRowScaler(const Graphics::PixelFormat &format) : SourceScaler(format) { _factor = 2; }
+
+	uint increaseFactor() override { return _factor; }
+	uint decreaseFactor() override { return _factor; }
+
+protected:
+	void internScale(const uint8 *srcPtr, uint32 srcPitch,
+	                 uint8 *dstPtr, uint32 dstPitch,
+	                 const uint8 *oldSrcPtr, uint32 oldSrcPitch,
+	                 int width, int height, const uint8 *buffer, uint32 bufferPitch) override {
+		for (int y = 0; y < height; ++y) {
+			const uint16 *src = (const uint16 *)(srcPtr + y * srcPitch);
+			const uint16 *above = oldSrcPtr ? (const uint16 *)(oldSrcPtr + (y - 1) * (int)oldSrcPitch) : src;
+			uint16 *dst = (uint16 *)(dstPtr + y * 2 * dstPitch);
+			for (int x = 0; x < width; ++x)
+				dst[x * 2] = dst[x * 2 + 1] = src[x] ^ above[x];
+			memcpy(dstPtr + (y * 2 + 1) * dstPitch, dst, width * 4);
+		}
+	}
+};
+
+} // End of anonymous namespace
+
+class ScalerBandsTestSuite : public CxxTest::TestSuite {
+	enum {
+		kWidth = 256,
+		kHeight = 64,
+		kBorder = 4
+	};
+
+	static void fillSurface(Graphics::Surface &surface, uint32 seed) {
+		byte *pixels = (byte *)surface.getPixels();
+		for (int i = 0; i < surface.pitch * surface.h; ++i) {
+			seed = seed * 1103515245 + 12345;
+			// Few different values so the scalers find some edges
+			pixels[i] = (seed >> 16) & 0xC3;
+		}
+	}
+
+	// Scale with and without the pool, twice to update the old source
+	static void compareScaler(Scaler *scaler, const Graphics::PixelFormat &format, bool useSource = false) {
+		const uint factor = scaler->getFactor();
+		Graphics::Surface src, expected, actual;
+		src.create(kWidth + kBorder * 2, kHeight + kBorder * 2, format);
+		expected.create(kWidth * factor, kHeight * factor, format);
+		actual.create(kWidth * factor, kHeight * factor, format);
+
+		ReversePool pool;
+		for (int pass = 0; pass < 2; ++pass) {
+			Graphics::Surface *dst = pass ? &actual : &expected;
+			Scaler::setWorkerPool(pass ? &pool : nullptr);
+			if (useSource) {
+				scaler->setSource((const byte *)src.getBasePtr(kBorder, kBorder), src.pitch, kWidth, kHeight, kBorder);
+				scaler->enableSource(true);
+			}
+
+			for (int frame = 0; frame < 2; ++frame) {
+				fillSurface(src, frame + 1);
+				scaler->scale((const uint8 *)src.getBasePtr(kBorder, kBorder), src.pitch,
+				              (uint8 *)dst->getPixels(), dst->pitch, kWidth, kHeight, 0, 0);
+			}
+		}
+		Scaler::setWorkerPool(nullptr);
+
+		TS_ASSERT_EQUALS(pool._jobs, 8u);
+		TS_ASSERT_EQUALS(memcmp(expected.getPixels(), actual.getPixels(), expected.pitch * expected.h), 0);
+
+		src.free();
+		expected.free();
+		actual.free();
+		delete scaler;
+	}
+
+public:
+	void test_source_scaler_bands() {
+		compareScaler(new OldRowScaler(Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0)), Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0), true);
+	}
+
+	void test_scaler_bands() {
+#ifdef USE_SCALERS
+		static const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0)
+		};
+
+		for (int f = 0; f < ARRAYSIZE(formats); ++f) {
+			const Graphics::PixelFormat &format = formats[f];
+			for (uint factor = 2; factor <= 4; ++factor) {
+				Scaler *scaler = new AdvMameScaler(format);
+				scaler->setFactor(factor);
+				compareScaler(scaler, format);
+			}
+#ifdef USE_HQ_SCALERS
+			for (uint factor = 2; factor <= 3; ++factor) {
+				Scaler *scaler = new HQScaler(format);
+				scaler->setFactor(factor);
+				compareScaler(scaler, format);
+			}
+#endif
+			compareScaler(new SAIScaler(format), format);
+			compareScaler(new SuperSAIScaler(format), format);
+			compareScaler(new SuperEagleScaler(format), format);
+			compareScaler(new PMScaler(format), format);
+			compareScaler(new DotMatrixScaler(format), format);
+			compareScaler(new TVScaler(format), format);
+		}
+#endif
+	}
+};
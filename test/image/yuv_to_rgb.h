@@ -0,0 +1,115 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_intern.h"
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kWidth = 70,    // Leaves a remainder after the vectorized loops
+		kHeight = 16,
+		kPitch = 80
+	};
+
+	static void fillPlane(byte *plane, int size, uint32 seed) {
+		for (int i = 0; i < size; ++i) {
+			seed = seed * 1103515245 + 12345;
+			plane[i] = seed >> 16;
+		}
+	}
+
+	// Goes through all the values in every row
+	static void fillRamp(byte *plane, int size, int step) {
+		for (int i = 0; i < size; ++i)
+			plane[i] = i * step;
+	}
+
+	static void convert(const Graphics::YUVToRGBSIMD::Kernels *kernels, Graphics::Surface &dst, int mode, Graphics::YUVToRGBManager::LuminanceScale scale,
+	                    const byte *y, const byte *u, const byte *v, const byte *a) {
+		Graphics::YUVToRGBSIMD::set(kernels);
+		memset(dst.getPixels(), 0x55, dst.pitch * dst.h);
+
+		switch (mode) {
+		case 0:
+			YUVToRGBMan.convert444(&dst, scale, y, u, v, kWidth, kHeight, kPitch, kPitch);
+			break;
+		case 1:
+			YUVToRGBMan.convert422(&dst, scale, y, u, v, kWidth, kHeight, kPitch, kPitch);
+			break;
+		case 2:
+			YUVToRGBMan.convert420(&dst, scale, y, u, v, kWidth, kHeight, kPitch, kPitch);
+			break;
+		default:
+			YUVToRGBMan.convert420Alpha(&dst, scale, y, u, v, a, kWidth, kHeight, kPitch, kPitch);
+			break;
+		}
+	}
+
+	static void compareKernels(const Graphics::YUVToRGBSIMD::Kernels *kernels) {
+		byte y[kPitch * kHeight], u[kPitch * kHeight], v[kPitch * kHeight], a[kPitch * kHeight];
+		fillPlane(y, sizeof(y), 1);
+		fillPlane(a, sizeof(a), 4);
+
+		for (int data = 0; data < 4; ++data) {
+			if (data & 1) {
+				fillPlane(u, sizeof(u), data * 2);
+				fillPlane(v, sizeof(v), data * 2 + 1);
+			} else {
+				fillRamp(u, sizeof(u), data + 3);
+				fillRamp(v, sizeof(v), data + 5);
+			}
+
+			compareImages(kernels, y, u, v, a);
+		}
+
+		Graphics::YUVToRGBSIMD::set(nullptr);
+	}
+
+	static void compareImages(const Graphics::YUVToRGBSIMD::Kernels *kernels, const byte *y, const byte *u, const byte *v, const byte *a) {
+		static const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 0, 10, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15),
+			Graphics::PixelFormat(2, 4, 4, 4, 4, 12, 8, 4, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 0, 8, 16, 0)
+		};
+
+		for (int f = 0; f < ARRAYSIZE(formats); ++f) {
+			Graphics::Surface expected, actual;
+			expected.create(kWidth + 3, kHeight, formats[f]);
+			actual.create(kWidth + 3, kHeight, formats[f]);
+
+			for (int mode = 0; mode < 4; ++mode) {
+				for (int s = 0; s < 2; ++s) {
+					const Graphics::YUVToRGBManager::LuminanceScale scale = s ? Graphics::YUVToRGBManager::kScaleITU : Graphics::YUVToRGBManager::kScaleFull;
+
+					convert(nullptr, expected, mode, scale, y, u, v, a);
+					convert(kernels, actual, mode, scale, y, u, v, a);
+					TSM_ASSERT_EQUALS(kernels->name, memcmp(expected.getPixels(), actual.getPixels(), expected.pitch * expected.h), 0);
+				}
+			}
+
+			expected.free();
+			actual.free();
+		}
+	}
+
+public:
+	void test_simd_kernels_match_lookup() {
+#ifdef SCUMMVM_NEON
+		compareKernels(&Graphics::YUVToRGBSIMD::kernelsNEON);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			compareKernels(&Graphics::YUVToRGBSIMD::kernelsSSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			compareKernels(&Graphics::YUVToRGBSIMD::kernelsAVX2);
+#endif
+	}
+};
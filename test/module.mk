@@ -10,14 +10,17 @@ TESTS        := $(srcdir)/test/common/*.h \
 	$(srcdir)/test/common/formats/*.h \
 	$(srcdir)/test/audio/*.h \
 	$(srcdir)/test/math/*.h \
-	$(srcdir)/test/image/*.h
+	$(srcdir)/test/image/*.h \
+	$(srcdir)/test/video/*.h
 TEST_LIBS    :=
 
 ifdef POSIX
+TESTS += $(srcdir)/test/backends/*.h
 TEST_LIBS += test/system/null_osystem.o \
 	backends/fs/posix/posix-fs-factory.o \
 	backends/fs/posix/posix-fs.o \
 	backends/fs/posix/posix-iostream.o \
+	backends/fs/posix/posix-mappedstream.o \
 	backends/fs/abstract-fs.o \
 	backends/fs/stdiostream.o \
 	backends/modular-backend.o
@@ -38,7 +41,9 @@ TESTS += $(srcdir)/test/graphics/tinygl*.h
 endif
 
 # libcommon needs libformats and libformats needs libcommon: so libcommon is put twice
-TEST_LIBS +=	audio/libaudio.a math/libmath.a common/libcommon.a common/formats/libformats.a common/compression/libcompression.a common/libcommon.a image/libimage.a graphics/libgraphics.a
+# The video decoders pull in parts of libimage and libgraphics which need them too
+TEST_LIBS +=	video/libvideo.a audio/libaudio.a math/libmath.a common/libcommon.a common/formats/libformats.a common/compression/libcompression.a common/libcommon.a image/libimage.a graphics/libgraphics.a \
+	common/formats/libformats.a common/libcommon.a
 
 ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/wintermute/*.h
@@ -61,6 +66,10 @@ endif
 TEST_FLAGS   := --runner=StdioPrinter --no-std --no-eh
 TEST_CFLAGS  := $(CFLAGS) -I$(srcdir)/test/cxxtest
 TEST_LDFLAGS := $(LDFLAGS) $(LIBS)
+ifdef POSIX
+# Some tests run the mixer callback on a second thread
+TEST_LDFLAGS += -lpthread
+endif
 TEST_CXXFLAGS  := $(filter-out -Wglobal-constructors,$(CXXFLAGS))
 TEST_CXXFLAGS += -Wno-self-assign-overloaded
 
@@ -91,9 +100,24 @@ test/runner.cpp: $(TESTS) $(srcdir)/test/module.mk
 	@mkdir -p test
 	$(srcdir)/test/cxxtest/bin/cxxtestgen $(TEST_FLAGS) -o $@ $+
 
+#
+# Benchmarks, built on the same libraries as the unit tests.
+# Use the 'benchmark' target to build them.
+#
+BENCHMARKS := test/audiobench$(EXEEXT) test/hashmapbench$(EXEEXT) test/videobench$(EXEEXT)
+
+benchmark: $(BENCHMARKS)
+test/audiobench$(EXEEXT): $(srcdir)/test/benchmark/audiobench.cpp $(TEST_LIBS)
+	+$(QUIET_CXX)$(LD) $(TEST_CXXFLAGS) $(CPPFLAGS) $(TEST_CFLAGS) -o $@ $< $(TEST_LIBS) $(TEST_LDFLAGS)
+test/hashmapbench$(EXEEXT): $(srcdir)/test/benchmark/hashmapbench.cpp $(TEST_LIBS)
+	+$(QUIET_CXX)$(LD) $(TEST_CXXFLAGS) $(CPPFLAGS) $(TEST_CFLAGS) -o $@ $< $(TEST_LIBS) $(TEST_LDFLAGS)
+test/videobench$(EXEEXT): $(srcdir)/test/benchmark/videobench.cpp $(TEST_LIBS)
+	+$(QUIET_CXX)$(LD) $(TEST_CXXFLAGS) $(CPPFLAGS) $(TEST_CFLAGS) -o $@ $< $(TEST_LIBS) $(TEST_LDFLAGS)
+
 clean: clean-test
 clean-test:
-	-$(RM) test/runner.cpp test/runner test/engine-data/encoding.dat test/system/null_osystem.o
+	-$(RM) test/runner.cpp test/runner test/engine-data/encoding.dat test/system/null_osystem.o $(BENCHMARKS)
+	-$(RM) test/posix-mappedstream.bin test/posix-mappedstream-small.bin
 	-rmdir test/engine-data
 
 test/engine-data/encoding.dat: $(srcdir)/dists/engine-data/encoding.dat
@@ -102,4 +126,4 @@ test/engine-data/encoding.dat: $(srcdir)/dists/engine-data/encoding.dat
 
 copy-dat: test/engine-data/encoding.dat
 
-.PHONY: test clean-test copy-dat
+.PHONY: test benchmark clean-test copy-dat
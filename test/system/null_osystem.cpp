@@ -9,8 +9,33 @@
 #endif
 #include "../backends/saves/savefile.cpp"
 
+#ifdef POSIX
+#include "../backends/mutex/pthread/pthread-mutex.cpp"
+#endif
+
+#include "audio/mixer_intern.h"
+
 //#define DISPLAY_ERROR_MESSAGES
 
+#ifdef POSIX
+/**
+ * Null system with working mutexes, so that tests can run the mixer
+ * callback on a second thread.
+ */
+class OSystem_NULLTest : public OSystem_NULL {
+public:
+	OSystem_NULLTest(bool silenceLogs) : OSystem_NULL(silenceLogs) {}
+
+	Common::MutexInternal *createMutex() override {
+		return createPthreadMutexInternal();
+	}
+};
+#else
+typedef OSystem_NULL OSystem_NULLTest;
+#endif
+
+static OSystem_NULL *s_nullSystem = nullptr;
+
 void Common::install_null_g_system() {
 #ifdef DISPLAY_ERROR_MESSAGES
 	const bool silenceLogs = false;
@@ -18,13 +43,42 @@ void Common::install_null_g_system() {
 	const bool silenceLogs = true;
 #endif
 
-	g_system = OSystem_NULL_create(silenceLogs);
+	g_system = s_nullSystem = new OSystem_NULLTest(silenceLogs);
 	g_system->initBackend();
 }
 
 void Common::uninstall_null_g_system() {
 	g_system->destroy();
-	g_system = nullptr;
+	g_system = s_nullSystem = nullptr;
+}
+
+/**
+ * Mixer manager which leaves the calls of mixCallback() to the test, so
+ * that audio is produced deterministically and as fast as possible.
+ */
+class TestMixerManager : public MixerManager {
+public:
+	TestMixerManager(uint outputRate) : _outputRate(outputRate) {}
+
+	void init() override {
+		_mixer = new Audio::MixerImpl(_outputRate, true, 2048);
+		_mixer->setReady(true);
+	}
+
+	void suspendAudio() override { _audioSuspended = true; }
+	int resumeAudio() override { _audioSuspended = false; return 0; }
+	bool isNullDevice() const override { return true; }
+
+	Audio::MixerImpl *getMixerImpl() { return _mixer; }
+
+private:
+	uint _outputRate;
+};
+
+Audio::MixerImpl *Common::install_null_mixer(unsigned int outputRate) {
+	TestMixerManager *mixerManager = new TestMixerManager(outputRate);
+	s_nullSystem->setMixerManager(mixerManager);
+	return mixerManager->getMixerImpl();
 }
 
 void OSystem_NULL::quit() {
@@ -1,9 +1,15 @@
 #ifndef TEST_NULL_OSYSTEM
 #define TEST_NULL_OSYSTEM 1
+namespace Audio {
+class MixerImpl;
+}
 namespace Common {
 #if defined(POSIX) || defined(WIN32)
 void install_null_g_system();
 void uninstall_null_g_system();
+// Gives the null g_system a mixer, which only mixes when the caller invokes
+// its mixCallback(). Must be called after install_null_g_system().
+Audio::MixerImpl *install_null_mixer(unsigned int outputRate);
 #define NULL_OSYSTEM_IS_AVAILABLE 1
 #else
 #define NULL_OSYSTEM_IS_AVAILABLE 0
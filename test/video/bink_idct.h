@@ -0,0 +1,86 @@
+#include <cxxtest/TestSuite.h>
+#include "test/instrset_detect.h"
+
+#include "video/bink_idct_intern.h"
+
+class BinkIDCTTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kPitch = 24
+	};
+
+	static uint32 nextRandom(uint32 &seed) {
+		seed = seed * 1103515245 + 12345;
+		return seed >> 8;
+	}
+
+	// Mostly sparse coefficients like the decoder reads, to also go through the shortcut for empty columns
+	static void fillBlock(int32 *block, uint32 &seed, int density, int range) {
+		for (int i = 0; i < 64; i++) {
+			if (i == 0 || (int)(nextRandom(seed) % 64) < density)
+				block[i] = (int32)(nextRandom(seed) % (2 * range + 1)) - range;
+			else
+				block[i] = 0;
+		}
+	}
+
+	static void compareKernels(const Video::BinkIDCTSIMD::Kernels *kernels) {
+		static const int densities[] = { 0, 2, 8, 64 };
+		static const int ranges[] = { 16, 2048, 65535 };
+
+		uint32 seed = 1;
+		for (int d = 0; d < ARRAYSIZE(densities); d++) {
+			for (int r = 0; r < ARRAYSIZE(ranges); r++) {
+				for (int n = 0; n < 32; n++) {
+					int32 coeffs[64];
+					fillBlock(coeffs, seed, densities[d], ranges[r]);
+					compareBlock(kernels, coeffs, seed);
+				}
+			}
+		}
+	}
+
+	static void compareBlock(const Video::BinkIDCTSIMD::Kernels *kernels, const int32 *coeffs, uint32 &seed) {
+		int32 expected[64], actual[64];
+		memcpy(expected, coeffs, sizeof(expected));
+		memcpy(actual, coeffs, sizeof(actual));
+		Video::BinkIDCTSIMD::idctGeneric(expected);
+		kernels->idct(actual);
+		TSM_ASSERT_SAME_DATA(kernels->name, expected, actual, sizeof(expected));
+
+		// The pixels around the block must stay untouched
+		byte expectedPixels[kPitch * 10], actualPixels[kPitch * 10];
+		for (int i = 0; i < ARRAYSIZE(expectedPixels); i++)
+			expectedPixels[i] = actualPixels[i] = nextRandom(seed);
+
+		memcpy(expected, coeffs, sizeof(expected));
+		memcpy(actual, coeffs, sizeof(actual));
+		Video::BinkIDCTSIMD::idctAddGeneric(expectedPixels + kPitch + 3, kPitch, expected);
+		kernels->idctAdd(actualPixels + kPitch + 3, kPitch, actual);
+		TSM_ASSERT_SAME_DATA(kernels->name, expectedPixels, actualPixels, sizeof(expectedPixels));
+
+		memcpy(expected, coeffs, sizeof(expected));
+		memcpy(actual, coeffs, sizeof(actual));
+		Video::BinkIDCTSIMD::idctPutGeneric(expectedPixels + kPitch + 3, kPitch, expected);
+		kernels->idctPut(actualPixels + kPitch + 3, kPitch, actual);
+		TSM_ASSERT_SAME_DATA(kernels->name, expectedPixels, actualPixels, sizeof(expectedPixels));
+	}
+
+public:
+	void test_simd_kernels_match_generic() {
+#ifdef USE_BINK
+#ifdef SCUMMVM_NEON
+		compareKernels(&Video::BinkIDCTSIMD::kernelsNEON);
+#endif
+#ifdef SCUMMVM_SSE2
+		if (instrset_detect() >= 2)
+			compareKernels(&Video::BinkIDCTSIMD::kernelsSSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (instrset_detect() >= 8)
+			compareKernels(&Video::BinkIDCTSIMD::kernelsAVX2);
+#endif
+#endif
+	}
+};
@@ -0,0 +1,179 @@
+#include <cxxtest/TestSuite.h>
+
+#include "video/video_decoder.h"
+#include "graphics/surface.h"
+
+#include "../system/null_osystem.h"
+
+namespace {
+
+class CountingVideoDecoder : public Video::VideoDecoder {
+public:
+	~CountingVideoDecoder() {
+		close();
+	}
+
+	bool loadStream(Common::SeekableReadStream *stream) override {
+		close();
+		addTrack(new CountingVideoTrack());
+		return true;
+	}
+
+private:
+	// Fills each frame with its number, and changes the palette every third frame
+	class CountingVideoTrack : public FixedRateVideoTrack {
+	public:
+		CountingVideoTrack() : _curFrame(-1), _dirtyPalette(true) {
+			_surface.create(4, 2, Graphics::PixelFormat::createFormatCLUT8());
+			memset(_palette, 0, sizeof(_palette));
+		}
+
+		~CountingVideoTrack() {
+			_surface.free();
+		}
+
+		bool isSeekable() const override { return true; }
+		bool seek(const Audio::Timestamp &time) override {
+			_curFrame = getFrameAtTime(time) - 1;
+			_palette[0] = MAX(_curFrame, 0) / 3;
+			_dirtyPalette = true;
+			return true;
+		}
+
+		uint16 getWidth() const override { return _surface.w; }
+		uint16 getHeight() const override { return _surface.h; }
+		Graphics::PixelFormat getPixelFormat() const override { return _surface.format; }
+		int getCurFrame() const override { return _curFrame; }
+		int getFrameCount() const override { return 10; }
+
+		const Graphics::Surface *decodeNextFrame() override {
+			_curFrame++;
+			memset(_surface.getPixels(), _curFrame, _surface.pitch * _surface.h);
+			if (_curFrame % 3 == 0) {
+				_palette[0] = _curFrame / 3;
+				_dirtyPalette = true;
+			}
+			return &_surface;
+		}
+
+		const byte *getPalette() const override { _dirtyPalette = false; return _palette; }
+		bool hasDirtyPalette() const override { return _dirtyPalette; }
+
+	protected:
+		Common::Rational getFrameRate() const override { return 10; }
+
+	private:
+		int _curFrame;
+		Graphics::Surface _surface;
+		byte _palette[256 * 3];
+		mutable bool _dirtyPalette;
+	};
+};
+
+// Does its own per-frame work, like the AVI and QuickTime decoders
+class NoAheadVideoDecoder : public CountingVideoDecoder {
+protected:
+	bool supportsDecodeAhead() const override { return false; }
+};
+
+} // End of anonymous namespace
+
+class VideoDecoderTestSuite : public CxxTest::TestSuite {
+	static int decodeFrame(Video::VideoDecoder &decoder) {
+		const Graphics::Surface *frame = decoder.decodeNextFrame();
+		return frame ? *(const byte *)frame->getPixels() : -1;
+	}
+
+	static int getPalette(Video::VideoDecoder &decoder) {
+		return decoder.hasDirtyPalette() ? decoder.getPalette()[0] : -1;
+	}
+
+public:
+	void setUp() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::install_null_g_system();
+#endif
+	}
+
+	void tearDown() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		Common::uninstall_null_g_system();
+#endif
+	}
+
+	void test_decode_ahead_matches_decoding() {
+		CountingVideoDecoder expected, actual;
+		expected.loadStream(nullptr);
+		actual.loadStream(nullptr);
+		TS_ASSERT(actual.setDecodeAhead(3));
+
+		while (!expected.endOfVideo()) {
+			// Keep the buffer full, except for an occasional miss
+			if (expected.getCurFrame() % 4 != 1) {
+				while (actual.decodeAhead())
+					;
+			}
+
+			TS_ASSERT(!actual.endOfVideo());
+			TS_ASSERT_EQUALS(actual.getCurFrame(), expected.getCurFrame());
+			TS_ASSERT_EQUALS(actual.getTimeToNextFrame(), expected.getTimeToNextFrame());
+			TS_ASSERT_EQUALS(decodeFrame(actual), decodeFrame(expected));
+			TS_ASSERT_EQUALS(getPalette(actual), getPalette(expected));
+		}
+
+		TS_ASSERT(actual.endOfVideo());
+		TS_ASSERT(!actual.decodeAhead());
+	}
+
+	void test_decode_ahead_limit() {
+		CountingVideoDecoder decoder;
+		decoder.loadStream(nullptr);
+		TS_ASSERT(!decoder.decodeAhead());
+
+		TS_ASSERT(decoder.setDecodeAhead(2));
+		TS_ASSERT(decoder.decodeAhead());
+		TS_ASSERT(decoder.decodeAhead());
+		TS_ASSERT(!decoder.decodeAhead());
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), -1);
+
+		// Disabling it still hands out the decoded frames
+		TS_ASSERT(decoder.setDecodeAhead(0));
+		TS_ASSERT(!decoder.decodeAhead());
+		TS_ASSERT_EQUALS(decodeFrame(decoder), 0);
+		TS_ASSERT_EQUALS(decodeFrame(decoder), 1);
+		TS_ASSERT_EQUALS(decodeFrame(decoder), 2);
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 2);
+
+		decoder.close();
+		TS_ASSERT(!decoder.setDecodeAhead(2));
+	}
+
+	void test_decode_ahead_unsupported() {
+		NoAheadVideoDecoder decoder;
+		decoder.loadStream(nullptr);
+		TS_ASSERT(!decoder.setDecodeAhead(2));
+		TS_ASSERT(!decoder.decodeAhead());
+		TS_ASSERT_EQUALS(decodeFrame(decoder), 0);
+	}
+
+	void test_decode_ahead_seek() {
+#if NULL_OSYSTEM_IS_AVAILABLE
+		CountingVideoDecoder decoder;
+		decoder.loadStream(nullptr);
+		TS_ASSERT(decoder.setDecodeAhead(4));
+
+		TS_ASSERT_EQUALS(decodeFrame(decoder), 0);
+		while (decoder.decodeAhead())
+			;
+
+		TS_ASSERT(decoder.seekToFrame(7));
+		TS_ASSERT_EQUALS(decoder.getCurFrame(), 6);
+		TS_ASSERT(decoder.decodeAhead());
+		TS_ASSERT_EQUALS(decodeFrame(decoder), 7);
+		TS_ASSERT_EQUALS(getPalette(decoder), 2);
+
+		TS_ASSERT(decoder.rewind());
+		TS_ASSERT_EQUALS(decodeFrame(decoder), 0);
+#endif
+	}
+};
@@ -103,6 +103,8 @@ protected:
 	void readNextPacket() override;
 	bool seekIntern(const Audio::Timestamp &time) override;
 	bool supportsAudioTrackSwitching() const override { return true; }
+	// decodeNextFrame() handles reverse playback and the transparency track
+	bool supportsDecodeAhead() const override { return false; }
 	AudioTrack *getAudioTrack(int index) override;
 
 	/**
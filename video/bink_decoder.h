@@ -35,6 +35,7 @@
 #include "common/rational.h"
 
 #include "video/video_decoder.h"
+#include "video/bink_idct_intern.h"
 
 #include "graphics/surface.h"
 
@@ -281,6 +282,8 @@ private:
 		byte *_curPlanes[4]; ///< The 4 color planes, YUVA, current frame.
 		byte *_oldPlanes[4]; ///< The 4 color planes, YUVA, last frame.
 
+		const BinkIDCTSIMD::Kernels *_idctKernels; ///< Vectorized IDCT, or nullptr for the generic one.
+
 		/** Initialize the bundles. */
 		void initBundles();
 		/** Deinitialize the bundles. */
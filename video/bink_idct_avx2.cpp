@@ -0,0 +1,174 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "video/bink_idct_intern.h"
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace Video {
+
+namespace {
+
+FORCEINLINE __m256i mulShift(__m256i a, int32 mul) {
+	return _mm256_srai_epi32(_mm256_mullo_epi32(a, _mm256_set1_epi32(mul)), 11);
+}
+
+// Transforms all columns or rows at once, v[i] holds their i-th values
+template<bool kRow>
+FORCEINLINE void transform(__m256i *v) {
+	const __m256i a0 = _mm256_add_epi32(v[0], v[4]);
+	const __m256i a1 = _mm256_sub_epi32(v[0], v[4]);
+	const __m256i a2 = _mm256_add_epi32(v[2], v[6]);
+	const __m256i a3 = mulShift(_mm256_sub_epi32(v[2], v[6]), BinkIDCTSIMD::kA1);
+	const __m256i a4 = _mm256_add_epi32(v[5], v[3]);
+	const __m256i a5 = _mm256_sub_epi32(v[5], v[3]);
+	const __m256i a6 = _mm256_add_epi32(v[1], v[7]);
+	const __m256i a7 = _mm256_sub_epi32(v[1], v[7]);
+	const __m256i b0 = _mm256_add_epi32(a4, a6);
+	const __m256i b1 = mulShift(_mm256_add_epi32(a5, a7), BinkIDCTSIMD::kA3);
+	const __m256i b2 = _mm256_add_epi32(_mm256_sub_epi32(mulShift(a5, BinkIDCTSIMD::kA4), b0), b1);
+	const __m256i b3 = _mm256_sub_epi32(mulShift(_mm256_sub_epi32(a6, a4), BinkIDCTSIMD::kA1), b2);
+	const __m256i b4 = _mm256_sub_epi32(_mm256_add_epi32(mulShift(a7, BinkIDCTSIMD::kA2), b3), b1);
+
+	const __m256i c0 = _mm256_add_epi32(a0, a2);
+	const __m256i c1 = _mm256_sub_epi32(_mm256_add_epi32(a1, a3), a2);
+	const __m256i c2 = _mm256_add_epi32(_mm256_sub_epi32(a1, a3), a2);
+	const __m256i c3 = _mm256_sub_epi32(a0, a2);
+
+	v[0] = _mm256_add_epi32(c0, b0);
+	v[1] = _mm256_add_epi32(c1, b2);
+	v[2] = _mm256_add_epi32(c2, b3);
+	v[3] = _mm256_sub_epi32(c3, b4);
+	v[4] = _mm256_add_epi32(c3, b4);
+	v[5] = _mm256_sub_epi32(c2, b3);
+	v[6] = _mm256_sub_epi32(c1, b2);
+	v[7] = _mm256_sub_epi32(c0, b0);
+
+	if (kRow) {
+		const __m256i round = _mm256_set1_epi32(0x7F);
+		for (int i = 0; i < 8; i++)
+			v[i] = _mm256_srai_epi32(_mm256_add_epi32(v[i], round), 8);
+	}
+}
+
+FORCEINLINE void transpose8x8(__m256i *v) {
+	__m256i t[8], u[8];
+	for (int i = 0; i < 8; i += 2) {
+		t[i] = _mm256_unpacklo_epi32(v[i], v[i + 1]);
+		t[i + 1] = _mm256_unpackhi_epi32(v[i], v[i + 1]);
+	}
+	for (int i = 0; i < 8; i += 4) {
+		u[i] = _mm256_unpacklo_epi64(t[i], t[i + 2]);
+		u[i + 1] = _mm256_unpackhi_epi64(t[i], t[i + 2]);
+		u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+		u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+	}
+	for (int i = 0; i < 4; i++) {
+		v[i] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+		v[i + 4] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+	}
+}
+
+// Transforms the block, on return v[i] holds the row i of the result
+FORCEINLINE void idct(const int32 *block, __m256i *v) {
+	for (int i = 0; i < 8; i++)
+		v[i] = _mm256_loadu_si256((const __m256i *)&block[8 * i]);
+
+	transform<false>(v);
+	transpose8x8(v);
+	transform<true>(v);
+	transpose8x8(v);
+}
+
+// The low bytes of four rows, eight bytes per row
+FORCEINLINE __m256i packRows(const __m256i *v) {
+	const __m256i mask = _mm256_set1_epi32(0xFF);
+	const __m256i rows01 = _mm256_packus_epi32(_mm256_and_si256(v[0], mask), _mm256_and_si256(v[1], mask));
+	const __m256i rows23 = _mm256_packus_epi32(_mm256_and_si256(v[2], mask), _mm256_and_si256(v[3], mask));
+	// The packs work on each 128-bit lane, so the halves of the rows are apart
+	return _mm256_permutevar8x32_epi32(_mm256_packus_epi16(rows01, rows23), _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+}
+
+FORCEINLINE __m256i loadRows(const byte *src, int pitch) {
+	const __m128i low = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)src), _mm_loadl_epi64((const __m128i *)(src + pitch)));
+	const __m128i high = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)(src + pitch * 2)), _mm_loadl_epi64((const __m128i *)(src + pitch * 3)));
+	return _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+}
+
+FORCEINLINE void storeRows(byte *dest, int pitch, __m256i rows) {
+	const __m128i low = _mm256_castsi256_si128(rows);
+	const __m128i high = _mm256_extracti128_si256(rows, 1);
+	_mm_storel_epi64((__m128i *)dest, low);
+	_mm_storel_epi64((__m128i *)(dest + pitch), _mm_unpackhi_epi64(low, low));
+	_mm_storel_epi64((__m128i *)(dest + pitch * 2), high);
+	_mm_storel_epi64((__m128i *)(dest + pitch * 3), _mm_unpackhi_epi64(high, high));
+}
+
+} // End of anonymous namespace
+
+static void idctAVX2(int32 *block) {
+	__m256i v[8];
+	idct(block, v);
+
+	for (int i = 0; i < 8; i++)
+		_mm256_storeu_si256((__m256i *)&block[8 * i], v[i]);
+}
+
+static void idctPutAVX2(byte *dest, int pitch, int32 *block) {
+	__m256i v[8];
+	idct(block, v);
+
+	storeRows(dest, pitch, packRows(v));
+	storeRows(dest + pitch * 4, pitch, packRows(v + 4));
+}
+
+static void idctAddAVX2(byte *dest, int pitch, int32 *block) {
+	__m256i v[8];
+	idct(block, v);
+
+	storeRows(dest, pitch, _mm256_add_epi8(loadRows(dest, pitch), packRows(v)));
+	dest += pitch * 4;
+	storeRows(dest, pitch, _mm256_add_epi8(loadRows(dest, pitch), packRows(v + 4)));
+}
+
+const BinkIDCTSIMD::Kernels BinkIDCTSIMD::kernelsAVX2 = {
+	"AVX2",
+	idctAVX2,
+	idctPutAVX2,
+	idctAddAVX2
+};
+
+} // End of namespace Video
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
@@ -0,0 +1,161 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef VIDEO_BINK_IDCT_INTERN_H
+#define VIDEO_BINK_IDCT_INTERN_H
+
+#include "common/scummsys.h"
+
+namespace Video {
+
+/**
+ * The Bink video IDCT. The generic versions are used when the host CPU has
+ * no vectorized kernels, which give bit-identical results.
+ */
+class BinkIDCTSIMD {
+public:
+	/** Transform the 8x8 @p block in place. */
+	typedef void (*IDCTFunc)(int32 *block);
+
+	/**
+	 * Transform @p block and store (Put) or add (Add) the low bytes of the
+	 * result to the 8x8 pixels at @p dest. @p block is clobbered.
+	 */
+	typedef void (*IDCTDestFunc)(byte *dest, int pitch, int32 *block);
+
+	struct Kernels {
+		const char *name;
+		IDCTFunc idct;
+		IDCTDestFunc idctPut;
+		IDCTDestFunc idctAdd;
+	};
+
+	/**
+	 * Return the kernels best suited for the host CPU, or nullptr if there
+	 * are none.
+	 */
+	static const Kernels *get();
+
+	/**
+	 * Override the kernels used by newly loaded videos. Passing nullptr
+	 * makes them use the generic IDCT.
+	 */
+	static void set(const Kernels *kernels);
+
+#ifdef SCUMMVM_NEON
+	static const Kernels kernelsNEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	static const Kernels kernelsSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+	static const Kernels kernelsAVX2;
+#endif
+
+	enum {
+		kA1 =  2896,    ///< (1/sqrt(2))<<12
+		kA2 =  2217,
+		kA3 =  3784,
+		kA4 = -5352
+	};
+
+	/**
+	 * One dimensional transform of the values at src[0], src[kStride], ...
+	 * Rows are rounded down to pixel values, columns are kept as is.
+	 */
+	template<int kStride, bool kRow, typename T>
+	static inline void transform(T *dest, const int32 *src) {
+		const int a0 = src[0 * kStride] + src[4 * kStride];
+		const int a1 = src[0 * kStride] - src[4 * kStride];
+		const int a2 = src[2 * kStride] + src[6 * kStride];
+		const int a3 = (kA1 * (src[2 * kStride] - src[6 * kStride])) >> 11;
+		const int a4 = src[5 * kStride] + src[3 * kStride];
+		const int a5 = src[5 * kStride] - src[3 * kStride];
+		const int a6 = src[1 * kStride] + src[7 * kStride];
+		const int a7 = src[1 * kStride] - src[7 * kStride];
+		const int b0 = a4 + a6;
+		const int b1 = (kA3 * (a5 + a7)) >> 11;
+		const int b2 = ((kA4 * a5) >> 11) - b0 + b1;
+		const int b3 = (kA1 * (a6 - a4) >> 11) - b2;
+		const int b4 = ((kA2 * a7) >> 11) + b3 - b1;
+		dest[0 * kStride] = munge<kRow>(a0 + a2      + b0);
+		dest[1 * kStride] = munge<kRow>(a1 + a3 - a2 + b2);
+		dest[2 * kStride] = munge<kRow>(a1 - a3 + a2 + b3);
+		dest[3 * kStride] = munge<kRow>(a0 - a2      - b4);
+		dest[4 * kStride] = munge<kRow>(a0 - a2      + b4);
+		dest[5 * kStride] = munge<kRow>(a1 - a3 + a2 - b3);
+		dest[6 * kStride] = munge<kRow>(a1 + a3 - a2 - b2);
+		dest[7 * kStride] = munge<kRow>(a0 + a2      - b0);
+	}
+
+	static inline void transformColumn(int32 *dest, const int32 *src) {
+		if ((src[8] | src[16] | src[24] | src[32] | src[40] | src[48] | src[56]) == 0) {
+			dest[ 0] =
+			dest[ 8] =
+			dest[16] =
+			dest[24] =
+			dest[32] =
+			dest[40] =
+			dest[48] =
+			dest[56] = src[0];
+		} else {
+			transform<8, false>(dest, src);
+		}
+	}
+
+	static inline void idctGeneric(int32 *block) {
+		int32 temp[64];
+
+		for (int i = 0; i < 8; i++)
+			transformColumn(&temp[i], &block[i]);
+		for (int i = 0; i < 8; i++)
+			transform<1, true>(&block[8 * i], &temp[8 * i]);
+	}
+
+	static inline void idctPutGeneric(byte *dest, int pitch, int32 *block) {
+		int32 temp[64];
+
+		for (int i = 0; i < 8; i++)
+			transformColumn(&temp[i], &block[i]);
+		for (int i = 0; i < 8; i++)
+			transform<1, true>(&dest[i * pitch], &temp[8 * i]);
+	}
+
+	static inline void idctAddGeneric(byte *dest, int pitch, int32 *block) {
+		idctGeneric(block);
+		for (int i = 0; i < 8; i++, dest += pitch, block += 8)
+			for (int j = 0; j < 8; j++)
+				dest[j] += block[j];
+	}
+
+private:
+	template<bool kRow>
+	static inline int munge(int x) {
+		return kRow ? ((x + 0x7F) >> 8) : x;
+	}
+
+	static const Kernels *_kernels;
+	static bool _initialized;
+};
+
+} // End of namespace Video
+
+#endif
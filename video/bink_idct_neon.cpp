@@ -0,0 +1,175 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#ifdef SCUMMVM_NEON
+
+#include "video/bink_idct_intern.h"
+
+#include <arm_neon.h>
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("neon"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("fpu=neon")
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+namespace Video {
+
+// Transforms four columns or rows at once, v[i] holds their i-th values
+template<bool kRow>
+static FORCEINLINE void neon_transform(int32x4_t *v) {
+	const int32x4_t a0 = vaddq_s32(v[0], v[4]);
+	const int32x4_t a1 = vsubq_s32(v[0], v[4]);
+	const int32x4_t a2 = vaddq_s32(v[2], v[6]);
+	const int32x4_t a3 = vshrq_n_s32(vmulq_n_s32(vsubq_s32(v[2], v[6]), BinkIDCTSIMD::kA1), 11);
+	const int32x4_t a4 = vaddq_s32(v[5], v[3]);
+	const int32x4_t a5 = vsubq_s32(v[5], v[3]);
+	const int32x4_t a6 = vaddq_s32(v[1], v[7]);
+	const int32x4_t a7 = vsubq_s32(v[1], v[7]);
+	const int32x4_t b0 = vaddq_s32(a4, a6);
+	const int32x4_t b1 = vshrq_n_s32(vmulq_n_s32(vaddq_s32(a5, a7), BinkIDCTSIMD::kA3), 11);
+	const int32x4_t b2 = vaddq_s32(vsubq_s32(vshrq_n_s32(vmulq_n_s32(a5, BinkIDCTSIMD::kA4), 11), b0), b1);
+	const int32x4_t b3 = vsubq_s32(vshrq_n_s32(vmulq_n_s32(vsubq_s32(a6, a4), BinkIDCTSIMD::kA1), 11), b2);
+	const int32x4_t b4 = vsubq_s32(vaddq_s32(vshrq_n_s32(vmulq_n_s32(a7, BinkIDCTSIMD::kA2), 11), b3), b1);
+
+	const int32x4_t c0 = vaddq_s32(a0, a2);
+	const int32x4_t c1 = vsubq_s32(vaddq_s32(a1, a3), a2);
+	const int32x4_t c2 = vaddq_s32(vsubq_s32(a1, a3), a2);
+	const int32x4_t c3 = vsubq_s32(a0, a2);
+
+	v[0] = vaddq_s32(c0, b0);
+	v[1] = vaddq_s32(c1, b2);
+	v[2] = vaddq_s32(c2, b3);
+	v[3] = vsubq_s32(c3, b4);
+	v[4] = vaddq_s32(c3, b4);
+	v[5] = vsubq_s32(c2, b3);
+	v[6] = vsubq_s32(c1, b2);
+	v[7] = vsubq_s32(c0, b0);
+
+	if (kRow) {
+		const int32x4_t round = vdupq_n_s32(0x7F);
+		for (int i = 0; i < 8; i++)
+			v[i] = vshrq_n_s32(vaddq_s32(v[i], round), 8);
+	}
+}
+
+static FORCEINLINE void neon_transpose4x4(int32x4_t &r0, int32x4_t &r1, int32x4_t &r2, int32x4_t &r3) {
+	const int32x4x2_t t01 = vtrnq_s32(r0, r1);
+	const int32x4x2_t t23 = vtrnq_s32(r2, r3);
+	r0 = vcombine_s32(vget_low_s32(t01.val[0]), vget_low_s32(t23.val[0]));
+	r1 = vcombine_s32(vget_low_s32(t01.val[1]), vget_low_s32(t23.val[1]));
+	r2 = vcombine_s32(vget_high_s32(t01.val[0]), vget_high_s32(t23.val[0]));
+	r3 = vcombine_s32(vget_high_s32(t01.val[1]), vget_high_s32(t23.val[1]));
+}
+
+/**
+ * Transforms the block. On return, left[i] and right[i] hold the columns 0-3
+ * and 4-7 of the row i of the result.
+ */
+static FORCEINLINE void neon_idct(const int32 *block, int32x4_t *left, int32x4_t *right) {
+	for (int i = 0; i < 8; i++) {
+		left[i] = vld1q_s32(&block[8 * i]);
+		right[i] = vld1q_s32(&block[8 * i + 4]);
+	}
+
+	neon_transform<false>(left);
+	neon_transform<false>(right);
+
+	// Turn the columns into the rows 0-3 and 4-7
+	int32x4_t top[8], bottom[8];
+	for (int i = 0; i < 8; i += 4) {
+		int32x4_t *dst = i ? bottom : top;
+		dst[0] = left[i];  dst[1] = left[i + 1];  dst[2] = left[i + 2];  dst[3] = left[i + 3];
+		dst[4] = right[i]; dst[5] = right[i + 1]; dst[6] = right[i + 2]; dst[7] = right[i + 3];
+		neon_transpose4x4(dst[0], dst[1], dst[2], dst[3]);
+		neon_transpose4x4(dst[4], dst[5], dst[6], dst[7]);
+	}
+
+	neon_transform<true>(top);
+	neon_transform<true>(bottom);
+
+	for (int i = 0; i < 8; i += 4) {
+		const int32x4_t *src = i ? bottom : top;
+		left[i] = src[0];  left[i + 1] = src[1];  left[i + 2] = src[2];  left[i + 3] = src[3];
+		right[i] = src[4]; right[i + 1] = src[5]; right[i + 2] = src[6]; right[i + 3] = src[7];
+		neon_transpose4x4(left[i], left[i + 1], left[i + 2], left[i + 3]);
+		neon_transpose4x4(right[i], right[i + 1], right[i + 2], right[i + 3]);
+	}
+}
+
+// The low bytes of a row, the narrowing moves truncate
+static FORCEINLINE uint8x8_t neon_packRow(int32x4_t left, int32x4_t right) {
+	return vmovn_u16(vreinterpretq_u16_s16(vcombine_s16(vmovn_s32(left), vmovn_s32(right))));
+}
+
+static void idctNEON(int32 *block) {
+	int32x4_t left[8], right[8];
+	neon_idct(block, left, right);
+
+	for (int i = 0; i < 8; i++) {
+		vst1q_s32(&block[8 * i], left[i]);
+		vst1q_s32(&block[8 * i + 4], right[i]);
+	}
+}
+
+static void idctPutNEON(byte *dest, int pitch, int32 *block) {
+	int32x4_t left[8], right[8];
+	neon_idct(block, left, right);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		vst1_u8(dest, neon_packRow(left[i], right[i]));
+}
+
+static void idctAddNEON(byte *dest, int pitch, int32 *block) {
+	int32x4_t left[8], right[8];
+	neon_idct(block, left, right);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		vst1_u8(dest, vadd_u8(vld1_u8(dest), neon_packRow(left[i], right[i])));
+}
+
+const BinkIDCTSIMD::Kernels BinkIDCTSIMD::kernelsNEON = {
+	"NEON",
+	idctNEON,
+	idctPutNEON,
+	idctAddNEON
+};
+
+} // End of namespace Video
+
+#if !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__aarch64__) && !defined(__ARM_NEON)
+
+#endif // SCUMMVM_NEON
@@ -0,0 +1,197 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common/scummsys.h"
+
+#include "video/bink_idct_intern.h"
+
+#include <emmintrin.h>
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+#endif // !defined(__x86_64__)
+
+namespace Video {
+
+namespace {
+
+// SSE2 has no 32-bit multiplication keeping the low half of the products
+template<int32 kMul>
+FORCEINLINE __m128i mulConst(__m128i a) {
+	const __m128i mul = _mm_set1_epi32(kMul);
+	const __m128i even = _mm_mul_epu32(a, mul);
+	const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), mul);
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+// Transforms four columns or rows at once, v[i] holds their i-th values
+template<bool kRow>
+FORCEINLINE void transform(__m128i *v) {
+	const __m128i a0 = _mm_add_epi32(v[0], v[4]);
+	const __m128i a1 = _mm_sub_epi32(v[0], v[4]);
+	const __m128i a2 = _mm_add_epi32(v[2], v[6]);
+	const __m128i a3 = _mm_srai_epi32(mulConst<BinkIDCTSIMD::kA1>(_mm_sub_epi32(v[2], v[6])), 11);
+	const __m128i a4 = _mm_add_epi32(v[5], v[3]);
+	const __m128i a5 = _mm_sub_epi32(v[5], v[3]);
+	const __m128i a6 = _mm_add_epi32(v[1], v[7]);
+	const __m128i a7 = _mm_sub_epi32(v[1], v[7]);
+	const __m128i b0 = _mm_add_epi32(a4, a6);
+	const __m128i b1 = _mm_srai_epi32(mulConst<BinkIDCTSIMD::kA3>(_mm_add_epi32(a5, a7)), 11);
+	const __m128i b2 = _mm_add_epi32(_mm_sub_epi32(_mm_srai_epi32(mulConst<BinkIDCTSIMD::kA4>(a5), 11), b0), b1);
+	const __m128i b3 = _mm_sub_epi32(_mm_srai_epi32(mulConst<BinkIDCTSIMD::kA1>(_mm_sub_epi32(a6, a4)), 11), b2);
+	const __m128i b4 = _mm_sub_epi32(_mm_add_epi32(_mm_srai_epi32(mulConst<BinkIDCTSIMD::kA2>(a7), 11), b3), b1);
+
+	const __m128i c0 = _mm_add_epi32(a0, a2);
+	const __m128i c1 = _mm_sub_epi32(_mm_add_epi32(a1, a3), a2);
+	const __m128i c2 = _mm_add_epi32(_mm_sub_epi32(a1, a3), a2);
+	const __m128i c3 = _mm_sub_epi32(a0, a2);
+
+	v[0] = _mm_add_epi32(c0, b0);
+	v[1] = _mm_add_epi32(c1, b2);
+	v[2] = _mm_add_epi32(c2, b3);
+	v[3] = _mm_sub_epi32(c3, b4);
+	v[4] = _mm_add_epi32(c3, b4);
+	v[5] = _mm_sub_epi32(c2, b3);
+	v[6] = _mm_sub_epi32(c1, b2);
+	v[7] = _mm_sub_epi32(c0, b0);
+
+	if (kRow) {
+		const __m128i round = _mm_set1_epi32(0x7F);
+		for (int i = 0; i < 8; i++)
+			v[i] = _mm_srai_epi32(_mm_add_epi32(v[i], round), 8);
+	}
+}
+
+FORCEINLINE void transpose4x4(__m128i &r0, __m128i &r1, __m128i &r2, __m128i &r3) {
+	const __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+	const __m128i t1 = _mm_unpackhi_epi32(r0, r1);
+	const __m128i t2 = _mm_unpacklo_epi32(r2, r3);
+	const __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+	r0 = _mm_unpacklo_epi64(t0, t2);
+	r1 = _mm_unpackhi_epi64(t0, t2);
+	r2 = _mm_unpacklo_epi64(t1, t3);
+	r3 = _mm_unpackhi_epi64(t1, t3);
+}
+
+/**
+ * Transforms the block. On return, left[i] and right[i] hold the columns 0-3
+ * and 4-7 of the row i of the result.
+ */
+FORCEINLINE void idct(const int32 *block, __m128i *left, __m128i *right) {
+	// The columns 0-3 and 4-7 of each row
+	for (int i = 0; i < 8; i++) {
+		left[i] = _mm_loadu_si128((const __m128i *)&block[8 * i]);
+		right[i] = _mm_loadu_si128((const __m128i *)&block[8 * i + 4]);
+	}
+
+	transform<false>(left);
+	transform<false>(right);
+
+	// Turn the columns into the rows 0-3 and 4-7
+	__m128i top[8], bottom[8];
+	for (int i = 0; i < 8; i += 4) {
+		__m128i *dst = i ? bottom : top;
+		dst[0] = left[i];  dst[1] = left[i + 1];  dst[2] = left[i + 2];  dst[3] = left[i + 3];
+		dst[4] = right[i]; dst[5] = right[i + 1]; dst[6] = right[i + 2]; dst[7] = right[i + 3];
+		transpose4x4(dst[0], dst[1], dst[2], dst[3]);
+		transpose4x4(dst[4], dst[5], dst[6], dst[7]);
+	}
+
+	transform<true>(top);
+	transform<true>(bottom);
+
+	for (int i = 0; i < 8; i += 4) {
+		const __m128i *src = i ? bottom : top;
+		left[i] = src[0];  left[i + 1] = src[1];  left[i + 2] = src[2];  left[i + 3] = src[3];
+		right[i] = src[4]; right[i + 1] = src[5]; right[i + 2] = src[6]; right[i + 3] = src[7];
+		transpose4x4(left[i], left[i + 1], left[i + 2], left[i + 3]);
+		transpose4x4(right[i], right[i + 1], right[i + 2], right[i + 3]);
+	}
+}
+
+// The low bytes of two rows
+FORCEINLINE __m128i packRows(const __m128i *left, const __m128i *right, int i) {
+	const __m128i mask = _mm_set1_epi32(0xFF);
+	const __m128i row0 = _mm_packs_epi32(_mm_and_si128(left[i], mask), _mm_and_si128(right[i], mask));
+	const __m128i row1 = _mm_packs_epi32(_mm_and_si128(left[i + 1], mask), _mm_and_si128(right[i + 1], mask));
+	return _mm_packus_epi16(row0, row1);
+}
+
+} // End of anonymous namespace
+
+static void idctSSE2(int32 *block) {
+	__m128i left[8], right[8];
+	idct(block, left, right);
+
+	for (int i = 0; i < 8; i++) {
+		_mm_storeu_si128((__m128i *)&block[8 * i], left[i]);
+		_mm_storeu_si128((__m128i *)&block[8 * i + 4], right[i]);
+	}
+}
+
+static void idctPutSSE2(byte *dest, int pitch, int32 *block) {
+	__m128i left[8], right[8];
+	idct(block, left, right);
+
+	for (int i = 0; i < 8; i += 2, dest += pitch * 2) {
+		const __m128i rows = packRows(left, right, i);
+		_mm_storel_epi64((__m128i *)dest, rows);
+		_mm_storel_epi64((__m128i *)(dest + pitch), _mm_unpackhi_epi64(rows, rows));
+	}
+}
+
+static void idctAddSSE2(byte *dest, int pitch, int32 *block) {
+	__m128i left[8], right[8];
+	idct(block, left, right);
+
+	for (int i = 0; i < 8; i += 2, dest += pitch * 2) {
+		const __m128i pixels = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)dest), _mm_loadl_epi64((const __m128i *)(dest + pitch)));
+		const __m128i rows = _mm_add_epi8(pixels, packRows(left, right, i));
+		_mm_storel_epi64((__m128i *)dest, rows);
+		_mm_storel_epi64((__m128i *)(dest + pitch), _mm_unpackhi_epi64(rows, rows));
+	}
+}
+
+const BinkIDCTSIMD::Kernels BinkIDCTSIMD::kernelsSSE2 = {
+	"SSE2",
+	idctSSE2,
+	idctPutSSE2,
+	idctAddSSE2
+};
+
+} // End of namespace Video
+
+#if !defined(__x86_64__)
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // !defined(__x86_64__)
@@ -611,6 +611,10 @@ public:
 
 	void setSurfaceMemory(void *mem, uint16 width, uint16 height, uint8 bpp);
 
+protected:
+	// Frames may be decoded straight into the surface memory of the caller
+	bool supportsDecodeAhead() const override { return false; }
+
 private:
 	class VMDVideoTrack : public FixedRateVideoTrack {
 	public:
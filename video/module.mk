@@ -21,6 +21,19 @@ MODULE_OBJS := \
 ifdef USE_BINK
 MODULE_OBJS += \
 	bink_decoder.o
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	bink_idct_neon.o
+endif
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	bink_idct_sse2.o
+endif
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	bink_idct_avx2.o
+endif
 endif
 
 ifdef USE_HNM
@@ -159,6 +159,9 @@ public:
 	void goToNode(uint32 nodeID);
 
 protected:
+	// decodeNextFrame() updates the QTVR angles and the audio buffer
+	bool supportsDecodeAhead() const override { return false; }
+
 	Common::QuickTimeParser::SampleDesc *readSampleDesc(Common::QuickTimeParser::Track *track, uint32 format, uint32 descSize) override;
 	Common::QuickTimeParser::SampleDesc *readPanoSampleDesc(Common::QuickTimeParser::Track *track, uint32 format, uint32 descSize);
 
@@ -28,6 +28,8 @@
 #include "common/file.h"
 #include "common/system.h"
 
+#include "graphics/surface.h"
+
 namespace Video {
 
 VideoDecoder::VideoDecoder() {
@@ -48,6 +50,14 @@ VideoDecoder::VideoDecoder() {
 	_canSetDither = true;
 	_canSetDefaultFormat = true;
 	_videoCodecAccuracy = Image::CodecAccuracy::Default;
+	_aheadTrack = 0;
+	_aheadMax = 0;
+	_aheadFirst = 0;
+	_aheadCount = 0;
+}
+
+VideoDecoder::~VideoDecoder() {
+	freeDecodedAhead();
 }
 
 void VideoDecoder::close() {
@@ -74,6 +84,9 @@ void VideoDecoder::close() {
 	_mainAudioTrack = 0;
 	_canSetDither = true;
 	_canSetDefaultFormat = true;
+	freeDecodedAhead();
+	_aheadTrack = 0;
+	_aheadMax = 0;
 }
 
 bool VideoDecoder::loadFile(const Common::Path &filename) {
@@ -114,10 +127,92 @@ bool VideoDecoder::needsUpdate() const {
 }
 
 void VideoDecoder::delayMillis(uint msecs) {
-	if (!needsUpdate())
+	if (!needsUpdate()) {
+		// Use the spare time to get the next frames ready
+		decodeAhead();
 		g_system->delayMillis(MIN<uint>(msecs, getTimeToNextFrame()));
-	else
+	} else {
 		g_system->delayMillis(1); /* This is needed to keep the mixer and timers active */
+	}
+}
+
+bool VideoDecoder::setDecodeAhead(uint frames) {
+	if (!supportsDecodeAhead())
+		return false;
+
+	VideoTrack *videoTrack = 0;
+
+	for (auto &track : _tracks) {
+		if (track->getTrackType() == Track::kTrackTypeVideo) {
+			// We only allow this when one video track is present
+			if (videoTrack)
+				return false;
+
+			videoTrack = (VideoTrack *)track;
+		}
+	}
+
+	if (!videoTrack)
+		return false;
+
+	// Frames which are already decoded are still handed out
+	_aheadTrack = videoTrack;
+	_aheadMax = frames;
+	return true;
+}
+
+bool VideoDecoder::decodeAhead() {
+	if (!_aheadTrack || _aheadCount >= _aheadMax || _aheadTrack->isReversed() || _aheadTrack->endOfTrack())
+		return false;
+
+	// Only grow the ring buffer, the surface on screen must stay valid
+	if (_aheadCount == 0 && _aheadFrames.size() < _aheadMax + 1) {
+		uint oldSize = _aheadFrames.size();
+		_aheadFrames.resize(_aheadMax + 1);
+		for (uint i = oldSize; i < _aheadFrames.size(); i++)
+			_aheadFrames[i].surface = new Graphics::Surface();
+	}
+
+	if (_aheadCount + 1 >= _aheadFrames.size())
+		return false;
+
+	if (_aheadCount == 0) {
+		_aheadState.curFrame = _aheadTrack->getCurFrame();
+		_aheadState.curFrameDelay = _aheadTrack->getCurFrameDelay();
+		_aheadState.nextFrameStartTime = _aheadTrack->getNextFrameStartTime();
+		_aheadState.endOfTrack = _aheadTrack->endOfTrack();
+	}
+
+	_canSetDither = false;
+	_canSetDefaultFormat = false;
+
+	readNextPacket();
+
+	AheadFrame &frame = _aheadFrames[(_aheadFirst + _aheadCount) % _aheadFrames.size()];
+	const Graphics::Surface *surface = _aheadTrack->decodeNextFrame();
+
+	frame.hasSurface = (surface != 0);
+	if (surface) {
+		if (frame.surface->w != surface->w || frame.surface->h != surface->h || frame.surface->format != surface->format) {
+			frame.surface->free();
+			frame.surface->create(surface->w, surface->h, surface->format);
+		}
+
+		frame.surface->copyRectToSurface(*surface, 0, 0, Common::Rect(surface->w, surface->h));
+	}
+
+	// The track reuses its palette for the following frames
+	frame.dirtyPalette = _aheadTrack->hasDirtyPalette();
+	if (frame.dirtyPalette)
+		memcpy(frame.palette, _aheadTrack->getPalette(), sizeof(frame.palette));
+
+	frame.state.curFrame = _aheadTrack->getCurFrame();
+	frame.state.curFrameDelay = _aheadTrack->getCurFrameDelay();
+	frame.state.nextFrameStartTime = _aheadTrack->getNextFrameStartTime();
+	frame.state.endOfTrack = _aheadTrack->endOfTrack();
+
+	_aheadCount++;
+	return true;
 }
 
 void VideoDecoder::pauseVideo(bool pause) {
@@ -212,6 +307,9 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	_canSetDither = false;
 	_canSetDefaultFormat = false;
 
+	if (_aheadCount)
+		return popDecodedAhead();
+
 	readNextPacket();
 
 	// If we have no next video track at this point, there shouldn't be
@@ -237,6 +335,10 @@ bool VideoDecoder::setReverse(bool reverse) {
 	if (reverse && hasAudio())
 		return false;
 
+	// The frames decoded ahead are the ones following the current frame
+	if (reverse && !discardDecodedAhead())
+		return false;
+
 	// Attempt to make sure all the tracks are in the requested direction
 	for (auto &track : _tracks) {
 		if (track->getTrackType() == Track::kTrackTypeVideo && ((VideoTrack *)track)->isReversed() != reverse) {
@@ -261,7 +363,7 @@ int VideoDecoder::getCurFrame() const {
 
 	for (const auto &track : _tracks)
 		if (track->getTrackType() == Track::kTrackTypeVideo)
-			frame += ((VideoTrack *)track)->getCurFrame() + 1;
+			frame += getTrackCurFrame((VideoTrack *)track) + 1;
 
 	return frame;
 }
@@ -271,7 +373,7 @@ int VideoDecoder::getCurFrameDelay() const {
 
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo)
-			frame += ((VideoTrack *)*it)->getCurFrameDelay() + 1;
+			frame += (isDecodedAhead(*it) ? _aheadState.curFrameDelay : ((VideoTrack *)*it)->getCurFrameDelay()) + 1;
 
 	return frame;
 }
@@ -313,7 +415,7 @@ uint32 VideoDecoder::getTimeToNextFrame() const {
 		return 0;
 
 	uint32 currentTime = getTime();
-	uint32 nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
+	uint32 nextFrameStartTime = getTrackNextFrameStartTime(_nextVideoTrack);
 
 	if (_nextVideoTrack->isReversed()) {
 		// For reversed videos, we need to handle the time difference the opposite way.
@@ -332,8 +434,8 @@ uint32 VideoDecoder::getTimeToNextFrame() const {
 
 bool VideoDecoder::endOfVideo() const {
 	for (const auto &track : _tracks) {
-		bool videoEndTimeReached = _endTimeSet && track->getTrackType() == Track::kTrackTypeVideo && ((const VideoTrack *)track)->getNextFrameStartTime() >= (uint)_endTime.msecs();
-		bool endReached = track->endOfTrack() || (isPlaying() && videoEndTimeReached);
+		bool videoEndTimeReached = _endTimeSet && track->getTrackType() == Track::kTrackTypeVideo && getTrackNextFrameStartTime((const VideoTrack *)track) >= (uint)_endTime.msecs();
+		bool endReached = endOfTrackIntern(track) || (isPlaying() && videoEndTimeReached);
 		if (!endReached)
 			return false;
 	}
@@ -360,6 +462,8 @@ bool VideoDecoder::rewind() {
 	if (isPlaying())
 		stopAudio();
 
+	_aheadCount = 0;
+
 	for (auto &track : _tracks)
 		if (!track->rewind())
 			return false;
@@ -394,6 +498,8 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 	if (isPlaying())
 		stopAudio();
 
+	_aheadCount = 0;
+
 	// Do the actual seeking
 	if (!seekIntern(time))
 		return false;
@@ -959,7 +1065,7 @@ void VideoDecoder::setEndFrame(uint frame) {
 
 void VideoDecoder::resetStartTime() {
 	if (_nextVideoTrack) {
-		Audio::Timestamp curTime = _nextVideoTrack->getFrameTime(_nextVideoTrack->getCurFrame());
+		Audio::Timestamp curTime = _nextVideoTrack->getFrameTime(getTrackCurFrame(_nextVideoTrack));
 		if (isPlaying()) {
 			_startTime = g_system->getMillis() - (curTime.msecs() / _playbackRate).toInt();
 		}
@@ -982,7 +1088,7 @@ const VideoDecoder::Track *VideoDecoder::getTrack(uint track) const {
 
 bool VideoDecoder::endOfVideoTracks() const {
 	for (const auto &track : _tracks)
-		if (track->getTrackType() == Track::kTrackTypeVideo && !track->endOfTrack())
+		if (track->getTrackType() == Track::kTrackTypeVideo && !endOfTrackIntern(track))
 			return false;
 
 	return true;
@@ -993,9 +1099,9 @@ VideoDecoder::VideoTrack *VideoDecoder::findNextVideoTrack() {
 	uint32 bestTime = 0xFFFFFFFF;
 
 	for (auto &track : _tracks) {
-		if (track->getTrackType() == Track::kTrackTypeVideo && !track->endOfTrack()) {
+		if (track->getTrackType() == Track::kTrackTypeVideo && !endOfTrackIntern(track)) {
 			VideoTrack *videoTrack = (VideoTrack *)track;
-			uint32 time = videoTrack->getNextFrameStartTime();
+			uint32 time = getTrackNextFrameStartTime(videoTrack);
 
 			if (time < bestTime) {
 				bestTime = time;
@@ -1049,8 +1155,8 @@ bool VideoDecoder::hasFramesLeft() const {
 
 		const VideoTrack *videoTrack = (const VideoTrack *)track;
 
-		bool videoEndTimeReached = _endTimeSet && videoTrack->getNextFrameStartTime() >= (uint)_endTime.msecs();
-		bool endReached = videoTrack->endOfTrack() || (isPlaying() && videoEndTimeReached);
+		bool videoEndTimeReached = _endTimeSet && getTrackNextFrameStartTime(videoTrack) >= (uint)_endTime.msecs();
+		bool endReached = endOfTrackIntern(videoTrack) || (isPlaying() && videoEndTimeReached);
 		if (!endReached)
 			return true;
 	}
@@ -1058,6 +1164,63 @@ bool VideoDecoder::hasFramesLeft() const {
 	return false;
 }
 
+int VideoDecoder::getTrackCurFrame(const VideoTrack *track) const {
+	return isDecodedAhead(track) ? _aheadState.curFrame : track->getCurFrame();
+}
+
+uint32 VideoDecoder::getTrackNextFrameStartTime(const VideoTrack *track) const {
+	return isDecodedAhead(track) ? _aheadState.nextFrameStartTime : track->getNextFrameStartTime();
+}
+
+bool VideoDecoder::endOfTrackIntern(const Track *track) const {
+	return isDecodedAhead(track) ? _aheadState.endOfTrack : track->endOfTrack();
+}
+
+const Graphics::Surface *VideoDecoder::popDecodedAhead() {
+	const AheadFrame &frame = _aheadFrames[_aheadFirst];
+	_aheadFirst = (_aheadFirst + 1) % _aheadFrames.size();
+	_aheadCount--;
+	_aheadState = frame.state;
+
+	if (frame.dirtyPalette) {
+		memcpy(_aheadPalette, frame.palette, sizeof(_aheadPalette));
+		_palette = _aheadPalette;
+		_dirtyPalette = true;
+	}
+
+	findNextVideoTrack();
+
+	return frame.hasSurface ? frame.surface : 0;
+}
+
+bool VideoDecoder::discardDecodedAhead() {
+	if (!_aheadCount)
+		return true;
+
+	// Seek the tracks back to the frame following the one on screen
+	Audio::Timestamp time = _aheadTrack->getFrameTime(_aheadState.curFrame + 1);
+	if (time < 0 || !isSeekable())
+		return false;
+
+	_aheadCount = 0;
+	if (!seekIntern(time))
+		return false;
+
+	findNextVideoTrack();
+	return true;
+}
+
+void VideoDecoder::freeDecodedAhead() {
+	for (auto &frame : _aheadFrames) {
+		frame.surface->free();
+		delete frame.surface;
+	}
+
+	_aheadFrames.clear();
+	_aheadFirst = 0;
+	_aheadCount = 0;
+}
+
 bool VideoDecoder::hasAudio() const {
 	for (const auto &track : _tracks)
 		if (track->getTrackType() == Track::kTrackTypeAudio)
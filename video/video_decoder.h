@@ -53,7 +53,7 @@ namespace Video {
 class VideoDecoder {
 public:
 	VideoDecoder();
-	virtual ~VideoDecoder() {}
+	virtual ~VideoDecoder();
 
 	/////////////////////////////////////////
 	// Opening/Closing a Video
@@ -342,6 +342,33 @@ public:
 	 */
 	void delayMillis(uint msecs);
 
+	/**
+	 * Decode up to the specified amount of frames ahead of time.
+	 *
+	 * The frames are decoded while the engine waits for the next frame in
+	 * delayMillis(), or when it calls decodeAhead(). A frame which is slow
+	 * to decode is then usually ready before it is due. decodeNextFrame()
+	 * returns copies of the frames, so this needs memory for frames + 1
+	 * surfaces.
+	 *
+	 * This should be called after loadStream(), and only works for videos
+	 * with a single video track and formats which support it, see
+	 * supportsDecodeAhead(). close() disables it again.
+	 *
+	 * @param frames The number of frames to decode ahead, 0 to disable it
+	 * @return true on success, false otherwise
+	 */
+	bool setDecodeAhead(uint frames);
+
+	/**
+	 * Decode a frame ahead of time, if enabled with setDecodeAhead() and
+	 * there is room for it. Engines which wait for the next frame without
+	 * delayMillis() may call this when idle.
+	 *
+	 * @return true if a frame was decoded, false otherwise
+	 */
+	bool decodeAhead();
+
 	/**
 	 * Return the time (in ms) until the next frame should be displayed.
 	 */
@@ -997,6 +1024,16 @@ protected:
 	 */
 	virtual bool supportsAudioTrackSwitching() const { return false; }
 
+	/**
+	 * Can frames of this format be decoded ahead of time?
+	 *
+	 * decodeAhead() calls readNextPacket() and the video track's
+	 * decodeNextFrame() directly, so decoders which do per-frame work in
+	 * their own decodeNextFrame() must return false here.
+	 * @see setDecodeAhead()
+	 */
+	virtual bool supportsDecodeAhead() const { return true; }
+
 	/**
 	 * Get the audio track for the given index.
 	 *
@@ -1029,6 +1066,38 @@ private:
 	bool _canSetDither;
 	bool _canSetDefaultFormat;
 
+	// Frames decoded ahead of time, see setDecodeAhead()
+	struct FrameState {
+		int curFrame;
+		int curFrameDelay;
+		uint32 nextFrameStartTime;
+		bool endOfTrack;
+	};
+
+	struct AheadFrame {
+		Graphics::Surface *surface;
+		bool hasSurface;     ///< Did the track return a frame?
+		bool dirtyPalette;
+		byte palette[256 * 3];
+		FrameState state;    ///< The state of the track after decoding the frame
+	};
+
+	VideoTrack *_aheadTrack;
+	uint _aheadMax;
+	Common::Array<AheadFrame> _aheadFrames; ///< Ring buffer with the frame on screen and the ones decoded ahead
+	uint _aheadFirst;
+	uint _aheadCount;
+	FrameState _aheadState;                 ///< The state reported for _aheadTrack while frames are buffered
+	byte _aheadPalette[256 * 3];
+
+	bool isDecodedAhead(const Track *track) const { return _aheadCount != 0 && track == _aheadTrack; }
+	int getTrackCurFrame(const VideoTrack *track) const;
+	uint32 getTrackNextFrameStartTime(const VideoTrack *track) const;
+	bool endOfTrackIntern(const Track *track) const;
+	const Graphics::Surface *popDecodedAhead();
+	bool discardDecodedAhead();
+	void freeDecodedAhead();
+
 protected:
 	// Internal helper functions
 	void stopAudio();